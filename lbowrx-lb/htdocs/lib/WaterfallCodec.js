@@ -0,0 +1,90 @@
+// decoder for the "delta" waterfall compression (csdr FftDeltaEncoder)
+// every line consists of a 14 byte header followed by a Rice coded bitstream. the bitstream is organized in blocks of
+// 32 bins, each block is either predicted from the previous line or from the previous bin.
+function WaterfallDeltaCodec() {
+    this.reset();
+}
+
+WaterfallDeltaCodec.headerSize = 14;
+WaterfallDeltaCodec.blockSize = 32;
+WaterfallDeltaCodec.riceEscape = 15;
+
+WaterfallDeltaCodec.prototype.reset = function() {
+    this.previous = false;
+    this.pending = new Uint8Array(0);
+};
+
+// returns an array of decoded lines (Float32Array, in dB). lines may span multiple messages, and a message may
+// contain multiple lines. decoding only starts at a keyframe.
+WaterfallDeltaCodec.prototype.decode = function(data) {
+    var input = data;
+    if (this.pending.length) {
+        input = new Uint8Array(this.pending.length + data.length);
+        input.set(this.pending);
+        input.set(data, this.pending.length);
+    }
+    var view = new DataView(input.buffer, input.byteOffset, input.byteLength);
+    var lines = [];
+    var offset = 0;
+    while (offset + WaterfallDeltaCodec.headerSize <= input.length) {
+        var payloadLength = view.getUint32(offset + 10, true);
+        var end = offset + WaterfallDeltaCodec.headerSize + payloadLength;
+        if (end > input.length) break;
+        var line = this.decodeLine(view, input, offset);
+        if (line) lines.push(line);
+        offset = end;
+    }
+    this.pending = input.slice(offset);
+    return lines;
+};
+
+WaterfallDeltaCodec.prototype.decodeLine = function(view, input, offset) {
+    var keyframe = view.getUint8(offset) & 1;
+    var floor = view.getInt16(offset + 2, true);
+    var range = view.getUint16(offset + 4, true);
+    var bins = view.getUint32(offset + 6, true);
+
+    if (!keyframe && (!this.previous || this.previous.length !== bins)) {
+        // cannot decode without a reference line, wait for the next keyframe
+        this.previous = false;
+        return false;
+    }
+
+    var start = offset + WaterfallDeltaCodec.headerSize;
+    var pos = start * 8;
+    var readBit = function() {
+        var bit = (input[pos >> 3] >> (7 - (pos & 7))) & 1;
+        pos++;
+        return bit;
+    };
+    var readBits = function(count) {
+        var value = 0;
+        for (var i = 0; i < count; i++) value = (value << 1) | readBit();
+        return value;
+    };
+
+    var current = new Uint8Array(bins);
+    var previous = this.previous;
+    var last = 0;
+    for (var block = 0; block < bins; block += WaterfallDeltaCodec.blockSize) {
+        var temporal = readBit();
+        var k = readBits(3);
+        var blockEnd = Math.min(bins, block + WaterfallDeltaCodec.blockSize);
+        for (var i = block; i < blockEnd; i++) {
+            var q = 0;
+            while (q < WaterfallDeltaCodec.riceEscape && readBit()) q++;
+            var value = q < WaterfallDeltaCodec.riceEscape ? (q << k) | readBits(k) : readBits(8);
+            // zigzag: 0, 1, 2, 3, 4... -> 0, -1, 1, -2, 2...
+            var residual = (value & 1) ? -((value + 1) >> 1) : value >> 1;
+            var prediction = temporal ? previous[i] : last;
+            current[i] = (prediction + residual) & 0xFF;
+            last = current[i];
+        }
+    }
+    this.previous = current;
+
+    var output = new Float32Array(bins);
+    var scale = range / 255;
+    for (var j = 0; j < bins; j++) output[j] = floor + current[j] * scale;
+    return output;
+};
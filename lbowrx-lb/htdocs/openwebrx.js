@@ -29,7 +29,13 @@ var bandwidth;
 var center_freq;
 var fft_size;
 var fft_compression = "none";
+// number of resolution levels the server provides (fft_size, fft_size / 2, ...) and the one we are receiving.
+// -1 after a configuration change, so the next selection is always sent
+var fft_pyramid_levels = 1;
+var fft_level = 0;
 var fft_codec;
+var fft_delta_codec;
+var secondary_fft_delta_codec;
 var waterfall_setup_done = 0;
 var secondary_fft_size;
 
@@ -743,6 +749,8 @@ async function on_ws_recv(evt) {
                             center_freq = config['center_freq'];
                         if ('fft_size' in config) {
                             fft_size = config['fft_size'];
+                            // the level depends on the fft size, so it has to be selected again
+                            fft_level = -1;
                             waterfall_clear();
                         }
                         if ('audio_compression' in config) {
@@ -752,12 +760,19 @@ async function on_ws_recv(evt) {
                         }
                         if ('fft_compression' in config) {
                             fft_compression = config['fft_compression'];
-                            divlog("FFT stream is " + ((fft_compression === "adpcm") ? "compressed" : "uncompressed") + ".");
+                            fft_delta_codec.reset();
+                            secondary_fft_delta_codec.reset();
+                            divlog("FFT stream is " + ((fft_compression !== "none") ? "compressed" : "uncompressed") + ".");
+                        }
+                        if ('fft_pyramid_levels' in config) {
+                            fft_pyramid_levels = config['fft_pyramid_levels'];
+                            fft_level = -1;
                         }
                         if ('max_clients' in config)
                             $('#openwebrx-bar-clients').progressbar().setMaxClients(config['max_clients']);
 
                         waterfall_init();
+                        fft_select_level();
 
                         var demodulatorPanel = $('#openwebrx-panel-receiver').demodulatorPanel();
                         demodulatorPanel.setCenterFrequency(center_freq);
@@ -878,6 +893,10 @@ async function on_ws_recv(evt) {
                     waterfall_f32 = new Float32Array(waterfall_i16.length - COMPRESS_FFT_PAD_N);
                     for (i = 0; i < waterfall_i16.length; i++) waterfall_f32[i] = waterfall_i16[i + COMPRESS_FFT_PAD_N] / 100;
                     waterfall_add(waterfall_f32);
+                } else if (fft_compression === "delta") {
+                    fft_delta_codec.decode(new Uint8Array(data)).forEach(function(line) {
+                        waterfall_add(line);
+                    });
                 }
                 break;
             case 2:
@@ -895,6 +914,10 @@ async function on_ws_recv(evt) {
                     waterfall_f32 = new Float32Array(waterfall_i16.length - COMPRESS_FFT_PAD_N);
                     for (i = 0; i < waterfall_i16.length; i++) waterfall_f32[i] = waterfall_i16[i + COMPRESS_FFT_PAD_N] / 100;
                     secondary_demod_waterfall_add(waterfall_f32);
+                } else if (fft_compression === "delta") {
+                    secondary_fft_delta_codec.decode(new Uint8Array(data)).forEach(function(line) {
+                        secondary_demod_waterfall_add(line);
+                    });
                 }
                 break;
             case 4:
@@ -1075,9 +1098,9 @@ var canvas_default_height = 200;
 var canvas_container;
 var canvas_actual_line = -1;
 
-function add_canvas() {
+function add_canvas(width) {
     var new_canvas = document.createElement("canvas");
-    new_canvas.width = fft_size;
+    new_canvas.width = width;
     new_canvas.height = canvas_default_height;
     canvas_actual_line = canvas_default_height;
     new_canvas.openwebrx_top = -canvas_default_height;
@@ -1121,6 +1144,23 @@ function resize_canvases(zoom) {
         width: waterfallWidth() * zoom_levels[zoom_level] + 'px',
         left: zoom_offset_px + "px"
     });
+    fft_select_level();
+}
+
+function fft_select_level() {
+    // pick the lowest resolution that still has at least one bin per (physical) pixel at the current zoom
+    if (!ws || ws.readyState !== WebSocket.OPEN) return;
+    var width = waterfallWidth() * zoom_levels[zoom_level] * (window.devicePixelRatio || 1);
+    var level = 0;
+    while (level + 1 < fft_pyramid_levels && (fft_size >> (level + 1)) >= width) level++;
+    if (level === fft_level) return;
+    fft_level = level;
+    ws.send(JSON.stringify({
+        "type": "fftlevel",
+        "params": {
+            "level": level
+        }
+    }));
 }
 
 function waterfall_init() {
@@ -1133,7 +1173,9 @@ function waterfall_init() {
 
 function waterfall_add(data) {
     if (!waterfall_setup_done) return;
-    var w = fft_size;
+    // the width depends on the resolution level we are receiving
+    var w = data.length;
+    if (canvases.length && canvases[canvases.length - 1].width !== w) waterfall_clear();
 
     if (waterfall_measure_minmax_now) {
         var levels = waterfall_measure_minmax_do(data);
@@ -1148,7 +1190,7 @@ function waterfall_add(data) {
     }
 
     // create new canvas if the current one is full (or there isn't one)
-    if (canvas_actual_line <= 0) add_canvas();
+    if (canvas_actual_line <= 0) add_canvas(w);
 
     //Add line to waterfall image
     var oneline_image = canvas_context.createImageData(w, 1);
@@ -1233,6 +1275,8 @@ function openwebrx_init() {
     show_available_profiles();
 
     fft_codec = new ImaAdpcmCodec();
+    fft_delta_codec = new WaterfallDeltaCodec();
+    secondary_fft_delta_codec = new WaterfallDeltaCodec();
     initProgressBars();
     
     open_websocket();
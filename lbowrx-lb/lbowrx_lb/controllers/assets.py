@@ -132,6 +132,7 @@ class CompiledAssetsControllerLibs(GzipMixin, ModificationAwareController):
             "lib/BookmarkBar.js",
             "lib/BookmarkDialog.js",
             "lib/AudioEngine.js",
+            "lib/WaterfallCodec.js",
             "lib/ProgressBar.js",
             "lib/Measurement.js",
             "lib/FrequencyDisplay.js",
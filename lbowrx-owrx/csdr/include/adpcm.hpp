@@ -96,6 +96,7 @@ namespace Csdr {
             short decodeSample(unsigned char deltaCode);
             // for FFT use only
             unsigned char encodeSample(float input);
+            void encodeFft(float* input, unsigned char* output, size_t fftSize);
             void reset();
             int16_t getIndex();
             int16_t getPredictor();
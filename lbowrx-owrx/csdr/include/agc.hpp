@@ -27,6 +27,10 @@ This file is part of libcsdr.
 #include "ringbuffer.hpp"
 #include "writer.hpp"
 
+// the envelope is calculated for blocks of AGC_BLOCK samples. as long as the signal stays below the reference, the gain
+// is only updated once per block and interpolated in between.
+#define AGC_BLOCK 16
+
 namespace Csdr {
 
     class UntypedAgc {
@@ -52,10 +56,7 @@ namespace Csdr {
             void setInitialGain(float initial_gain) override;
             void setHangTime(unsigned long int hang_time) override;
         private:
-            float abs(T in);
-            bool isZero(T in);
-            T scale(T in);
-
+            void updateFilterSteps();
             // params
             // fast profile defaults
             float reference = 0.8;
@@ -70,6 +71,10 @@ namespace Csdr {
             unsigned long int hang_counter = 0;
             float xk = 0;
             float vk = 0;
+            // powers of the alpha beta filter step for 0 .. AGC_BLOCK steps, without and with decay, calculated for
+            // filter_steps_decay
+            float filter_steps[2][AGC_BLOCK + 1][4];
+            float filter_steps_decay = -1;
     };
 
 }
\ No newline at end of file
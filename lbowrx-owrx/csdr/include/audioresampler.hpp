@@ -20,21 +20,53 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "module.hpp"
+#include "tapcache.hpp"
 
-#include <samplerate.h>
+#include <memory>
+
+// upper limit for the number of filter phases. ratios that would need more are approximated.
+#define AUDIO_RESAMPLER_MAX_PHASES 1024
 
 namespace Csdr {
 
+    enum ResamplerQuality {
+        // 70 dB stopband attenuation, 80% of the band passed
+        RESAMPLER_LOW,
+        // 97 dB stopband attenuation, 90% of the band passed (like libsamplerate's SRC_SINC_MEDIUM_QUALITY)
+        RESAMPLER_MEDIUM,
+        // 120 dB stopband attenuation, 95% of the band passed
+        RESAMPLER_HIGH,
+    };
+
+    // polyphase filter bank (kaiser windowed sinc) for one ratio and quality.
+    // the taps are shared between all resamplers with the same parameters through the TapCache.
+    class ResamplerTable {
+        public:
+            ResamplerTable(unsigned int interpolation, unsigned int decimation, ResamplerQuality quality);
+            // taps for an output sample (phase / interpolation) behind input sample (getLength() / 2 - 1)
+            const float* getTaps(unsigned int phase) const;
+            unsigned int getLength() const;
+        private:
+            unsigned int length;
+            std::shared_ptr<Taps<float>> taps;
+    };
+
+    // rational resampler: interpolation by L, filtering and decimation by M in one step, so every output sample costs
+    // one pass over the taps of a single filter phase.
     class AudioResampler: public Module<float, float> {
         public:
-            AudioResampler(unsigned int inputRate, unsigned int outputRate);
-            explicit AudioResampler(double rate);
-            ~AudioResampler() override;
+            AudioResampler(unsigned int inputRate, unsigned int outputRate, ResamplerQuality quality = RESAMPLER_MEDIUM);
+            explicit AudioResampler(double rate, ResamplerQuality quality = RESAMPLER_MEDIUM);
             bool canProcess() override;
             void process() override;
         private:
-            double rate;
-            SRC_STATE* srcState;
+            void setRatio(double rate);
+            ResamplerQuality quality;
+            unsigned int interpolation;
+            unsigned int decimation;
+            std::shared_ptr<ResamplerTable> table;
+            // fractional position of the next output sample, in units of 1 / interpolation
+            unsigned int phase = 0;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "complex.hpp"
+#include "writer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace Csdr {
+
+    // passes data while open. when closed, it produces some zeros to flush any subsequent modules (like Squelch does),
+    // and drops the data after that.
+    // placed in front of a chain, a closed gate suspends all modules behind it, since they don't receive any data. the
+    // flush then needs to be scaled by the decimation of the chain to reach the end of it.
+    class SquelchGate: public Module<complex<float>, complex<float>> {
+        public:
+            SquelchGate();
+            // number of zero samples produced when the gate closes
+            explicit SquelchGate(size_t flush);
+            bool canProcess() override;
+            void process() override;
+            void setOpen(bool open);
+            void setFlush(size_t flush);
+        private:
+            std::atomic<bool> open{true};
+            std::atomic<size_t> flush;
+            size_t flushRemaining = 0;
+    };
+
+    // channel power measurement from the spectrum FFT.
+    // instead of every user chain running a Power module on its own channel, the FFT modules hand every frame to the
+    // tap, which integrates the bins of all registered bands. readings are averaged and written to the band's writer
+    // every reportInterval seconds. a band can also drive a SquelchGate, which is evaluated on every frame. like Squelch,
+    // the gate opens when a frame reaches the squelch level, and closes when the power has been below
+    // level / hysteresis for longer than the hold time.
+    class BandPowerTap {
+        public:
+            explicit BandPowerTap(float reportInterval);
+            // band edges are relative to the sample rate of the FFT input (-0.5 .. 0.5). returns the band id.
+            unsigned int addBand(float lowCut, float highCut);
+            void setBand(unsigned int id, float lowCut, float highCut);
+            void removeBand(unsigned int id);
+            void setWriter(unsigned int id, Writer<float>* writer);
+            // squelch level is linear power, 0 keeps the gate open. hysteresis is the ratio between the opening and the
+            // closing level (linear power, >= 1), the hold time is in seconds.
+            void setSquelch(unsigned int id, float level, SquelchGate* gate, float hysteresis = 1.0f, float holdTime = 0.0f);
+            // spectrum is in FFT order (not swapped). normalization is fftSize times the sum of the squared window
+            // coefficients, this makes the readings comparable to Power on the filtered channel.
+            void measure(complex<float>* spectrum, unsigned int fftSize, float normalization);
+        private:
+            struct Band {
+                float lowCut;
+                float highCut;
+                Writer<float>* writer = nullptr;
+                float squelchLevel = 0.0f;
+                float hysteresis = 1.0f;
+                float holdTime = 0.0f;
+                SquelchGate* gate = nullptr;
+                bool open = false;
+                float holdRemaining = 0.0f;
+                std::chrono::steady_clock::time_point lastFrame;
+                double accumulator = 0.0;
+                unsigned int frames = 0;
+                std::chrono::steady_clock::time_point lastReport;
+            };
+            float reportInterval;
+            unsigned int nextId = 0;
+            std::mutex bandMutex;
+            std::map<unsigned int, Band> bands;
+    };
+
+}
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cstddef>
 #include <ctime>
+#include <string>
 
 #include "module.hpp"
 
@@ -42,9 +43,32 @@ namespace Csdr {
         public:
             void run();
             template <typename T, typename U>
-            void runModule(Module<T, U>* module);
+            void runModule(const std::string& name, Module<T, U>* module);
             template <typename T>
             T* getTestData();
+            void runDecibel();
+            void runConverters();
+            template <typename T, typename U>
+            void runConverter(const std::string& name, bool isComplex);
+            void runFftThreads();
+            void runFftDelta();
+            void runPolyphaseFft();
+            void runBandPowerTap();
+            void runOccupancyIndex();
+            void runFmDemod();
+            void runNfmDeemphasis();
+            void runIir();
+            void runSquelch();
+            void runTimingRecovery();
+            void runPskDecoders();
+            void runCarrierRecovery();
+            void runGoertzelBank();
+            void runAudioResampler();
+            void runTransportFormats();
+            void runIdleListeners();
+            void runTapCache();
+            template <typename T>
+            double runTransportFormat(const std::string& name, complex<float>* input, complex<float>* reference, size_t referenceLength, double frequency, double referenceSnr, double referenceTime);
             double timeTaken(struct ::timespec start, struct ::timespec end);
     };
 
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "complex.hpp"
+
+namespace Csdr {
+
+    // carrier recovery with a second order (proportional + integral) loop. the output is the input, mixed down by the
+    // NCO, so that a locked carrier ends up at 0 Hz and 0 phase.
+    // the loop is updated once per block of samples. within a block the NCO frequency is constant, so its samples
+    // are calculated independently of each other (vectorized). the block length is chosen from the bandwidth, so that
+    // the loop stays well below the update rate; for wide loops it is updated on every sample.
+    class CarrierRecovery: public AnyLengthModule<complex<float>, complex<float>> {
+        public:
+            // bandwidth: natural frequency of the loop, relative to the sample rate
+            // damping: damping factor, 0.707 for a critically damped loop
+            CarrierRecovery(float bandwidth, float damping);
+            void setLoopParameters(float bandwidth, float damping);
+            // current frequency offset of the NCO, relative to the sample rate
+            float getFrequency();
+            // phase of the NCO, in radians
+            float getPhase();
+            void process(complex<float>* input, complex<float>* output, size_t size) override;
+            // longest block the loop is kept constant for
+            static constexpr unsigned int MAX_BLOCK_LENGTH = 64;
+        protected:
+            // sum of the phase errors (in radians, for small errors) of the mixed down samples
+            virtual float getErrorSum(complex<float>* output, size_t size) = 0;
+        private:
+            unsigned int blockLength = 1;
+            // loop gains for one block
+            float alpha = 0.0f;
+            float beta = 0.0f;
+            // NCO state, in radians and radians per sample
+            float phase = 0.0f;
+            float frequency = 0.0f;
+            unsigned int blockFill = 0;
+            float errorSum = 0.0f;
+    };
+
+    // locks to an unmodulated carrier
+    class Pll: public CarrierRecovery {
+        public:
+            explicit Pll(float bandwidth = 0.01f, float damping = 0.707f);
+        protected:
+            float getErrorSum(complex<float>* output, size_t size) override;
+    };
+
+    enum CostasMode {
+        COSTAS_BPSK,
+        COSTAS_QPSK,
+    };
+
+    // locks to a suppressed carrier. the phase is ambiguous (by 180 degrees for BPSK, 90 degrees for QPSK).
+    class CostasLoop: public CarrierRecovery {
+        public:
+            explicit CostasLoop(CostasMode mode = COSTAS_BPSK, float bandwidth = 0.01f, float damping = 0.707f);
+        protected:
+            float getErrorSum(complex<float>* output, size_t size) override;
+        private:
+            CostasMode mode;
+    };
+
+}
@@ -20,13 +20,98 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "module.hpp"
+#include "half.hpp"
+
+#include <climits>
 
 namespace Csdr {
 
+    // conversion of a single sample (or a component of a complex sample), with the semantics described below.
+    // modules that accept reduced precision input use these to convert inside of their processing loops.
+    template <typename T, typename U>
+    inline U convertSample(T input);
+
+    // converts between unsigned char, short and float, or between their complex forms (including complex<half>).
+    // integer samples represent [-1, 1]: short is scaled by SHRT_MAX, unsigned char is offset binary around 127.5
+    // (the format of rtl_sdr). conversions to integer formats truncate and saturate at the limits of the type.
+    // half has the same scale as float.
     template <typename T, typename U>
     class Converter: public AnyLengthModule<T, U> {
         public:
             void process(T* input, U* output, size_t length) override;
+            // the same conversion without a module around it, e.g. for device drivers
+            static void convert(const T* input, U* output, size_t length);
     };
 
-}
\ No newline at end of file
+    // clamping before the (truncating) cast keeps the loops free of branches, so they can be vectorized
+    inline float convertClamp(float value, float min, float max) {
+        return value < min ? min : (value > max ? max : value);
+    }
+
+    template <>
+    inline float convertSample(float input) {
+        return input;
+    }
+
+    template <>
+    inline float convertSample(unsigned char input) {
+        return (float) input / (UCHAR_MAX / 2.0f) - 1.0f;
+    }
+
+    template <>
+    inline float convertSample(short input) {
+        return (float) input / SHRT_MAX;
+    }
+
+    template <>
+    inline float convertSample(half input) {
+        return input;
+    }
+
+    template <>
+    inline unsigned char convertSample(float input) {
+        return (int) convertClamp(input * UCHAR_MAX * 0.5f + 128.0f, 0.0f, UCHAR_MAX);
+    }
+
+    template <>
+    inline short convertSample(float input) {
+        return (int) convertClamp(input * SHRT_MAX, SHRT_MIN, SHRT_MAX);
+    }
+
+    template <>
+    inline half convertSample(float input) {
+        return input;
+    }
+
+    template <>
+    inline unsigned char convertSample(short input) {
+        // same as the rtl_tcp compatible output of the connectors
+        return (int) convertClamp((float) input / SHRT_MAX * 128.0f + 127.4f, 0.0f, UCHAR_MAX);
+    }
+
+    template <>
+    inline short convertSample(unsigned char input) {
+        return (int) (convertSample<unsigned char, float>(input) * SHRT_MAX);
+    }
+
+    template <>
+    inline unsigned char convertSample(half input) {
+        return convertSample<float, unsigned char>(input);
+    }
+
+    template <>
+    inline short convertSample(half input) {
+        return convertSample<float, short>(input);
+    }
+
+    template <>
+    inline half convertSample(unsigned char input) {
+        return convertSample<unsigned char, float>(input);
+    }
+
+    template <>
+    inline half convertSample(short input) {
+        return convertSample<short, float>(input);
+    }
+
+}
@@ -36,11 +36,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Csdr {
 
+    // decides on the sign of the real part of the product with the conjugate of the previous symbol, no atan2 needed.
     class DBPskDecoder: public AnyLengthModule<complex<float>, unsigned char> {
         protected:
             void process(complex<float>* input, unsigned char* output, size_t size) override;
         private:
-            float last_phase = 0.0f;
+            complex<float> last = complex<float>(1.0f, 0.0f);
     };
 
 }
\ No newline at end of file
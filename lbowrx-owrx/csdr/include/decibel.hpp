@@ -0,0 +1,36 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "complex.hpp"
+
+#include <cstddef>
+
+namespace Csdr {
+
+    // fast conversion of power values to dB: output[i] = 10 * log10(input[i]) + offset
+    // uses a polynomial approximation of log2() instead of libm; the approximation error is below 0.0001 dB,
+    // float rounding keeps the total error well below 0.001 dB for any normal, positive input.
+    // an input of 0 results in approximately -382 dB instead of -inf.
+    void powerToDb(const float* input, float* output, size_t size, float offset = 0.0f);
+    // same as above, operating on std::norm(input[i])
+    void complexToDb(const complex<float>* input, float* output, size_t size, float offset = 0.0f);
+
+}
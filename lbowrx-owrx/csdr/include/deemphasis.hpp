@@ -32,8 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "module.hpp"
-#include "fir.hpp"
-#include "filter.hpp"
+#include "iir.hpp"
 
 namespace Csdr {
 
@@ -45,14 +44,30 @@ namespace Csdr {
         private:
             float dt;
             float alpha;
-            float last_output = 0.0f;
+            FirstOrderIir iir;
     };
 
-    class NfmDeephasis: public FilterModule<float> {
+    // narrow FM deemphasis: a 300 Hz highpass (removes subaudible tones), a pole at 1200 Hz for the deemphasis itself
+    // and a lowpass at 3100 Hz. this follows the envelope the predefined FIR filters were designed for (see
+    // predefined.h), but as a cascade of bilinear-transformed second-order sections, so it works at any sample rate.
+    // the gain is 0 dB at 500 Hz.
+    class NfmDeephasis: public AnyLengthModule<float, float> {
         public:
             explicit NfmDeephasis(unsigned int sampleRate);
+            // gain of the filter as designed (not measured) at the given frequency in Hz
+            double getGain(double frequency);
+            void process(float* input, float* output, size_t size) override;
         private:
-            static FirFilter<float, float>* getFilter(unsigned int sampleRate);
+            struct Section {
+                float b0, b1, b2, a1, a2;
+                float z1 = 0.0f, z2 = 0.0f;
+            };
+            // analog prototype (n0 + n1 * s + n2 * s^2) / (d0 + d1 * s + d2 * s^2), s normalized to the corner frequency.
+            // the response is exact at the prewarp frequency.
+            Section bilinear(double frequency, double prewarp, double n0, double n1, double n2, double d0, double d1, double d2);
+            static constexpr unsigned int SECTIONS = 6;
+            unsigned int sampleRate;
+            Section sections[SECTIONS];
     };
 
 }
\ No newline at end of file
@@ -22,23 +22,40 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 #include "module.hpp"
 #include "complex.hpp"
 #include "window.hpp"
+#include "bandpowertap.hpp"
 
 #include <fftw3.h>
 
 namespace Csdr {
 
-    class Fft: public Module<complex<float>, complex<float>> {
+    class UntypedFft {
         public:
-            Fft(unsigned int fftSize, unsigned int everyNSamples, Window* window = nullptr);
+            virtual ~UntypedFft() = default;
+            virtual void setEveryNSamples(unsigned int everyNSamples) = 0;
+            // number of threads FFTW may use per transform (see FftPlanner)
+            virtual void setThreads(unsigned int threads) = 0;
+            // every frame is also handed to the tap for channel power measurement
+            virtual void setPowerTap(BandPowerTap* powerTap) = 0;
+    };
+
+    // T is the input format. besides complex<float>, the reduced precision formats complex<short> and complex<half> are
+    // accepted, they are converted to float while the window is applied.
+    template <typename T>
+    class Fft: public UntypedFft, public Module<T, complex<float>> {
+        public:
+            Fft(unsigned int fftSize, unsigned int everyNSamples, Window* window = nullptr, unsigned int threads = 1);
             ~Fft() override;
             bool canProcess() override;
             void process() override;
-            void setEveryNSamples(unsigned int everyNSamples);
+            void setEveryNSamples(unsigned int everyNSamples) override;
+            void setThreads(unsigned int threads) override;
+            void setPowerTap(BandPowerTap* powerTap) override;
         private:
             unsigned int fftSize;
             unsigned int everyNSamples;
             unsigned int skipped = 0;
             PrecalculatedWindow* window;
+            BandPowerTap* powerTap = nullptr;
             fftwf_plan plan;
             complex<float>* windowed;
             complex<float>* output_buffer;
@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// line header: flags (1 byte), reserved (1 byte), floor in dB (int16), range in dB (uint16), number of bins (uint32),
+// payload length in bytes (uint32); all little endian
+#define FFT_DELTA_HEADER_SIZE 14
+#define FFT_DELTA_FLAG_KEYFRAME 0x01
+// bins per entropy coding block
+#define FFT_DELTA_BLOCK_SIZE 32
+
+namespace Csdr {
+
+    // compact waterfall line codec:
+    // - dB values are quantized to 8 bits between floor and floor + range
+    // - every block of bins is predicted either from the previous line (temporal) or from the previous bin (spatial),
+    //   whichever is cheaper
+    // - the residuals are Rice coded with one parameter per block
+    // keyframes only use spatial prediction, so clients can start decoding at any keyframe.
+    class FftDeltaCodec {
+        public:
+            FftDeltaCodec(unsigned int fftSize, int floor, unsigned int range, unsigned int keyframeInterval);
+            ~FftDeltaCodec();
+            // returns the number of bytes written
+            size_t encode(const float* input, unsigned char* output);
+            void reset();
+            static size_t maxEncodedSize(unsigned int fftSize);
+        private:
+            void quantize(const float* input, unsigned char* output);
+            void residuals(bool keyframe);
+            unsigned int fftSize;
+            int floor;
+            unsigned int range;
+            unsigned int keyframeInterval;
+            unsigned int sinceKeyframe = 0;
+            unsigned char* current;
+            unsigned char* previous;
+            // zigzag mapped prediction residuals of the current line
+            unsigned char* spatial;
+            unsigned char* temporal;
+            bool hasPrevious = false;
+    };
+
+    class FftDeltaEncoder: public Module<float, unsigned char> {
+        public:
+            FftDeltaEncoder(unsigned int fftSize, int floor, unsigned int range, unsigned int keyframeInterval);
+            explicit FftDeltaEncoder(unsigned int fftSize);
+            bool canProcess() override;
+            void process() override;
+        private:
+            unsigned int fftSize;
+            FftDeltaCodec codec;
+    };
+
+}
@@ -34,6 +34,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "filter.hpp"
 #include "complex.hpp"
 #include "window.hpp"
+#include "tapcache.hpp"
 
 #include <fftw3.h>
 
@@ -50,7 +51,10 @@ namespace Csdr {
             explicit FftFilter(size_t fftSize);
             static size_t filterLength(float transition);
             static size_t getFftSize(size_t taps_length);
-            complex<float>* taps;
+            void setTaps(std::shared_ptr<Taps<complex<float>>> taps, size_t taps_length);
+            // shared with all filters that use the same taps, see TapCache
+            std::shared_ptr<Taps<complex<float>>> table;
+            const complex<float>* taps;
             size_t taps_length;
             size_t fftSize;
             size_t inputSize;
@@ -64,9 +68,19 @@ namespace Csdr {
             T* overlap;
     };
 
+    class MinimumLengthTapGenerator;
+    class BandPassTapGenerator;
+
     class FftBandPassFilter: public FftFilter<complex<float>> {
         public:
             FftBandPassFilter(float lowcut, float highcut, float transition, Window* window);
+            FftBandPassFilter(float lowcut, float highcut, MinimumLengthTapGenerator* design);
+        private:
+            explicit FftBandPassFilter(std::shared_ptr<BandPassTapGenerator> generator);
+            FftBandPassFilter(std::shared_ptr<BandPassTapGenerator> generator, std::shared_ptr<Taps<complex<float>>> taps);
+            // the time domain taps of a design. they are not used for filtering, but as long as they are in the cache,
+            // the next filter with the same design doesn't need to run the design again to know its length.
+            std::shared_ptr<Taps<complex<float>>> designTaps;
     };
 
 }
\ No newline at end of file
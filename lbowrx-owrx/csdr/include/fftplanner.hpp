@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "complex.hpp"
+
+#include <fftw3.h>
+#include <mutex>
+
+namespace Csdr {
+
+    // central place for creating and destroying FFTW plans. the FFTW planner is not thread safe, and the number of
+    // threads for new plans is a global setting, so every plan in libcsdr++ is created and destroyed through here.
+    // single threaded spectrum plans use FFTW_ESTIMATE, as before. multithreaded plans are measured; FFTW keeps the
+    // result as wisdom, so only the first plan of a given size and thread count pays for the measurement.
+    // planning with FFTW_MEASURE overwrites the buffers, so they must not be in use at the same time.
+    class FftPlanner {
+        public:
+            // forward transform for the spectrum modules
+            static fftwf_plan planDft(unsigned int size, complex<float>* input, complex<float>* output, unsigned int threads);
+            // single threaded plans for everything else (filters, tap transforms)
+            static fftwf_plan planDft(unsigned int size, fftwf_complex* input, fftwf_complex* output, int sign, unsigned int flags);
+            static fftwf_plan planDftR2c(unsigned int size, float* input, fftwf_complex* output, unsigned int flags);
+            static void destroy(fftwf_plan plan);
+            // false if libcsdr++ was built without fftw3f_threads; multithreaded requests fall back to 1 thread
+            static bool hasThreads();
+        private:
+            static std::mutex plannerMutex;
+    };
+
+}
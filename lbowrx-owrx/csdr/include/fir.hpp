@@ -36,6 +36,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "module.hpp"
 #include "filter.hpp"
 #include "fftfilter.hpp"
+#include "tapcache.hpp"
+
+#include <memory>
+#include <string>
 
 namespace Csdr {
 
@@ -43,15 +47,17 @@ namespace Csdr {
     class FirFilter: public SampleFilter<T> {
         public:
             FirFilter(U* taps, size_t length);
-            ~FirFilter();
+            explicit FirFilter(std::shared_ptr<Taps<U>> taps);
             T processSample(T* data, size_t index) override;
             T processSample_fmv(T* data, size_t index);
             size_t getOverhead() override;
+            // for modules that run the filter in their own loops
+            const U* getTaps() { return taps; }
         protected:
-            explicit FirFilter(size_t length);
             static size_t filterLength(float transition);
-            void allocateTaps(size_t length);
-            U* taps;
+            // shared with all filters that use the same taps, see TapCache
+            std::shared_ptr<Taps<U>> table;
+            const U* taps;
             size_t taps_length;
     };
 
@@ -59,8 +65,17 @@ namespace Csdr {
     class TapGenerator {
         public:
             TapGenerator(Window* window);
+            virtual ~TapGenerator() = default;
             virtual T* generateTaps(size_t length) = 0;
             complex<float>* generateFftTaps(size_t length, size_t fftSize);
+            // cached versions of generateTaps() and generateFftTaps(). with a length of 0, the generator picks the
+            // length itself (see getLength()).
+            std::shared_ptr<Taps<T>> getTaps(size_t length);
+            std::shared_ptr<Taps<complex<float>>> getFftTaps(size_t length, size_t fftSize);
+            // describes the generator and all of its parameters for the cache
+            virtual std::string getKey() = 0;
+            // the length the generator would choose itself, 0 if there is none
+            virtual size_t getLength() { return 0; }
         protected:
             void normalize(T* taps, size_t length);
             Window* window;
@@ -70,28 +85,90 @@ namespace Csdr {
         public:
             LowPassTapGenerator(float cutoff, Window* window);
             float* generateTaps(size_t length) override;
+            std::string getKey() override;
         private:
             float cutoff;
     };
 
+    // lowpass designs that find the minimum number of taps for a specification instead of using 4 / transition.
+    // the band edges are at cutoff -/+ transition / 2, ripple is the peak to peak passband ripple and attenuation the
+    // minimum stopband attenuation, both in dB.
+    class MinimumLengthTapGenerator: public TapGenerator<float> {
+        public:
+            MinimumLengthTapGenerator(float cutoff, float transition, float ripple, float attenuation);
+            // the shortest (odd) length whose response meets the specification
+            size_t getLength() override;
+            // the same specification around a different cutoff (the lowpass prototype of a bandpass)
+            virtual MinimumLengthTapGenerator* withCutoff(float cutoff) = 0;
+            // measures passband ripple and stopband attenuation of a lowpass with the given band edges
+            static void measure(float* taps, size_t length, float cutoff, float transition, float* ripple, float* attenuation);
+        protected:
+            // starting point for the search in getLength()
+            virtual size_t estimateLength() = 0;
+            // allowed deviation in the passband and the stopband (linear)
+            double getPassbandDeviation();
+            double getStopbandDeviation();
+            float cutoff;
+            float transition;
+            float ripple;
+            float attenuation;
+        private:
+            bool meetsSpecification(size_t length);
+            size_t length = 0;
+    };
+
+    // windowed sinc with a kaiser window. beta and length follow from the specification (Kaiser's formulas).
+    class KaiserTapGenerator: public MinimumLengthTapGenerator {
+        public:
+            KaiserTapGenerator(float cutoff, float transition, float ripple, float attenuation);
+            ~KaiserTapGenerator() override;
+            float* generateTaps(size_t length) override;
+            std::string getKey() override;
+            MinimumLengthTapGenerator* withCutoff(float cutoff) override;
+        protected:
+            size_t estimateLength() override;
+    };
+
+    // equiripple (Parks-McClellan / Remez exchange) design. for the same specification this usually needs
+    // the fewest taps of all generators.
+    class RemezTapGenerator: public MinimumLengthTapGenerator {
+        public:
+            RemezTapGenerator(float cutoff, float transition, float ripple, float attenuation);
+            float* generateTaps(size_t length) override;
+            std::string getKey() override;
+            MinimumLengthTapGenerator* withCutoff(float cutoff) override;
+        protected:
+            size_t estimateLength() override;
+    };
+
     template <typename T>
     class LowPassFilter: public FirFilter<T, float> {
         public:
             LowPassFilter(float cutoff, float transition, Window* window);
+            explicit LowPassFilter(MinimumLengthTapGenerator* generator);
     };
 
     class BandPassTapGenerator: public TapGenerator<complex<float>> {
         public:
             BandPassTapGenerator(float lowcut, float highcut, Window* window);
+            // the lowpass prototype is designed with the specification of design, but around (highcut - lowcut) / 2
+            BandPassTapGenerator(float lowcut, float highcut, MinimumLengthTapGenerator* design);
+            ~BandPassTapGenerator() override;
             complex<float>* generateTaps(size_t length) override;
+            std::string getKey() override;
+            // minimum length of the prototype. only available when constructed from a design.
+            size_t getLength() override;
         private:
             float lowcut;
             float highcut;
+            TapGenerator<float>* prototype;
+            MinimumLengthTapGenerator* design = nullptr;
     };
 
     template <typename T>
     class BandPassFilter: public FirFilter<T, complex<float>> {
         public:
             BandPassFilter(float lowcut, float highcut, float transition, Window* window);
+            BandPassFilter(float lowcut, float highcut, MinimumLengthTapGenerator* design);
     };
 }
\ No newline at end of file
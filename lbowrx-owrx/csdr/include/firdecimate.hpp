@@ -26,10 +26,15 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 
 namespace Csdr {
 
-    class FirDecimate: public Module<complex<float>, complex<float>> {
+    // T is the input format. besides complex<float>, the reduced precision formats complex<short> and complex<half> are
+    // accepted, they are converted to float inside of the filter loop (see convertSample()).
+    template <typename T>
+    class FirDecimate: public Module<T, complex<float>> {
         public:
             FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window, float cutoff);
             FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window);
+            // the lowpass is taken from the design as is, so its cutoff has to be relative to the input rate already
+            FirDecimate(unsigned int decimation, MinimumLengthTapGenerator* design);
             ~FirDecimate() override;
             bool canProcess() override;
             void process() override;
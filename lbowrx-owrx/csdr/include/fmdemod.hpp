@@ -38,18 +38,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Csdr {
 
+    // polar discriminator: the phase difference between consecutive samples, arg(x[n] * conj(x[n - 1])), scaled by
+    // fmdemod_quadri_K. the angle is computed in a single pass with a polynomial atan approximation (error below
+    // 1e-5 rad, see fastAtan2() in fmdemod.cpp).
     class FmDemod: public AnyLengthModule<complex<float>, float> {
         public:
-            FmDemod();
-            ~FmDemod() override;
             void process(complex<float>* input, float* output, size_t work_size) override;
-        protected:
-            size_t maxLength() override { return buffer_size; }
         private:
             complex<float> last_sample = {0, 0};
-            size_t buffer_size = 1024;
-            float* temp_dq;
-            float* temp_di;
     };
 
 }
\ No newline at end of file
@@ -33,26 +33,36 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "module.hpp"
 #include "complex.hpp"
-#include "fir.hpp"
+#include "window.hpp"
+#include "tapcache.hpp"
+
+// number of precalculated kernel phases per input sample. coefficients between two phases are interpolated linearly.
+#define FRACTIONAL_DECIMATOR_PHASES 64
 
 namespace Csdr {
 
+    // polyphase resampler for arbitrary (non-integer) decimation rates.
+    // the interpolation kernel is precalculated for FRACTIONAL_DECIMATOR_PHASES fractional positions, so every output
+    // sample costs one pass over the kernel taps.
+    // without a transition bandwidth, the kernel is a lagrange interpolator of num_poly_points taps (the input must
+    // already be band limited, e.g. by FirDecimate). with a transition bandwidth, the kernel is a windowed sinc that
+    // doubles as the anti-aliasing filter and cuts off at the output nyquist frequency.
     template <typename T>
     class FractionalDecimator: public Module<T, T> {
         public:
-            FractionalDecimator(float rate, unsigned int num_poly_points, FirFilter<T, float>* filter = nullptr);
-            ~FractionalDecimator();
+            FractionalDecimator(float rate, unsigned int num_poly_points = 12, float transition = 0.0f, Window* window = nullptr);
             bool canProcess() override;
             void process() override;
         private:
-            float where;
-            unsigned int num_poly_points; //number of samples that the Lagrange interpolator will use
-            float* poly_precalc_denomiator; //while we don't precalculate coefficients here as in a Farrow structure, because it is a fractional interpolator, but we rather precaculate part of the interpolator expression
-            float* coeffs_buf;
-            int xifirst;
-            int xilast;
-            float rate;
-            FirFilter<T, float>* filter;
+            double rate;
+            // position of the next output sample, relative to the first tap
+            double where;
+            // number of kernel taps
+            unsigned int length;
+            // kernel taps for every phase, followed by the difference to the next phase. shared through the TapCache.
+            std::shared_ptr<Taps<float>> table;
+            const float* taps;
+            const float* deltas;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+
+#include <vector>
+
+namespace Csdr {
+
+    // power at a set of frequencies (relative to the sample rate, they don't have to be on an FFT bin), calculated
+    // with the goertzel algorithm over consecutive blocks of blockLength samples. every block results in one frame
+    // with one value per frequency, in the order given. the output is scaled to the mean power of a sine: a sine of
+    // amplitude 1 at one of the frequencies results in 0.5.
+    class GoertzelBank: public Module<float, float> {
+        public:
+            GoertzelBank(const std::vector<float>& frequencies, unsigned int blockLength);
+            bool canProcess() override;
+            void process() override;
+            size_t getFrameSize();
+            // number of segments every block is split into. the recursion of a single frequency can't be vectorized,
+            // but the segments can be processed in parallel, and their results are combined afterwards.
+            static constexpr unsigned int SEGMENTS = 8;
+            // number of frequencies processed together, to have enough independent recursions in flight
+            static constexpr unsigned int TONE_GROUP = 4;
+        private:
+            unsigned int blockLength;
+            unsigned int segmentLength;
+            std::vector<float> transposed;
+            size_t tones;
+            std::vector<float> coefficients;
+            // 2x2 matrix per frequency that carries a state through one segment
+            std::vector<float> propagation;
+            std::vector<float> s1;
+            std::vector<float> s2;
+    };
+
+}
@@ -0,0 +1,45 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace Csdr {
+
+    // first order recursion y[n] = b * x[n] + a * y[n - 1].
+    // evaluated as y[n] = a^L * y[n - L] + sum(b * a^j * x[n - j]) for j < L (look-ahead): the sum is a short FIR
+    // filter, and the recursion only depends on outputs L samples back, so both run across the SIMD lanes instead of
+    // one sample at a time. the results match the direct recursion within float rounding.
+    class FirstOrderIir {
+        public:
+            FirstOrderIir(float b, float a);
+            // input and output must not overlap
+            void process(const float* input, float* output, size_t size);
+            void reset();
+            static constexpr unsigned int LOOKAHEAD = 8;
+        private:
+            float taps[LOOKAHEAD];
+            float feedback;
+            // the last LOOKAHEAD inputs and outputs, oldest first
+            float inputs[LOOKAHEAD] = {0};
+            float outputs[LOOKAHEAD] = {0};
+    };
+
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#define OCCUPANCY_INDEX_SLOTS 4
+
+namespace Csdr {
+
+    // a contiguous run of bins above the detection threshold. bins are in display order (after FftExchangeSides).
+    struct OccupancyCarrier {
+        unsigned int start;
+        // exclusive
+        unsigned int end;
+        unsigned int peak;
+        float level;
+    };
+
+    struct OccupancySnapshot {
+        uint64_t sequence = 0;
+        float noiseFloor = 0.0f;
+        // exponentially averaged power per bin (dB)
+        std::vector<float> spectrum;
+        std::vector<OccupancyCarrier> carriers;
+    };
+
+    // keeps track of which parts of the spectrum carry signal. it consumes waterfall lines (dB, sides exchanged) and
+    // passes them on unchanged, or is fed directly by the WaterfallEngine.
+    // results are published as snapshots that can be read from any thread without locking: readers acquire() the
+    // current snapshot, which is then never modified until release()d. the writer fills one of the free slots and
+    // switches over; if all slots are held by readers, the line is dropped.
+    class OccupancyIndex: public Module<float, float> {
+        public:
+            // averaging is the weight of a new line in the exponential average, threshold is the detection level in
+            // dB above the noise floor
+            OccupancyIndex(unsigned int fftSize, float averaging, float threshold);
+            explicit OccupancyIndex(unsigned int fftSize);
+            bool canProcess() override;
+            void process() override;
+            unsigned int getFftSize();
+            void setAveraging(float averaging);
+            void setThreshold(float threshold);
+            // line must hold fftSize bins
+            void update(const float* line);
+            // snapshots are only valid between acquire() and release(). acquire() returns nullptr before the first line
+            // has been processed.
+            const OccupancySnapshot* acquire();
+            void release(const OccupancySnapshot* snapshot);
+        private:
+            struct Slot {
+                OccupancySnapshot snapshot;
+                std::atomic<int> readers{0};
+            };
+            void updateLine(const float* line);
+            float estimateNoiseFloor(const float* spectrum);
+            void detectCarriers(OccupancySnapshot& snapshot);
+            unsigned int fftSize;
+            std::atomic<float> averaging;
+            std::atomic<float> threshold;
+            Slot slots[OCCUPANCY_INDEX_SLOTS];
+            std::vector<unsigned int> histogram;
+            // index of the published slot, -1 while there is none
+            std::atomic<int> current{-1};
+            uint64_t sequence = 0;
+    };
+
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "complex.hpp"
+#include "window.hpp"
+#include "bandpowertap.hpp"
+
+#include <fftw3.h>
+
+namespace Csdr {
+
+    // weighted overlap-add front end of a polyphase filter bank spectrum estimator.
+    // instead of windowing fftSize samples, fftSize * taps samples are weighted with a windowed sinc prototype (one bin
+    // wide) and folded down to fftSize samples before the FFT. this gives the sidelobe rejection and flat bins of a
+    // much longer transform, at the cost of fftSize * taps multiply-adds per frame.
+    class PolyphaseWindow {
+        public:
+            PolyphaseWindow(unsigned int fftSize, unsigned int taps, Window* window);
+            // number of input samples per frame
+            unsigned int getLength();
+            void apply(complex<float>* input, complex<float>* output);
+            // sum of the squared prototype coefficients
+            float getPower();
+        private:
+            unsigned int fftSize;
+            unsigned int taps;
+            // prototype filter, every coefficient stored twice so it can be applied to interleaved I/Q samples.
+            // shared with all windows of the same size, see TapCache
+            std::shared_ptr<Taps<float>> table;
+            const float* coefficients;
+            float power = 0.0f;
+    };
+
+    class PolyphaseFft: public Module<complex<float>, complex<float>> {
+        public:
+            PolyphaseFft(unsigned int fftSize, unsigned int taps, unsigned int everyNSamples, Window* window, unsigned int threads = 1);
+            ~PolyphaseFft() override;
+            bool canProcess() override;
+            void process() override;
+            void setEveryNSamples(unsigned int everyNSamples);
+            // number of threads FFTW may use per transform (see FftPlanner)
+            void setThreads(unsigned int threads);
+            // every frame is also handed to the tap for channel power measurement
+            void setPowerTap(BandPowerTap* powerTap);
+        private:
+            unsigned int fftSize;
+            unsigned int everyNSamples;
+            unsigned int skipped = 0;
+            PolyphaseWindow* window;
+            BandPowerTap* powerTap = nullptr;
+            fftwf_plan plan;
+            complex<float>* folded;
+            complex<float>* output_buffer;
+    };
+
+}
@@ -20,33 +20,53 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <functional>
+#include <atomic>
 #include "module.hpp"
 #include "complex.hpp"
 
 namespace Csdr {
 
+    // measures the average power in blocks of getLength() samples and passes the data on.
+    // all available blocks are processed at once. readings are averaged over the report interval, the callback is only
+    // called once per interval.
     class Power: public Module<complex<float>, complex<float>> {
         public:
+            // with decimation > 1, only every n-th sample is measured
             Power(unsigned int decimation, std::function<void(float)> callback);
             size_t getLength();
             bool canProcess() override;
             void process() override;
+            // number of blocks per reading
+            void setReportInterval(unsigned int reportInterval);
         protected:
             // to bo overridden by the squelch implementation
             virtual void forwardData(complex<float>* input, float power);
         private:
             unsigned int decimation;
             std::function<void(float)> callback;
+            std::atomic<unsigned int> reportInterval{1};
+            unsigned int reportBlocks = 0;
+            float reportAccumulator = 0.0f;
     };
 
+    // opens when the power of a block reaches the squelch level, and closes when it has been below
+    // squelchLevel / hysteresis for longer than the hold time.
     class Squelch: public Power {
         public:
             Squelch(unsigned int decimation, std::function<void(float)> callback): Power(decimation, callback) {}
             void setSquelch(float squelchLevel);
+            // ratio between the opening and the closing level (linear power, >= 1)
+            void setHysteresis(float hysteresis);
+            // number of blocks
+            void setHoldTime(unsigned int holdTime);
         protected:
             void forwardData(complex<float>* input, float power) override;
         private:
             float squelchLevel = 0.0f;
+            float hysteresis = 1.0f;
+            unsigned int holdTime = 0;
+            bool open = false;
+            unsigned int holdRemaining = 0;
             unsigned char flushCounter = 0;
     };
 
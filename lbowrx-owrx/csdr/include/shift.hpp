@@ -44,13 +44,16 @@ namespace Csdr {
             float rate;
     };
 
-    class ShiftAddfast: public Shift, public FixedLengthModule<complex<float>, complex<float>> {
+    // T is the input format. besides complex<float>, the reduced precision formats complex<short> and complex<half> are
+    // accepted, they are converted to float while processing (see convertSample()).
+    template <typename T>
+    class ShiftAddfast: public Shift, public FixedLengthModule<T, complex<float>> {
         public:
             explicit ShiftAddfast(float rate);
             void setRate(float rate) override;
         protected:
-            void process(complex<float>* input, complex<float>* output) override;
-            void process_fmv(complex<float>* input, complex<float>* output, size_t size);
+            void process(T* input, complex<float>* output) override;
+            void process_fmv(T* input, complex<float>* output, size_t size);
             size_t getLength() override { return 1024; }
         private:
             float starting_phase = 0.0;
@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Csdr {
+
+    // immutable array of filter taps or window coefficients, see TapCache
+    template <typename T>
+    class Taps {
+        public:
+            // takes ownership of data, which must be allocated with malloc()
+            Taps(T* data, size_t length): data(data), length(length) {}
+            ~Taps() { free(data); }
+            const T* getData() const { return data; }
+            size_t getLength() const { return length; }
+        private:
+            T* data;
+            size_t length;
+    };
+
+    // process wide cache of tap arrays. filters and windows hold on to their taps with a shared_ptr, so identical
+    // filters (e.g. the selectors of all clients on the same profile) share one array, and the array is released when
+    // the last of them is gone. the key has to describe the contents completely, including the type of the taps.
+    class TapCache {
+        public:
+            template <typename T>
+            static std::shared_ptr<Taps<T>> get(const std::string& key, std::function<Taps<T>*()> generate);
+            // number of arrays that are currently in use, and their size in bytes
+            static size_t getEntries();
+            static size_t getMemoryUsage();
+        private:
+            static std::shared_ptr<void> lookup(const std::string& key);
+            static std::shared_ptr<void> insert(const std::string& key, std::shared_ptr<void> entry, size_t bytes);
+    };
+
+    template <typename T>
+    std::shared_ptr<Taps<T>> TapCache::get(const std::string& key, std::function<Taps<T>*()> generate) {
+        auto cached = std::static_pointer_cast<Taps<T>>(lookup(key));
+        if (cached != nullptr) return cached;
+        // generated outside of the lock, designs can take a while. if another thread was faster, its entry is used.
+        std::shared_ptr<Taps<T>> taps(generate());
+        return std::static_pointer_cast<Taps<T>>(insert(key, taps, sizeof(T) * taps->getLength()));
+    }
+
+}
@@ -36,28 +36,38 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Csdr {
 
+    // produces one sample per symbol, at the symbol center. all symbols available in the input are produced per call.
+    // symbol positions are tracked with sub-sample precision and the samples are interpolated (cubic), so the number
+    // of samples per symbol doesn't have to be an integer.
     class TimingRecovery: public Module<complex<float>, complex<float>> {
         public:
-            explicit TimingRecovery(unsigned int decimation, float loop_gain = 0.5f, float max_error = 2.0f, bool use_q = false);
+            explicit TimingRecovery(float decimation, float loop_gain = 0.5f, float max_error = 2.0f, bool use_q = false);
             void process() override;
             bool canProcess() override;
         protected:
-            virtual float getError() = 0;
+            // calculates the error for the symbol window at input and stores the symbol to be produced
+            virtual float getError(complex<float>* input, complex<float>& symbol) = 0;
             virtual int getErrorSign() = 0;
-            float calculateError(int el_point_right_index, int el_point_left_index, int el_point_mid_index);
-            unsigned int decimation;
-            int correction_offset = 0;
+            float calculateError(const complex<float>& right, const complex<float>& left, const complex<float>& mid);
+            // input at a (fractional) position relative to the start of the symbol window
+            complex<float> interpolate(complex<float>* input, float position);
+            float decimation;
+            float correction_offset = 0.0f;
         private:
+            // number of input samples one symbol window needs
+            size_t getWindowLength();
             float loop_gain;
             float max_error;
             bool use_q;
+            // fractional part of the symbol window start
+            float fraction = 0.0f;
     };
 
     class GardnerTimingRecovery: public TimingRecovery {
         public:
             using TimingRecovery::TimingRecovery;
         protected:
-            float getError() override;
+            float getError(complex<float>* input, complex<float>& symbol) override;
             int getErrorSign() override { return -1; }
     };
 
@@ -65,10 +75,10 @@ namespace Csdr {
         public:
             using TimingRecovery::TimingRecovery;
         protected:
-            float getError() override;
+            float getError(complex<float>* input, complex<float>& symbol) override;
             int getErrorSign() override { return 1; }
         private:
             float earlylate_ratio = 0.25f;
     };
 
-}
\ No newline at end of file
+}
@@ -41,12 +41,16 @@ namespace Csdr {
     };
 
 
+    // a character is a code between two (or more) 0 bits. codes are collected bit by bit and looked up directly by
+    // their value (all codes start with a 1, so the value is unique across lengths). all available bits are processed
+    // per call.
     class VaricodeDecoder: public Module<unsigned char, unsigned char> {
         public:
             bool canProcess() override;
             void process() override;
         private:
-            unsigned long long status = 0;
+            // longest code in the table
+            static constexpr unsigned int MAX_BITS = 10;
             static constexpr varicode_item varicode_items[] = {
                 { .code = 0b1010101011, .bitcount=10,   .ascii=0x00 }, //NUL, null
                 { .code = 0b1011011011, .bitcount=10,   .ascii=0x01 }, //SOH, start of heading
@@ -177,6 +181,12 @@ namespace Csdr {
                 { .code = 0b1011010111, .bitcount=10,   .ascii=0x7e }, //~
                 { .code = 0b1110110101, .bitcount=10,   .ascii=0x7f }, //DEL
             };
+            // ascii by code, -1 for codes not in the table
+            static const short* getLookupTable();
+            // bits of the current code. codes longer than MAX_BITS are kept at 1 << MAX_BITS (never valid).
+            unsigned int code = 0;
+            // number of consecutive 0 bits, the initial state is as if there had been a pause
+            unsigned int zeros = 2;
     };
 
 }
\ No newline at end of file
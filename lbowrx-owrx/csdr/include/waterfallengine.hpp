@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "complex.hpp"
+#include "window.hpp"
+#include "adpcm.hpp"
+#include "polyphasefft.hpp"
+#include "occupancyindex.hpp"
+
+#include <fftw3.h>
+
+namespace Csdr {
+
+    // how bins are merged when building the lower resolution levels of the waterfall pyramid
+    enum PyramidMode {
+        // keep the strongest bin, so narrow carriers remain visible
+        PYRAMID_MAX,
+        // average the power of the merged bins
+        PYRAMID_MEAN,
+    };
+
+    class UntypedWaterfallEngine {
+        public:
+            virtual ~UntypedWaterfallEngine() = default;
+            virtual void setEveryNSamples(unsigned int everyNSamples) = 0;
+            // 0 disables averaging (equivalent to LogPower)
+            virtual void setAvgNumber(unsigned int avgNumber) = 0;
+            // number of threads FFTW may use per transform (see FftPlanner)
+            virtual void setThreads(unsigned int threads) = 0;
+            // every frame is also handed to the tap for channel power measurement
+            virtual void setPowerTap(BandPowerTap* powerTap) = 0;
+            // every line (at full resolution) is also handed to the index
+            virtual void setOccupancyIndex(OccupancyIndex* occupancyIndex) = 0;
+    };
+
+    // fused implementation of the Fft -> LogAveragePower -> FftExchangeSides -> FftAdpcmEncoder chain.
+    // output is identical to the chain, but it runs in a single module without any intermediate buffers.
+    // T selects the output: float for plain dB values, unsigned char for ADPCM compressed lines.
+    // with levels > 1, every line is followed by levels - 1 lines of half the resolution each (N, N/2, N/4, ...),
+    // decimated in the power domain from the same FFT. each level is compressed separately.
+    // with taps > 1, the window is replaced by a polyphase (WOLA) front end, see PolyphaseWindow.
+    template <typename T>
+    class WaterfallEngine: public UntypedWaterfallEngine, public Module<complex<float>, T> {
+        public:
+            WaterfallEngine(unsigned int fftSize, unsigned int everyNSamples, unsigned int avgNumber, float add_db, Window* window);
+            WaterfallEngine(unsigned int fftSize, unsigned int everyNSamples, unsigned int avgNumber, float add_db, Window* window, unsigned int levels, PyramidMode pyramidMode, unsigned int taps = 1);
+            ~WaterfallEngine() override;
+            bool canProcess() override;
+            void process() override;
+            void setEveryNSamples(unsigned int everyNSamples) override;
+            void setAvgNumber(unsigned int avgNumber) override;
+            void setThreads(unsigned int threads) override;
+            void setPowerTap(BandPowerTap* powerTap) override;
+            void setOccupancyIndex(OccupancyIndex* occupancyIndex) override;
+        private:
+            void collect(complex<float>* input);
+            void decimate(float* input, float* output, unsigned int size);
+            void emit(T* output);
+            size_t emitLevel(float* level, unsigned int size, float correction, T* output);
+            // location of the dB values of a level after emitLevel()
+            float* getLevelDb(float* level, T* output);
+            size_t getLevelSize(unsigned int size);
+            size_t getOutputSize();
+            unsigned int getInputLength();
+            unsigned int fftSize;
+            unsigned int everyNSamples;
+            unsigned int avgNumber;
+            float add_db;
+            unsigned int levels;
+            PyramidMode pyramidMode;
+            unsigned int skipped = 0;
+            unsigned int collected = 0;
+            PrecalculatedWindow* window;
+            PolyphaseWindow* polyphase = nullptr;
+            BandPowerTap* powerTap = nullptr;
+            OccupancyIndex* occupancyIndex = nullptr;
+            fftwf_plan plan;
+            complex<float>* windowed;
+            complex<float>* spectrum;
+            // power values, already in the order the client expects them (sides exchanged)
+            float* collector;
+            // power values of the lower resolution levels, one after another
+            float* pyramid = nullptr;
+            AdpcmCodec codec;
+    };
+
+}
@@ -31,19 +31,27 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "tapcache.hpp"
+
 #include <cstdlib>
+#include <string>
 
 namespace Csdr {
 
     class PrecalculatedWindow {
         public:
-            PrecalculatedWindow(float* windowt, size_t size);
-            ~PrecalculatedWindow();
-            template <typename T>
-            void apply(T* input, T* output, size_t size);
+            explicit PrecalculatedWindow(std::shared_ptr<Taps<float>> windowt);
+            // T and U are the same format, or T is one of complex<short> and complex<half> and U is complex<float>
+            template <typename T, typename U>
+            void apply(T* input, U* output, size_t size);
+            // sum of the squared coefficients
+            float getPower();
         private:
-            float* windowt;
+            // shared with all other windows of the same type and size, see TapCache
+            std::shared_ptr<Taps<float>> table;
+            const float* windowt;
             size_t size;
+            float power = 0.0f;
     };
 
     class Window {
@@ -52,7 +60,11 @@ namespace Csdr {
             template <typename T>
             void apply(T* input, T* output, size_t size);
             PrecalculatedWindow* precalculate(size_t size);
+            // rate is the position in the window. the filter designs pass [-1, 1], apply() and precalculate() pass
+            // [1, 3], so kernels repeat every 2: the center is at 0 and 2, the edges at -1, 1 and 3.
             virtual float kernel(float rate) = 0;
+            // identifies the window (type and parameters) in cache keys
+            virtual std::string getKey();
     };
 
     class BoxcarWindow: public Window {
@@ -70,4 +82,18 @@ namespace Csdr {
             float kernel(float rate) override;
     };
 
+    class KaiserWindow: public Window {
+        public:
+            // beta trades main lobe width for sidelobe level. see beta() for the value that reaches a given attenuation.
+            explicit KaiserWindow(float beta);
+            float kernel(float rate) override;
+            std::string getKey() override;
+            // beta for a lowpass filter with the given stopband attenuation (in dB)
+            static float beta(float attenuation);
+        private:
+            static double bessel(double x);
+            float b;
+            double norm;
+    };
+
 }
\ No newline at end of file
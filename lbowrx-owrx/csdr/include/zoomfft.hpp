@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "complex.hpp"
+#include "window.hpp"
+#include "fir.hpp"
+
+#include <fftw3.h>
+
+namespace Csdr {
+
+    // high resolution spectrum of a sub-band: shift -> decimate -> FFT in a single module.
+    // center is the normalized offset of the sub-band (-0.5 to 0.5, like Shift), the span is 1 / decimation of the
+    // input bandwidth. output frames are fftSize bins, exactly like Fft, so they can be fed into the usual
+    // power / swap / compression modules.
+    // the band pass is only evaluated for the decimated samples, and the frequency shift is done after decimation.
+    class ZoomFft: public Module<complex<float>, complex<float>> {
+        public:
+            ZoomFft(float center, unsigned int decimation, unsigned int fftSize, unsigned int everyNSamples, Window* window);
+            ~ZoomFft() override;
+            bool canProcess() override;
+            void process() override;
+            void setCenter(float center);
+            // counted in decimated samples
+            void setEveryNSamples(unsigned int everyNSamples);
+        private:
+            void updateFilter();
+            size_t collect(complex<float>* input, size_t samples);
+            float center;
+            unsigned int decimation;
+            unsigned int fftSize;
+            unsigned int everyNSamples;
+            BandPassFilter<complex<float>>* bandpass = nullptr;
+            double phase = 0.0;
+            // decimated samples waiting for the next FFT
+            complex<float>* decimated;
+            unsigned int filled = 0;
+            // decimated samples to drop before collecting again (when everyNSamples > fftSize)
+            unsigned int toSkip = 0;
+            PrecalculatedWindow* window;
+            fftwf_plan plan;
+            complex<float>* windowed;
+            complex<float>* output_buffer;
+    };
+
+}
@@ -40,6 +40,12 @@ along with csdr++.  If not, see <https://www.gnu.org/licenses/>.
 #include "dbpsk.hpp"
 #include "varicode.hpp"
 #include "timingrecovery.hpp"
+#include "carrierrecovery.hpp"
+#include "goertzel.hpp"
+#include "waterfallengine.hpp"
+#include "zoomfft.hpp"
+#include "fftdelta.hpp"
+#include "polyphasefft.hpp"
 
 #include <iostream>
 #include <cerrno>
@@ -205,25 +211,61 @@ DcBlockCommand::DcBlockCommand(): Command("dcblock", "DC block") {
 }
 
 ConvertCommand::ConvertCommand(): Command("convert", "Convert between stream formats") {
-    add_set("-i,--informat", inFormat, {"s16", "float"}, "Input data format", true);
-    add_set("-o,--outformat", outFormat, {"s16", "float"}, "Output data format", true);
+    add_set("-i,--informat", inFormat, {"u8", "s16", "float", "complex_u8", "complex_s16", "complex"}, "Input data format", true);
+    add_set("-o,--outformat", outFormat, {"u8", "s16", "float", "complex_u8", "complex_s16", "complex"}, "Output data format", true);
     callback( [this] () {
         if (inFormat == outFormat) {
             std::cerr << "input and output format are identical, cannot convert\n";
             return;
         }
-        if (inFormat == "s16") {
-            if (outFormat == "float") {
+        if (inFormat == "u8") {
+            if (outFormat == "s16") {
+                runModule(new Converter<unsigned char, short>());
+            } else if (outFormat == "float") {
+                runModule(new Converter<unsigned char, float>());
+            } else {
+                std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
+            }
+        } else if (inFormat == "s16") {
+            if (outFormat == "u8") {
+                runModule(new Converter<short, unsigned char>());
+            } else if (outFormat == "float") {
                 runModule(new Converter<short, float>());
             } else {
                 std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
             }
         } else if (inFormat == "float") {
-            if (outFormat == "s16") {
+            if (outFormat == "u8") {
+                runModule(new Converter<float, unsigned char>());
+            } else if (outFormat == "s16") {
                 runModule(new Converter<float, short>());
             } else {
                 std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
             }
+        } else if (inFormat == "complex_u8") {
+            if (outFormat == "complex_s16") {
+                runModule(new Converter<complex<unsigned char>, complex<short>>());
+            } else if (outFormat == "complex") {
+                runModule(new Converter<complex<unsigned char>, complex<float>>());
+            } else {
+                std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
+            }
+        } else if (inFormat == "complex_s16") {
+            if (outFormat == "complex_u8") {
+                runModule(new Converter<complex<short>, complex<unsigned char>>());
+            } else if (outFormat == "complex") {
+                runModule(new Converter<complex<short>, complex<float>>());
+            } else {
+                std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
+            }
+        } else if (inFormat == "complex") {
+            if (outFormat == "complex_u8") {
+                runModule(new Converter<complex<float>, complex<unsigned char>>());
+            } else if (outFormat == "complex_s16") {
+                runModule(new Converter<complex<float>, complex<short>>());
+            } else {
+                std::cerr << "unable to handle output format \"" << outFormat << "\"\n";
+            }
         } else {
             std::cerr << "unable to handle input format \"" << inFormat << "\"\n";
         }
@@ -234,6 +276,8 @@ FftCommand::FftCommand(): Command("fft", "Fast Fourier transformation") {
     add_option("fft_size", fftSize, "FFT size")->required();
     add_option("every_n_samples", everyNSamples, "Run FFT every N samples")->required();
     add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function", true);
+    add_option("-t,--threads", threads, "Number of threads per FFT (requires fftw3f_threads)", true);
+    add_option("-k,--taps", taps, "Polyphase (WOLA) taps per bin, 1 for a plain windowed FFT", true);
     callback( [this] () {
         if (!isPowerOf2(fftSize)) {
             std::cerr << "FFT size must be power of 2\n";
@@ -251,7 +295,11 @@ FftCommand::FftCommand(): Command("fft", "Fast Fourier transformation") {
             return;
         }
 
-        runModule(new Fft(fftSize, everyNSamples, w));
+        if (taps > 1) {
+            runModule(new PolyphaseFft(fftSize, taps, everyNSamples, w, threads));
+        } else {
+            runModule(new Fft<complex<float>>(fftSize, everyNSamples, w, threads));
+        }
     });
 }
 
@@ -263,6 +311,61 @@ bool FftCommand::isPowerOf2(unsigned int size) {
     return bitcount == 1;
 }
 
+ZoomFftCommand::ZoomFftCommand(): Command("zoomfft", "High resolution FFT of a sub-band (shift, decimate and FFT)") {
+    add_option("center", center, "Center of the sub-band (relative to the sample rate, -0.5 to 0.5)")->required();
+    add_option("decimation", decimation, "Decimation factor (span is sample rate / decimation)")->required();
+    add_option("fft_size", fftSize, "FFT size")->required();
+    add_option("every_n_samples", everyNSamples, "Run FFT every N decimated samples")->required();
+    add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function", true);
+    callback( [this] () {
+        Window* w;
+        if (window == "boxcar") {
+            w = new BoxcarWindow();
+        } else if (window == "blackman") {
+            w = new BlackmanWindow();
+        } else if (window == "hamming") {
+            w = new HammingWindow();
+        } else {
+            std::cerr << "window type \"" << window << "\" not available\n";
+            return;
+        }
+
+        runModule(new ZoomFft(center, decimation, fftSize, everyNSamples, w));
+    });
+}
+
+WaterfallCommand::WaterfallCommand(): Command("waterfall", "Calculate waterfall lines (fused fft, logaveragepower, fftswap and fftadpcm)") {
+    add_option("fft_size", fftSize, "FFT size")->required();
+    add_option("every_n_samples", everyNSamples, "Run FFT every N samples")->required();
+    add_option("-n,--avg", avgNumber, "Number of FFTs to average (0 to disable averaging)", true);
+    add_option("-a,--add", add_db, "Offset in dB", true);
+    add_set("-c,--compression", compression, {"adpcm", "none"}, "Waterfall compression", true);
+    add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function", true);
+    add_option("-l,--levels", levels, "Number of resolution levels per line (N, N/2, N/4, ...)", true);
+    add_set("-p,--pyramid", pyramid, {"max", "mean"}, "Bin merging for lower resolution levels", true);
+    add_option("-k,--taps", taps, "Polyphase (WOLA) taps per bin, 1 for a plain windowed FFT", true);
+    callback( [this] () {
+        Window* w;
+        if (window == "boxcar") {
+            w = new BoxcarWindow();
+        } else if (window == "blackman") {
+            w = new BlackmanWindow();
+        } else if (window == "hamming") {
+            w = new HammingWindow();
+        } else {
+            std::cerr << "window type \"" << window << "\" not available\n";
+            return;
+        }
+
+        PyramidMode mode = pyramid == "mean" ? PYRAMID_MEAN : PYRAMID_MAX;
+        if (compression == "adpcm") {
+            runModule(new WaterfallEngine<unsigned char>(fftSize, everyNSamples, avgNumber, add_db, w, levels, mode, taps));
+        } else {
+            runModule(new WaterfallEngine<float>(fftSize, everyNSamples, avgNumber, add_db, w, levels, mode, taps));
+        }
+    });
+}
+
 LogPowerCommand::LogPowerCommand(): Command("logpower", "Calculate dB power") {
     add_option("add_db", add_db, "Offset in dB", true);
     callback( [this] () {
@@ -297,7 +400,7 @@ ShiftCommand::ShiftCommand(): Command("shift", "Shift a signal in the frequency
     addFifoOption();
     callback( [this] () {
         //auto shift = new ShiftMath(rate);
-        auto shift = new ShiftAddfast(rate);
+        auto shift = new ShiftAddfast<complex<float>>(rate);
         shiftModule = shift;
         runModule(shift);
     });
@@ -307,11 +410,30 @@ void ShiftCommand::processFifoData(std::string data) {
     shiftModule->setRate(std::stof(data));
 }
 
+// minimum length lowpass for the --design options. "window" (the windowed sinc) returns nullptr.
+static MinimumLengthTapGenerator* getDesign(const std::string& design, float cutoff, float transition, float ripple, float attenuation) {
+    if (design == "kaiser") {
+        return new KaiserTapGenerator(cutoff, transition, ripple, attenuation);
+    } else if (design == "remez") {
+        return new RemezTapGenerator(cutoff, transition, ripple, attenuation);
+    }
+    return nullptr;
+}
+
 FirDecimateCommand::FirDecimateCommand(): Command("firdecimate", "Decimate and filter") {
     add_option("decimation_factor", decimationFactor, "Decimation factor")->required();
     add_option("transition_bw", transitionBandwidth, "Transition bandwidth", true);
     add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function", true);
+    add_set("-d,--design", design, {"window", "kaiser", "remez"}, "Filter design (kaiser and remez use the minimum number of taps for --ripple and --attenuation)", true);
+    add_option("--ripple", ripple, "Passband ripple in dB (peak to peak)", true);
+    add_option("--attenuation", attenuation, "Stopband attenuation in dB", true);
     callback( [this] () {
+        auto d = getDesign(design, 0.5f / decimationFactor, transitionBandwidth, ripple, attenuation);
+        if (d != nullptr) {
+            runModule(new FirDecimate<complex<float>>(decimationFactor, d));
+            delete d;
+            return;
+        }
         Window* w;
         if (window == "boxcar") {
             w = new BoxcarWindow();
@@ -323,7 +445,7 @@ FirDecimateCommand::FirDecimateCommand(): Command("firdecimate", "Decimate and f
             std::cerr << "window type \"" << window << "\" not available\n";
             return;
         }
-        runModule(new FirDecimate(decimationFactor, transitionBandwidth, w));
+        runModule(new FirDecimate<complex<float>>(decimationFactor, transitionBandwidth, w));
     });
 }
 
@@ -336,10 +458,10 @@ BenchmarkCommand::BenchmarkCommand(): Command("benchmark", "Perform internal ben
 FractionalDecimatorCommand::FractionalDecimatorCommand(): Command("fractionaldecimator", "Decimate in fractions") {
     add_set("-f,--format", format, {"float", "complex"}, "Format", true);
     add_option("decimation_rate", decimation_rate, "Decimation rate")->required();
-    add_option("-n,--numpoly", num_poly_points, "Number of poly points", true);
+    add_option("-n,--numpoly", num_poly_points, "Number of interpolation taps (without prefilter)", true);
     add_option("-t,--transition", transition, "Transition bandwidth for the prefilter", true);
-    add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function for the prefilter", true);
-    add_flag("-p,--prefilter", prefilter, "Apply filtering before decimation");
+    add_set("-w,--window", window, {"boxcar", "blackman", "hamming"}, "Window function for the interpolation kernel", true);
+    add_flag("-p,--prefilter", prefilter, "Suppress aliasing above the output nyquist frequency");
     callback( [this] () {
         if (format == "float") {
             runDecimator<float>();
@@ -353,22 +475,21 @@ FractionalDecimatorCommand::FractionalDecimatorCommand(): Command("fractionaldec
 
 template <typename T>
 void FractionalDecimatorCommand::runDecimator() {
-    LowPassFilter<T>* filter = nullptr;
-    if (prefilter) {
-        Window* w;
-        if (window == "boxcar") {
-            w = new BoxcarWindow();
-        } else if (window == "blackman") {
-            w = new BlackmanWindow();
-        } else if (window == "hamming") {
-            w = new HammingWindow();
-        } else {
-            std::cerr << "window type \"" << window << "\" not available\n";
-            return;
-        }
-        filter = new LowPassFilter<T>(0.5 / (decimation_rate - transition), transition, w);
+    Window* w;
+    if (window == "boxcar") {
+        w = new BoxcarWindow();
+    } else if (window == "blackman") {
+        w = new BlackmanWindow();
+    } else if (window == "hamming") {
+        w = new HammingWindow();
+    } else {
+        std::cerr << "window type \"" << window << "\" not available\n";
+        return;
     }
-    runModule(new FractionalDecimator<T>(decimation_rate, num_poly_points, filter));
+    // the window is only used to calculate the kernel
+    auto decimator = new FractionalDecimator<T>(decimation_rate, num_poly_points, prefilter ? transition : 0.0f, w);
+    delete w;
+    runModule(decimator);
 }
 
 AdpcmCommand::AdpcmCommand(): Command("adpcm", "ADPCM codec") {
@@ -395,6 +516,16 @@ FftAdpcmCommand::FftAdpcmCommand(): Command("fftadpcm", "Specialized ADPCM for F
     });
 }
 
+FftDeltaCommand::FftDeltaCommand(): Command("fftdelta", "Compact waterfall line codec (8-bit dB, inter-frame delta, Rice coding)") {
+    add_option("fft_size", fftSize, "Number of FFT bins")->required();
+    add_option("-f,--floor", floor, "Lowest encoded level in dB", true);
+    add_option("-r,--range", range, "Encoded dynamic range in dB", true);
+    add_option("-k,--keyframe", keyframeInterval, "Lines between keyframes", true);
+    callback( [this] () {
+        runModule(new FftDeltaEncoder(fftSize, floor, range, keyframeInterval));
+    });
+}
+
 LimitCommand::LimitCommand(): Command("limit", "Limit stream values to maximum amplitude") {
     add_option("max_amplitude", maxAmplitude, "Maximum amplitude", true);
     callback( [this] () {
@@ -407,7 +538,6 @@ PowerCommand::PowerCommand(): Command("power", "Measure power") {
     add_option("decimation", decimation, "Decimate data when calcuting power", true);
     add_option("report_every", reportInterval, "Report interval", true);
     callback( [this] () {
-        unsigned int reportCounter = 0;
         FILE* outFifo = fopen(outFifoName.c_str(), "w");
         if (outFifo == nullptr) {
             std::cerr << "error opening fifo: " << strerror(errno) << "\n";
@@ -415,13 +545,12 @@ PowerCommand::PowerCommand(): Command("power", "Measure power") {
         } else {
             fcntl(fileno(outFifo), F_SETFL, O_NONBLOCK);
         }
-        runModule(new Power(decimation, [this, &reportCounter, outFifo] (float power) {
-            if (reportCounter-- <= 0) {
-                fprintf(outFifo, "%g\n", power);
-                fflush(outFifo);
-                reportCounter = reportInterval;
-            }
-        }));
+        auto power = new Power(decimation, [outFifo] (float power) {
+            fprintf(outFifo, "%g\n", power);
+            fflush(outFifo);
+        });
+        power->setReportInterval(reportInterval);
+        runModule(power);
         fclose(outFifo);
     });
 }
@@ -431,8 +560,9 @@ SquelchCommand::SquelchCommand(): Command("squelch", "Measure power and apply sq
     add_option("-o,--outfifo", outFifoName, "Control fifo")->required();
     add_option("decimation", decimation, "Decimate data when calcuting power", true);
     add_option("report_every", reportInterval, "Report interval", true);
+    add_option("--hysteresis", hysteresis, "Ratio between opening and closing level", true);
+    add_option("--hold", holdTime, "Number of blocks to stay open after the level drops", true);
     callback( [this] () {
-        unsigned int reportCounter = 0;
         FILE* outFifo = fopen(outFifoName.c_str(), "w");
         if (outFifo == nullptr) {
             std::cerr << "error opening fifo: " << strerror(errno) << "\n";
@@ -440,13 +570,13 @@ SquelchCommand::SquelchCommand(): Command("squelch", "Measure power and apply sq
         } else {
             fcntl(fileno(outFifo), F_SETFL, O_NONBLOCK);
         }
-        squelch = new Squelch(decimation, [this, &reportCounter, outFifo] (float power) {
-            if (reportCounter-- <= 0) {
-                fprintf(outFifo, "%g\n", power);
-                fflush(outFifo);
-                reportCounter = reportInterval;
-            }
+        squelch = new Squelch(decimation, [outFifo] (float power) {
+            fprintf(outFifo, "%g\n", power);
+            fflush(outFifo);
         });
+        squelch->setReportInterval(reportInterval);
+        squelch->setHysteresis(hysteresis);
+        squelch->setHoldTime(holdTime);
         runModule(squelch);
         fclose(outFifo);
     });
@@ -488,7 +618,12 @@ BandPassCommand::BandPassCommand(): Command("bandpass", "Bandpass filter") {
     add_option("transition_bw", transition, "Transition bandwidth")->required();
     add_option("-w,--window", window, "Windowing function", true);
     add_flag("-f,--fft", use_fft, "Use FFT transformation filter");
+    add_set("-d,--design", design, {"window", "kaiser", "remez"}, "Filter design (kaiser and remez use the minimum number of taps for --ripple and --attenuation)", true);
+    add_option("--ripple", ripple, "Passband ripple in dB (peak to peak)", true);
+    add_option("--attenuation", attenuation, "Stopband attenuation in dB", true);
     callback( [this] () {
+        // the cutoff of the design doesn't matter, it is replaced by the bandwidth of the filter
+        designObj = getDesign(design, 0.25f, transition, ripple, attenuation);
         if (window == "boxcar") {
             windowObj = new BoxcarWindow();
         } else if (window == "blackman") {
@@ -499,25 +634,24 @@ BandPassCommand::BandPassCommand(): Command("bandpass", "Bandpass filter") {
             std::cerr << "window type \"" << window << "\" not available\n";
             return;
         }
-        if (use_fft) {
-            auto filter = new FftBandPassFilter(lowcut, highcut, transition, windowObj);
-            module = new FilterModule<complex<float>>(filter);
-        } else {
-            auto filter = new BandPassFilter<complex<float>>(lowcut, highcut, transition, windowObj);
-            module = new FilterModule<complex<float>>(filter);
-        }
+        module = new FilterModule<complex<float>>(createFilter());
         runModule(module);
     });
 }
 
+Filter<complex<float>>* BandPassCommand::createFilter() {
+    if (designObj != nullptr) {
+        if (use_fft) return new FftBandPassFilter(lowcut, highcut, designObj);
+        return new BandPassFilter<complex<float>>(lowcut, highcut, designObj);
+    }
+    if (use_fft) return new FftBandPassFilter(lowcut, highcut, transition, windowObj);
+    return new BandPassFilter<complex<float>>(lowcut, highcut, transition, windowObj);
+}
+
 void BandPassCommand::processFifoData(std::string data) {
     std::stringstream ss(data);
     ss >> lowcut >> highcut;
-    if (use_fft) {
-        module->setFilter(new FftBandPassFilter(lowcut, highcut, transition, windowObj));
-    } else {
-        module->setFilter(new BandPassFilter<complex<float>>(lowcut, highcut, transition, windowObj));
-    }
+    module->setFilter(createFilter());
 }
 
 DBPskDecoderCommand::DBPskDecoderCommand(): Command("dbpskdecode", "Differential BPSK decoder") {
@@ -548,3 +682,28 @@ TimingRecoveryCommand::TimingRecoveryCommand(): Command("timingrecovery", "Timin
         }
     });
 }
+
+PllCommand::PllCommand(): Command("pll", "Lock to a carrier and mix it down to 0 Hz") {
+    add_option("bandwidth", bandwidth, "Loop bandwidth relative to the sample rate", true);
+    add_option("damping", damping, "Loop damping factor", true);
+    callback( [this] () {
+        runModule(new Pll(bandwidth, damping));
+    });
+}
+
+CostasLoopCommand::CostasLoopCommand(): Command("costas", "Lock to a suppressed carrier (BPSK / QPSK) and mix it down to 0 Hz") {
+    add_set("-m,--mode", mode, {"bpsk", "qpsk"}, "Modulation", true);
+    add_option("bandwidth", bandwidth, "Loop bandwidth relative to the sample rate", true);
+    add_option("damping", damping, "Loop damping factor", true);
+    callback( [this] () {
+        runModule(new CostasLoop(mode == "qpsk" ? COSTAS_QPSK : COSTAS_BPSK, bandwidth, damping));
+    });
+}
+
+GoertzelCommand::GoertzelCommand(): Command("goertzel", "Measure the power at a set of frequencies, one frame per block") {
+    add_option("block_length", blockLength, "Block length in samples")->required();
+    add_option("frequencies", frequencies, "Frequencies relative to the sample rate")->required();
+    callback( [this] () {
+        runModule(new GoertzelBank(frequencies, blockLength));
+    });
+}
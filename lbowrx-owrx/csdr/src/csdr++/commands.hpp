@@ -86,6 +86,34 @@ namespace Csdr {
             unsigned int fftSize = 0;
             unsigned int everyNSamples = 0;
             std::string window = "hamming";
+            unsigned int threads = 1;
+            unsigned int taps = 1;
+    };
+
+    class ZoomFftCommand: public Command {
+        public:
+            ZoomFftCommand();
+        private:
+            float center = 0.0;
+            unsigned int decimation = 0;
+            unsigned int fftSize = 0;
+            unsigned int everyNSamples = 0;
+            std::string window = "hamming";
+    };
+
+    class WaterfallCommand: public Command {
+        public:
+            WaterfallCommand();
+        private:
+            unsigned int fftSize = 0;
+            unsigned int everyNSamples = 0;
+            unsigned int avgNumber = 0;
+            float add_db = 0.0;
+            std::string compression = "adpcm";
+            std::string window = "hamming";
+            unsigned int levels = 1;
+            std::string pyramid = "max";
+            unsigned int taps = 1;
     };
 
     class LogPowerCommand: public Command {
@@ -135,6 +163,9 @@ namespace Csdr {
             unsigned int decimationFactor = 1;
             float transitionBandwidth = 0.05;
             std::string window = "hamming";
+            std::string design = "window";
+            float ripple = 0.1f;
+            float attenuation = 60.0f;
     };
 
     class BenchmarkCommand: public Command {
@@ -172,6 +203,16 @@ namespace Csdr {
             unsigned int fftSize = 0;
     };
 
+    class FftDeltaCommand: public Command {
+        public:
+            FftDeltaCommand();
+        private:
+            unsigned int fftSize = 0;
+            int floor = -140;
+            unsigned int range = 120;
+            unsigned int keyframeInterval = 16;
+    };
+
     class LimitCommand: public Command {
         public:
             LimitCommand();
@@ -198,6 +239,8 @@ namespace Csdr {
             std::string outFifoName;
             unsigned int decimation = 1;
             unsigned int reportInterval = 1;
+            float hysteresis = 1.0f;
+            unsigned int holdTime = 0;
     };
 
     class DeemphasisCommand: public Command {
@@ -221,12 +264,17 @@ namespace Csdr {
         protected:
             void processFifoData(std::string data) override;
         private:
+            Filter<complex<float>>* createFilter();
             float lowcut = 0.0f;
             float highcut = 0.0f;
             float transition = 0.0f;
             bool use_fft = 0;
             std::string window = "hamming";
+            std::string design = "window";
+            float ripple = 0.1f;
+            float attenuation = 60.0f;
             Window* windowObj;
+            MinimumLengthTapGenerator* designObj = nullptr;
             FilterModule<complex<float>>* module;
     };
 
@@ -244,11 +292,36 @@ namespace Csdr {
         public:
             TimingRecoveryCommand();
         private:
-            unsigned int decimation = 0;
+            float decimation = 0.0f;
             float loop_gain = 0.5f;
             float max_error = 2.0f;
             bool use_q = false;
             std::string algorithm = "gardner";
     };
 
+    class PllCommand: public Command {
+        public:
+            PllCommand();
+        private:
+            float bandwidth = 0.01f;
+            float damping = 0.707f;
+    };
+
+    class CostasLoopCommand: public Command {
+        public:
+            CostasLoopCommand();
+        private:
+            float bandwidth = 0.01f;
+            float damping = 0.707f;
+            std::string mode = "bpsk";
+    };
+
+    class GoertzelCommand: public Command {
+        public:
+            GoertzelCommand();
+        private:
+            unsigned int blockLength = 0;
+            std::vector<float> frequencies;
+    };
+
 }
\ No newline at end of file
@@ -46,6 +46,8 @@ int Cli::main(int argc, char** argv) {
     app.add_subcommand(std::shared_ptr<CLI::App>(new DcBlockCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new ConvertCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new FftCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new ZoomFftCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new WaterfallCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new LogPowerCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new LogAveragePowerCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new FftExchangeSidesCommand()));
@@ -55,6 +57,7 @@ int Cli::main(int argc, char** argv) {
     app.add_subcommand(std::shared_ptr<CLI::App>(new FractionalDecimatorCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new AdpcmCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new FftAdpcmCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new FftDeltaCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new LimitCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new PowerCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new SquelchCommand()));
@@ -64,6 +67,9 @@ int Cli::main(int argc, char** argv) {
     app.add_subcommand(std::shared_ptr<CLI::App>(new DBPskDecoderCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new VaricodeDecoderCommand()));
     app.add_subcommand(std::shared_ptr<CLI::App>(new TimingRecoveryCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new PllCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new CostasLoopCommand()));
+    app.add_subcommand(std::shared_ptr<CLI::App>(new GoertzelCommand()));
 
     app.add_subcommand(std::shared_ptr<CLI::App>(new BenchmarkCommand()));
 
@@ -170,6 +170,22 @@ unsigned char AdpcmCodec::encodeSample(float input) {
     return encodeSample((short) (input * 100));
 }
 
+void AdpcmCodec::encodeFft(float* input, unsigned char* output, size_t fftSize) {
+    // FFT always starts with the codec default values
+    reset();
+    for (int i = 0; i < COMPRESS_FFT_PAD_N / 2; i++) {
+        output[i] =
+                encodeSample(input[0]) |
+                encodeSample(input[0]) << 4;
+    }
+    output += (COMPRESS_FFT_PAD_N / 2);
+    for (size_t i = 0; i < fftSize / 2; i++) {
+        output[i] =
+                encodeSample(input[i * 2]) |
+                encodeSample(input[i * 2 + 1]) << 4;
+    }
+}
+
 void AdpcmCodec::reset() {
     previousValue = 0;
     index = 0;
@@ -247,22 +263,7 @@ bool FftAdpcmEncoder::canProcess() {
 
 void FftAdpcmEncoder::process() {
     std::lock_guard<std::mutex> lock(processMutex);
-    float* input = reader->getReadPointer();
-    unsigned char* output = writer->getWritePointer();
-    // FFT always starts with the codec default values
-    codec->reset();
-    for (int i = 0; i < COMPRESS_FFT_PAD_N / 2; i++) {
-        output[i] =
-                // the cast only serves to help the compiler decide which function to call
-                codec->encodeSample(input[0]) |
-                codec->encodeSample(input[0]) << 4;
-    }
-    output += (COMPRESS_FFT_PAD_N / 2);
-    for (size_t i = 0; i < fftSize / 2; i++) {
-        output[i] =
-                codec->encodeSample(input[i * 2]) |
-                codec->encodeSample(input[i * 2 + 1]) << 4;
-    }
+    codec->encodeFft(reader->getReadPointer(), writer->getWritePointer(), fftSize);
     reader->advance(fftSize);
     writer->advance((COMPRESS_FFT_PAD_N + fftSize) / 2);
 }
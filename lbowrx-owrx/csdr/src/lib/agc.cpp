@@ -30,127 +30,188 @@ This file is part of libcsdr.
 
 using namespace Csdr;
 
-template <typename T>
-void Agc<T>::process(T* input, T* output, size_t work_size) {
-	float input_abs;
-	float error, dgain;
+static inline float agcAbs(short in) {
+    return std::fabs((float) in) / SHRT_MAX;
+}
 
-	float xk, vk, rk;
-	float dt = 0.5;
-	float beta = 0.005;
+static inline float agcAbs(float in) {
+    return std::fabs(in);
+}
 
-    for (int i = 0; i < work_size; i++) {
-        //We skip samples containing 0, as the gain would be infinity for those to keep up with the reference.
-        if (!isZero(input[i])) {
-            //The error is the difference between the required gain at the actual sample, and the previous gain value.
-            //We actually use an envelope detector.
-            input_abs = this->abs(input[i]);
-            error = (input_abs * gain) / reference;
-
-            //An AGC is something nonlinear that's easier to implement in software:
-            //if the amplitude decreases, we increase the gain by minimizing the gain error by attack_rate.
-            //We also have a decay_rate that comes into consideration when the amplitude increases.
-            //The higher these rates are, the faster is the response of the AGC to amplitude changes.
-            //However, attack_rate should be higher than the decay_rate as we want to avoid clipping signals.
-            //that had a sudden increase in their amplitude.
-            //It's also important to note that this algorithm has an exponential gain ramp.
-
-            if (error > 1) {
-                //INCREASE IN SIGNAL LEVEL
-                //If the signal level increases, we decrease the gain quite fast.
-                dgain = 1 - attack_rate;
-                //Before starting to increase the gain next time, we will be waiting until hang_time for sure.
-                hang_counter = hang_time;
-            } else {
-                //DECREASE IN SIGNAL LEVEL
-                if (hang_counter > 0) {
-                    //Before starting to increase the gain, we will be waiting until hang_time.
-                    hang_counter--;
-                    dgain = 1; //..until then, AGC is inactive and gain doesn't change.
-                } else {
-                    dgain = 1 + decay_rate; //If the signal level decreases, we increase the gain quite slowly.
-                }
-            }
-            gain = gain * dgain;
-        }
+static inline float agcAbs(complex<float> in) {
+    return std::sqrt(in.i() * in.i() + in.q() * in.q());
+}
 
-        // alpha beta filter
-        xk = this->xk + (this->vk * dt);
-        vk = this->vk;
+// min / max instead of branches, so that the scaling loop vectorizes
+static inline short agcScale(short in, float gain) {
+    return (short) std::min(std::max(gain * in, (float) SHRT_MIN), (float) SHRT_MAX);
+}
 
-        rk = gain - xk;
+static inline float agcScale(float in, float gain) {
+    return std::min(std::max(in * gain, -1.0f), 1.0f);
+}
 
-        xk += gain_filter_alpha * rk;
-        vk += (beta * rk) / dt;
+static inline complex<float> agcScale(complex<float> in, float gain) {
+    return {
+        std::min(std::max(in.i() * gain, -1.0f), 1.0f),
+        std::min(std::max(in.q() * gain, -1.0f), 1.0f)
+    };
+}
 
-        this->xk = xk;
-        this->vk = vk;
+// applies a number of alpha beta filter steps at once, see Agc<T>::updateFilterSteps()
+static inline void agcFilterSteps(const float* steps, float& xk, float& vk) {
+    float x = steps[0] * xk + steps[1] * vk;
+    vk = steps[2] * xk + steps[3] * vk;
+    xk = x;
+}
 
-        gain = this->xk;
+template <typename T>
+void Agc<T>::process(T* input, T* output, size_t work_size) {
+    float error, dgain;
 
-        // clamp gain to max_gain and 0
-        if (gain > max_gain) gain = max_gain;
-        if (gain < 0) gain = 0;
+    float rk;
+    float dt = 0.5;
+    float beta = 0.005;
 
-        // actual sample scaling
-        output[i] = scale(input[i]);
-    }
-}
+    float envelope[AGC_BLOCK];
+    float gains[AGC_BLOCK];
 
-template <>
-float Agc<short>::abs(short in) {
-    return std::fabs((float) in) / SHRT_MAX;
-}
+    if (decay_rate != filter_steps_decay) updateFilterSteps();
 
-template <>
-bool Agc<short>::isZero(short in) {
-    return in == 0;
-}
+    for (size_t offset = 0; offset < work_size; offset += AGC_BLOCK) {
+        size_t length = std::min(work_size - offset, (size_t) AGC_BLOCK);
+        T* in = input + offset;
+        T* out = output + offset;
 
-template <>
-short Agc<short>::scale(short in) {
-    float val = gain * in;
-    if (val >= SHRT_MAX) return SHRT_MAX;
-    if (val <= SHRT_MIN) return SHRT_MIN;
-    return (short) val;
-}
+        //We actually use an envelope detector.
+        for (size_t i = 0; i < length; i++) envelope[i] = agcAbs(in[i]);
 
-template <>
-float Agc<float>::abs(float in) {
-    return std::fabs(in);
-}
+        //We skip samples containing 0, as the gain would be infinity for those to keep up with the reference.
+        float peak = 0;
+        size_t nonZero = 0;
+        for (size_t i = 0; i < length; i++) {
+            peak = std::max(peak, envelope[i]);
+            nonZero += envelope[i] > 0;
+        }
 
-template <>
-bool Agc<float>::isZero(float in) {
-    return in == 0.0f;
-}
+        bool updated = false;
+        if (peak * gain <= reference && (nonZero == length || nonZero == 0)) {
+            //No sample exceeds the reference: the gain doesn't change until hang_time has passed, then it increases by
+            //decay_rate per sample. Digital silence doesn't change the gain, and doesn't count towards hang_time.
+            //That's the case for most of the blocks, so the gain is only calculated for the end of the block and
+            //interpolated in between.
+            size_t hang = nonZero > 0 ? std::min((unsigned long int) length, hang_counter) : length;
+
+            // alpha beta filter. the first step starts from the current gain, which may have been clamped or set
+            // initially. all the following ones start from xk, and are done at once.
+            float x = xk + vk * dt;
+            float v = vk;
+            rk = gain * (hang > 0 ? 1 : 1 + decay_rate) - x;
+            x += gain_filter_alpha * rk;
+            v += (beta * rk) / dt;
+            agcFilterSteps(filter_steps[0][hang > 0 ? hang - 1 : 0], x, v);
+            agcFilterSteps(filter_steps[1][length - std::max(hang, (size_t) 1)], x, v);
+
+            // clamp gain to max_gain and 0
+            float next_gain = std::min(std::max(x, 0.0f), max_gain);
+
+            // the peak must not exceed the reference at the increased gain either
+            if (peak * next_gain <= reference) {
+                float step = (next_gain - gain) / length;
+                // int converts to float in a vector register, size_t doesn't
+                for (int i = 0; i < (int) length; i++) gains[i] = gain + step * (i + 1);
+                gain = next_gain;
+                xk = x;
+                vk = v;
+                if (nonZero > 0) hang_counter -= hang;
+                updated = true;
+            }
+        }
 
-template <>
-float Agc<float>::scale(float in) {
-    float val = in * gain;
-    if (val > 1.0f) return 1.0f;
-    if (val < -1.0f) return -1.0f;
-    return val;
-}
+        if (!updated) {
+            //The signal level increases (or there is digital silence) somewhere in this block, so the gain is
+            //calculated for every sample.
+            for (size_t i = 0; i < length; i++) {
+                if (envelope[i] > 0) {
+                    //The error is the difference between the required gain at the actual sample, and the previous gain
+                    //value.
+                    error = (envelope[i] * gain) / reference;
+
+                    //An AGC is something nonlinear that's easier to implement in software:
+                    //if the amplitude decreases, we increase the gain by minimizing the gain error by attack_rate.
+                    //We also have a decay_rate that comes into consideration when the amplitude increases.
+                    //The higher these rates are, the faster is the response of the AGC to amplitude changes.
+                    //However, attack_rate should be higher than the decay_rate as we want to avoid clipping signals.
+                    //that had a sudden increase in their amplitude.
+                    //It's also important to note that this algorithm has an exponential gain ramp.
+
+                    if (error > 1) {
+                        //INCREASE IN SIGNAL LEVEL
+                        //If the signal level increases, we decrease the gain quite fast.
+                        dgain = 1 - attack_rate;
+                        //Before starting to increase the gain next time, we will be waiting until hang_time for sure.
+                        hang_counter = hang_time;
+                    } else {
+                        //DECREASE IN SIGNAL LEVEL
+                        if (hang_counter > 0) {
+                            //Before starting to increase the gain, we will be waiting until hang_time.
+                            hang_counter--;
+                            dgain = 1; //..until then, AGC is inactive and gain doesn't change.
+                        } else {
+                            dgain = 1 + decay_rate; //If the signal level decreases, we increase the gain quite slowly.
+                        }
+                    }
+                    gain = gain * dgain;
+                }
 
-template <>
-float Agc<complex<float>>::abs(complex<float> in) {
-    return std::abs(in);
-}
+                // alpha beta filter
+                xk += vk * dt;
+
+                rk = gain - xk;
 
-template <>
-bool Agc<complex<float>>::isZero(complex<float> in) {
-    return in == complex<float>(0, 0);
+                xk += gain_filter_alpha * rk;
+                vk += (beta * rk) / dt;
+
+                gain = xk;
+
+                // clamp gain to max_gain and 0
+                if (gain > max_gain) gain = max_gain;
+                if (gain < 0) gain = 0;
+
+                gains[i] = gain;
+            }
+        }
+
+        // actual sample scaling
+        for (size_t i = 0; i < length; i++) out[i] = agcScale(in[i], gains[i]);
+    }
 }
 
-template <>
-complex<float> Agc<complex<float>>::scale(complex<float> in) {
-    complex<float> val = in * gain;
-    if (val.i() > 1.0f) val.i(1.0f);
-    if (val.q() > 1.0f) val.q(1.0f);
-    if (val.i() < -1.0f) val.i(-1.0f);
-    if (val.q() < -1.0f) val.q(-1.0f);
-    return val;
+// the alpha beta filter step with the gain update folded in is linear in its state (xk, vk) as long as the gain follows
+// xk and dgain doesn't change:
+//   xk' = (1 + alpha * (dgain - 1)) * xk + (1 - alpha) * dt * vk
+//   vk' = beta * (dgain - 1) / dt * xk + (1 - beta) * vk
+// a number of steps can then be taken at once with a power of that matrix. the powers are kept for dgain = 1 (hang time,
+// digital silence) and dgain = 1 + decay_rate.
+template <typename T>
+void Agc<T>::updateFilterSteps() {
+    float dt = 0.5;
+    float beta = 0.005;
+    for (int decay = 0; decay < 2; decay++) {
+        float dgain = decay ? 1 + decay_rate : 1;
+        float m[4] = { 1 + gain_filter_alpha * (dgain - 1), (1 - gain_filter_alpha) * dt, beta * (dgain - 1) / dt, 1 - beta };
+        float* p = filter_steps[decay][0];
+        p[0] = 1; p[1] = 0; p[2] = 0; p[3] = 1;
+        for (int k = 1; k <= AGC_BLOCK; k++) {
+            float* q = filter_steps[decay][k - 1];
+            p = filter_steps[decay][k];
+            p[0] = m[0] * q[0] + m[1] * q[2];
+            p[1] = m[0] * q[1] + m[1] * q[3];
+            p[2] = m[2] * q[0] + m[3] * q[2];
+            p[3] = m[2] * q[1] + m[3] * q[3];
+        }
+    }
+    filter_steps_decay = decay_rate;
 }
 
 template <typename T>
@@ -18,43 +18,151 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "audioresampler.hpp"
+#include "window.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
 
 using namespace Csdr;
 
-AudioResampler::AudioResampler(double rate):
-    rate(rate)
+ResamplerTable::ResamplerTable(unsigned int interpolation, unsigned int decimation, ResamplerQuality quality) {
+    double attenuation, bandwidth;
+    switch (quality) {
+        case RESAMPLER_LOW:
+            attenuation = 70;
+            bandwidth = 0.8;
+            break;
+        case RESAMPLER_HIGH:
+            attenuation = 120;
+            bandwidth = 0.95;
+            break;
+        case RESAMPLER_MEDIUM:
+        default:
+            attenuation = 97;
+            bandwidth = 0.9;
+            break;
+    }
+
+    // all frequencies relative to the input sample rate. the stopband starts at the lower of the two nyquist frequencies.
+    double nyquist = 0.5 * std::min(1.0, (double) interpolation / decimation);
+    double transition = (1 - bandwidth) * nyquist;
+    double cutoff = nyquist - transition / 2;
+
+    // kaiser's estimate for the filter length, rounded up to a multiple of 4 for the vector units. the estimate falls
+    // short by a fraction of a dB right at the stopband edge, hence the extra dB.
+    length = ceil((attenuation + 1 - 7.95) / (2.285 * 2 * M_PI * transition));
+    length = (length + 3) & ~3;
+
+    // every client runs its own resampler, but there are only a few different ratios in use
+    std::string key = "resampler " + std::to_string(interpolation) + " " + std::to_string(decimation) + " " + std::to_string(quality);
+    taps = TapCache::get<float>(key, [this, interpolation, attenuation, cutoff] () {
+        KaiserWindow window(KaiserWindow::beta(attenuation));
+        int middle = length / 2 - 1;
+        auto taps = (float*) malloc(sizeof(float) * length * interpolation);
+        for (unsigned int p = 0; p < interpolation; p++) {
+            float* phase = taps + p * length;
+            double fraction = (double) p / interpolation;
+            double sum = 0;
+            for (int j = 0; j < length; j++) {
+                double t = j - middle - fraction;
+                double coefficient = t == 0 ? 2 * cutoff : sin(2 * M_PI * cutoff * t) / (M_PI * t);
+                coefficient *= window.kernel(t / (length / 2));
+                phase[j] = (float) coefficient;
+                sum += coefficient;
+            }
+            // unity gain at DC for every phase
+            for (int j = 0; j < length; j++) phase[j] /= sum;
+        }
+        return new Taps<float>(taps, length * interpolation);
+    });
+}
+
+const float* ResamplerTable::getTaps(unsigned int phase) const {
+    return taps->getData() + phase * length;
+}
+
+unsigned int ResamplerTable::getLength() const {
+    return length;
+}
+
+AudioResampler::AudioResampler(double rate, ResamplerQuality quality):
+    quality(quality)
 {
-    int error = 0;
-    srcState = src_new(SRC_SINC_MEDIUM_QUALITY, 1, &error);
+    setRatio(rate);
 }
 
-AudioResampler::AudioResampler(unsigned int inputRate, unsigned int outputRate):
-    AudioResampler((double) outputRate / inputRate)
-{}
+AudioResampler::AudioResampler(unsigned int inputRate, unsigned int outputRate, ResamplerQuality quality):
+    quality(quality)
+{
+    unsigned int a = inputRate, b = outputRate;
+    while (b != 0) {
+        unsigned int r = a % b;
+        a = b;
+        b = r;
+    }
+    if (a != 0 && outputRate / a <= AUDIO_RESAMPLER_MAX_PHASES) {
+        interpolation = outputRate / a;
+        decimation = inputRate / a;
+        table = std::make_shared<ResamplerTable>(interpolation, decimation, quality);
+    } else {
+        setRatio((double) outputRate / inputRate);
+    }
+}
 
-AudioResampler::~AudioResampler() {
-    src_delete(srcState);
+void AudioResampler::setRatio(double rate) {
+    // closest fraction with no more than AUDIO_RESAMPLER_MAX_PHASES phases (continued fraction expansion)
+    unsigned long p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    double x = rate;
+    for (int i = 0; i < 32; i++) {
+        double a = floor(x);
+        unsigned long p2 = (unsigned long) a * p1 + p0;
+        unsigned long q2 = (unsigned long) a * q1 + q0;
+        if (p2 > AUDIO_RESAMPLER_MAX_PHASES) break;
+        p0 = p1; q0 = q1; p1 = p2; q1 = q2;
+        if (x - a < 1E-9) break;
+        x = 1 / (x - a);
+    }
+    if (p1 == 0 || q1 == 0) {
+        throw std::runtime_error("unsupported resampling rate");
+    }
+    interpolation = p1;
+    decimation = q1;
+    table = std::make_shared<ResamplerTable>(interpolation, decimation, quality);
 }
 
 bool AudioResampler::canProcess() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    return reader->available() > 0 && writer->writeable() > 0;
+    return reader->available() >= table->getLength() && writer->writeable() > 0;
+}
+
+CSDR_TARGET_CLONES
+static float resamplerDot(const float* input, const float* taps, unsigned int length) {
+    float acc = 0;
+    for (unsigned int i = 0; i < length; i++) {
+        acc += input[i] * taps[i];
+    }
+    return acc;
 }
 
 void AudioResampler::process() {
     std::lock_guard<std::mutex> lock(processMutex);
-    SRC_DATA data = {
-        .data_in = reader->getReadPointer(),
-        .data_out = writer->getWritePointer(),
-        .input_frames = (long) reader->available(),
-        .output_frames = (long) writer->writeable(),
-        .end_of_input = 0,
-        .src_ratio = rate
-    };
+    size_t available = reader->available();
+    size_t writeable = writer->writeable();
+    float* input = reader->getReadPointer();
+    float* output = writer->getWritePointer();
+    unsigned int length = table->getLength();
 
-    src_process(srcState, &data);
+    size_t offset = 0;
+    size_t oi = 0;
+    while (offset + length <= available && oi < writeable) {
+        output[oi++] = resamplerDot(input + offset, table->getTaps(phase), length);
+        phase += decimation;
+        offset += phase / interpolation;
+        phase %= interpolation;
+    }
 
-    reader->advance(data.input_frames_used);
-    writer->advance(data.output_frames_gen);
+    reader->advance(offset);
+    writer->advance(oi);
 }
-
@@ -0,0 +1,176 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "bandpowertap.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace Csdr;
+
+// same amount of zeros that Squelch produces (5 blocks of 1024 samples)
+#define SQUELCH_GATE_FLUSH 5120
+
+SquelchGate::SquelchGate(): SquelchGate(SQUELCH_GATE_FLUSH) {}
+
+SquelchGate::SquelchGate(size_t flush): flush(flush) {}
+
+bool SquelchGate::canProcess() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    return reader->available() > 0 && writer->writeable() > 0;
+}
+
+void SquelchGate::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    size_t length = std::min(reader->available(), writer->writeable());
+    if (open) {
+        std::memcpy(writer->getWritePointer(), reader->getReadPointer(), sizeof(complex<float>) * length);
+        writer->advance(length);
+        flushRemaining = flush;
+    } else if (flushRemaining > 0) {
+        length = std::min(length, flushRemaining);
+        std::memset(writer->getWritePointer(), 0, sizeof(complex<float>) * length);
+        writer->advance(length);
+        flushRemaining -= length;
+    } else {
+        length = reader->available();
+    }
+    reader->advance(length);
+}
+
+void SquelchGate::setOpen(bool open) {
+    this->open = open;
+}
+
+void SquelchGate::setFlush(size_t flush) {
+    this->flush = flush;
+}
+
+BandPowerTap::BandPowerTap(float reportInterval): reportInterval(reportInterval) {}
+
+unsigned int BandPowerTap::addBand(float lowCut, float highCut) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    unsigned int id = nextId++;
+    Band& band = bands[id];
+    band.lowCut = lowCut;
+    band.highCut = highCut;
+    band.lastReport = std::chrono::steady_clock::now();
+    band.lastFrame = band.lastReport;
+    return id;
+}
+
+void BandPowerTap::setBand(unsigned int id, float lowCut, float highCut) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    auto it = bands.find(id);
+    if (it == bands.end()) return;
+    it->second.lowCut = lowCut;
+    it->second.highCut = highCut;
+}
+
+void BandPowerTap::removeBand(unsigned int id) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    bands.erase(id);
+}
+
+void BandPowerTap::setWriter(unsigned int id, Writer<float>* writer) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    auto it = bands.find(id);
+    if (it == bands.end()) return;
+    it->second.writer = writer;
+}
+
+void BandPowerTap::setSquelch(unsigned int id, float level, SquelchGate* gate, float hysteresis, float holdTime) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    auto it = bands.find(id);
+    if (it == bands.end()) return;
+    Band& band = it->second;
+    band.squelchLevel = level;
+    band.gate = gate;
+    band.hysteresis = hysteresis > 1.0f ? hysteresis : 1.0f;
+    band.holdTime = holdTime;
+    if (gate != nullptr && level == 0) {
+        band.open = true;
+        gate->setOpen(true);
+    }
+}
+
+CSDR_TARGET_CLONES
+static float binPower(complex<float>* spectrum, int from, int to) {
+    float acc = 0;
+    for (int i = from; i < to; i++) {
+        acc += spectrum[i].i() * spectrum[i].i() + spectrum[i].q() * spectrum[i].q();
+    }
+    return acc;
+}
+
+void BandPowerTap::measure(complex<float>* spectrum, unsigned int fftSize, float normalization) {
+    std::lock_guard<std::mutex> lock(bandMutex);
+    if (bands.empty()) return;
+    auto now = std::chrono::steady_clock::now();
+    int size = (int) fftSize;
+    for (auto& it: bands) {
+        Band& band = it.second;
+        // bins whose center lies within the band. negative frequencies are in the upper half of the FFT output.
+        int from = (int) lroundf(band.lowCut * size);
+        int to = std::max((int) lroundf(band.highCut * size), from + 1);
+        to = std::min(to, from + size);
+        float power = 0;
+        int start = ((from % size) + size) % size;
+        int length = to - from;
+        if (start + length <= size) {
+            power = binPower(spectrum, start, start + length);
+        } else {
+            power = binPower(spectrum, start, size) + binPower(spectrum, 0, start + length - size);
+        }
+        power /= normalization;
+
+        float elapsed = std::chrono::duration<float>(now - band.lastFrame).count();
+        band.lastFrame = now;
+        if (band.gate != nullptr && band.squelchLevel > 0) {
+            if (power >= band.squelchLevel) {
+                band.open = true;
+                band.holdRemaining = band.holdTime;
+            } else if (band.open && power >= band.squelchLevel / band.hysteresis) {
+                // the hold time only counts while the power stays below the lower threshold
+                band.holdRemaining = band.holdTime;
+            } else if (band.open) {
+                if (band.holdRemaining > 0) {
+                    band.holdRemaining -= elapsed;
+                } else {
+                    band.open = false;
+                }
+            }
+            band.gate->setOpen(band.open);
+        }
+
+        band.accumulator += power;
+        band.frames++;
+        if (std::chrono::duration<float>(now - band.lastReport).count() >= reportInterval) {
+            if (band.writer != nullptr && band.writer->writeable() > 0) {
+                *(band.writer->getWritePointer()) = (float) (band.accumulator / band.frames);
+                band.writer->advance(1);
+            }
+            band.accumulator = 0;
+            band.frames = 0;
+            band.lastReport = now;
+        }
+    }
+}
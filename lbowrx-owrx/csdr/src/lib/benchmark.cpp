@@ -34,9 +34,53 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "firdecimate.hpp"
 #include "window.hpp"
 #include "adpcm.hpp"
+#include "decibel.hpp"
+#include "waterfallengine.hpp"
+#include "zoomfft.hpp"
+#include "fft.hpp"
+#include "fftplanner.hpp"
+#include "fftdelta.hpp"
+#include "polyphasefft.hpp"
+#include "bandpowertap.hpp"
+#include "occupancyindex.hpp"
+#include "fmdemod.hpp"
+#include "agc.hpp"
+#include "fractionaldecimator.hpp"
+#include "audioresampler.hpp"
+#include "power.hpp"
+#include "fir.hpp"
+#include "ringbuffer.hpp"
+#include "converter.hpp"
+#include "shift.hpp"
+#include "filter.hpp"
+#include "fftfilter.hpp"
+#include "half.hpp"
+#include "tapcache.hpp"
+#include "deemphasis.hpp"
+#include "dcblock.hpp"
+#include "limit.hpp"
+#include "timingrecovery.hpp"
+#include "dbpsk.hpp"
+#include "varicode.hpp"
+#include "carrierrecovery.hpp"
+#include "goertzel.hpp"
+// only used as a reference for the NFM deemphasis
 
 #include <iostream>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <vector>
+#include <complex>
+#include <cstring>
+#include <climits>
+#include <type_traits>
+#include <functional>
 #include <fcntl.h>
+#ifdef CSDR_HAS_SAMPLERATE
+#include <samplerate.h>
+#endif
 #include <unistd.h>
 
 #define T_BUFSIZE (1024 * 1024 / 4)
@@ -80,6 +124,16 @@ float* Benchmark::getTestData() {
     return buf_f;
 }
 
+template <>
+unsigned char* Benchmark::getTestData() {
+    std::cerr << "Getting " << T_BUFSIZE << " of random samples...\n";
+    int urand_fp = open("/dev/urandom", O_RDWR);
+    auto buf_u8 = (unsigned char*) malloc(sizeof(unsigned char) * T_BUFSIZE);
+    read(urand_fp, buf_u8, T_BUFSIZE);
+    close(urand_fp);
+    return buf_u8;
+}
+
 template <>
 short* Benchmark::getTestData() {
     std::cerr << "Getting " << T_BUFSIZE << " of random samples...\n";
@@ -98,7 +152,7 @@ short* Benchmark::getTestData() {
 }
 
 template <typename T, typename U>
-void Benchmark::runModule(Module<T, U>* module) {
+void Benchmark::runModule(const std::string& name, Module<T, U>* module) {
     T* buf_c = getTestData<T>();
     auto reader = new MemoryReader<T>(buf_c, T_BUFSIZE);
     module->setReader(reader);
@@ -109,14 +163,13 @@ void Benchmark::runModule(Module<T, U>* module) {
 
     std::cerr << "Starting tests of processing " << T_BUFSIZE * T_N << " samples...\n";
 
-    //fir_decimate_cc
     clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
     for (int i = 0; i < T_N; i++) {
         while (module->canProcess()) module->process();
         reader->rewind();
     }
     clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
-    std::cerr << "firdecimate done in " << timeTaken(start_time, end_time) << " seconds.\n";
+    std::cerr << name << " done in " << timeTaken(start_time, end_time) << " seconds.\n";
 
     delete reader;
     delete writer;
@@ -125,12 +178,1310 @@ void Benchmark::runModule(Module<T, U>* module) {
 
 void Benchmark::run() {
     auto window = new HammingWindow();
-    auto module = new FirDecimate(T_DECFACT, 0.00391389432485, window);
-    runModule(module);
+    auto module = new FirDecimate<complex<float>>(T_DECFACT, 0.00391389432485, window);
+    runModule("firdecimate", module);
     delete module;
+
+    // cost of the additional waterfall levels
+    for (unsigned int levels = 1; levels <= 5; levels += 2) {
+        auto waterfall = new WaterfallEngine<unsigned char>(4096, 4096, 10, -70, window, levels, PYRAMID_MAX);
+        runModule("waterfall with " + std::to_string(levels) + " levels", waterfall);
+        delete waterfall;
+    }
+
+    // 1024 bins over 1/16 of the band vs. the full band at the same resolution, both producing one frame per 16384 samples
+    auto zoomFft = new ZoomFft(0.1, 16, 1024, 1024, window);
+    runModule("zoomfft 1024 bins, decimation 16", zoomFft);
+    delete zoomFft;
+    auto fullFft = new Fft<complex<float>>(16384, 16384, window);
+    runModule("full band fft 16384 bins", fullFft);
+    delete fullFft;
+
+    auto agc = new Agc<float>();
+    runModule("agc float", agc);
+    delete agc;
+    auto agcComplex = new Agc<complex<float>>();
+    runModule("agc complex", agcComplex);
+    delete agcComplex;
+
+    // broadcast FM audio with prefilter, and the fractional stage behind FirDecimate in the Selector
+    auto wfmDecimator = new FractionalDecimator<float>(200000.0f / 48000, 12, 0.03f, window);
+    runModule("fractional decimator wfm 200k -> 48k", wfmDecimator);
+    delete wfmDecimator;
+    auto selectorDecimator = new FractionalDecimator<complex<float>>(2048000.0f / 42 / 48000);
+    runModule("fractional decimator selector 2048k -> 48k", selectorDecimator);
+    delete selectorDecimator;
+
     delete window;
+
+    runDecibel();
+    runConverters();
+    runFftThreads();
+    runFftDelta();
+    runPolyphaseFft();
+    runBandPowerTap();
+    runOccupancyIndex();
+    runFmDemod();
+    runNfmDeemphasis();
+    runIir();
+    runSquelch();
+    runTimingRecovery();
+    runPskDecoders();
+    runCarrierRecovery();
+    runGoertzelBank();
+    runAudioResampler();
+    runTransportFormats();
+    runIdleListeners();
+    runTapCache();
+}
+
+// counts what has been written, so that we can report frames per second
+template <typename T>
+class CountingWriter: public VoidWriter<T> {
+    public:
+        explicit CountingWriter(size_t buffer_size): VoidWriter<T>(buffer_size) {}
+        void advance(size_t how_much) override { written += how_much; }
+        size_t written = 0;
+};
+
+void Benchmark::runFftThreads() {
+    if (!FftPlanner::hasThreads()) {
+        std::cerr << "built without fftw3f_threads, skipping multithreaded FFT benchmark\n";
+        return;
+    }
+
+    // large FFT with 50% overlap, like a 10 MS/s receiver at high fps would need
+    const unsigned int fftSize = 131072;
+    complex<float>* buf_c = getTestData<complex<float>>();
+    auto window = new HammingWindow();
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    struct ::timespec start_time, end_time;
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads++) {
+        auto module = new Fft<complex<float>>(fftSize, fftSize / 2, window, threads);
+        auto reader = new MemoryReader<complex<float>>(buf_c, T_BUFSIZE);
+        auto writer = new CountingWriter<complex<float>>(fftSize * 2);
+        module->setReader(reader);
+        module->setWriter(writer);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            while (module->canProcess()) module->process();
+            reader->rewind();
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+
+        double frames = (double) writer->written / fftSize;
+        std::cerr << "fft " << fftSize << " with " << threads << " threads: "
+                  << frames / timeTaken(start_time, end_time) << " frames per second\n";
+
+        delete module;
+        delete reader;
+        delete writer;
+    }
+
+    delete window;
+    free(buf_c);
+}
+
+// libm reference for the dB kernel benchmark; this is what LogPower used to do
+static void powerToDbScalar(const float* input, float* output, size_t size, float offset) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = 10 * log10(input[i]) + offset;
+    }
+}
+
+void Benchmark::runDecibel() {
+    float* input = getTestData<float>();
+    // keep the power values positive, like they would be coming out of an FFT
+    for (int i = 0; i < T_BUFSIZE; i++) {
+        input[i] = input[i] * input[i] + 1E-10f;
+    }
+    auto output = (float*) malloc(sizeof(float) * T_BUFSIZE);
+
+    struct ::timespec start_time, end_time;
+
+    for (size_t fftSize = 4096; fftSize <= 65536; fftSize *= 2) {
+        size_t lines = T_BUFSIZE / fftSize;
+        double maxError = 0;
+        auto reference = (float*) malloc(sizeof(float) * fftSize);
+        powerToDbScalar(input, reference, fftSize, 0.0f);
+        powerToDb(input, output, fftSize, 0.0f);
+        for (size_t i = 0; i < fftSize; i++) {
+            maxError = std::max(maxError, (double) std::fabs(output[i] - reference[i]));
+        }
+        free(reference);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < lines; k++) powerToDbScalar(input + k * fftSize, output + k * fftSize, fftSize, 0.0f);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double scalar = timeTaken(start_time, end_time);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < lines; k++) powerToDb(input + k * fftSize, output + k * fftSize, fftSize, 0.0f);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double fast = timeTaken(start_time, end_time);
+
+        double samples = (double) T_N * lines * fftSize;
+        std::cerr << "dB conversion, fft size " << fftSize << ": "
+                  << "libm " << samples / scalar / 1E6 << " Msamples/s, "
+                  << "fast " << samples / fast / 1E6 << " Msamples/s "
+                  << "(speedup " << scalar / fast << ", max error " << maxError << " dB)\n";
+    }
+
+    free(output);
+    free(input);
 }
 
 double Benchmark::timeTaken(struct ::timespec start, struct ::timespec end) {
     return (end.tv_sec - start.tv_sec) + (end.tv_nsec-start.tv_nsec) / 1e9;
 }
+
+void Benchmark::runFftDelta() {
+    // waterfall lines as produced by the spectrum chain (averaged, dB, sides swapped) from a noise floor with a few
+    // carriers. averaging is what the default settings yield for a 2.4 MS/s receiver.
+    const unsigned int fftSize = 4096;
+    const unsigned int lines = 64;
+    const unsigned int avgNumber = 100;
+    auto buf_c = (complex<float>*) malloc(sizeof(complex<float>) * T_BUFSIZE);
+    std::minstd_rand generator;
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    float carriers[] = { -0.31f, 0.0123f, 0.25f };
+    size_t sample = 0;
+    auto window = new HammingWindow();
+    auto engine = new WaterfallEngine<float>(fftSize, fftSize, avgNumber, -70, window);
+    auto reader = new MemoryReader<complex<float>>(buf_c, T_BUFSIZE);
+    auto buffer = new Ringbuffer<float>(fftSize * lines * 2);
+    auto spectrum = new RingbufferReader<float>(buffer);
+    engine->setReader(reader);
+    engine->setWriter(buffer);
+    while (spectrum->available() < fftSize * lines) {
+        for (int i = 0; i < T_BUFSIZE; i++, sample++) {
+            buf_c[i] = { noise(generator), noise(generator) };
+            for (float f: carriers) {
+                buf_c[i] += complex<float>(cos(2 * M_PI * f * sample), sin(2 * M_PI * f * sample)) * 0.1f;
+            }
+        }
+        reader->rewind();
+        while (engine->canProcess()) engine->process();
+    }
+    float* data = spectrum->getReadPointer();
+
+    auto output = (unsigned char*) malloc(FftDeltaCodec::maxEncodedSize(fftSize));
+    FftDeltaCodec codec(fftSize, -140, 120, 16);
+    size_t bytes = 0;
+    for (unsigned int i = 0; i < lines; i++) {
+        bytes += codec.encode(data + i * fftSize, output);
+    }
+
+    struct ::timespec start_time, end_time;
+    codec.reset();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < T_N; i++) {
+        for (unsigned int k = 0; k < lines; k++) codec.encode(data + k * fftSize, output);
+    }
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+
+    double bins = (double) T_N * lines * fftSize;
+    std::cerr << "fftdelta, fft size " << fftSize << ": "
+              << (double) bytes / lines << " bytes per line "
+              << "(adpcm " << (fftSize + COMPRESS_FFT_PAD_N) / 2 << ", none " << fftSize * sizeof(float) << "), "
+              << timeTaken(start_time, end_time) * 1E9 / bins << " ns per bin\n";
+
+    free(output);
+    delete spectrum;
+    delete buffer;
+    delete reader;
+    delete engine;
+    delete window;
+    free(buf_c);
+}
+
+// strongest leakage of a tone more than 3 bins (of width 1 / binSize) away from it, relative to the peak, in dB.
+// the tone is swept across half a bin, so the worst case between two bins is included.
+static double spectrumLeakage(Module<complex<float>, complex<float>>* module, unsigned int fftSize, unsigned int binSize) {
+    auto tone = (complex<float>*) malloc(sizeof(complex<float>) * T_BUFSIZE);
+    auto buffer = new Ringbuffer<complex<float>>(fftSize * 4);
+    auto spectrum = new RingbufferReader<complex<float>>(buffer);
+    auto reader = new MemoryReader<complex<float>>(tone, T_BUFSIZE);
+    module->setReader(reader);
+    module->setWriter(buffer);
+
+    double worst = -INFINITY;
+    // the offsets avoid the bin centers of all the FFT sizes in the comparison
+    for (double offset = 0.01; offset <= 0.5; offset += 0.13) {
+        double frequency = (binSize / 4 + offset) / binSize;
+        for (int i = 0; i < T_BUFSIZE; i++) {
+            tone[i] = complex<float>(cos(2 * M_PI * frequency * i), sin(2 * M_PI * frequency * i));
+        }
+        reader->rewind();
+        while (spectrum->available() < fftSize) module->process();
+        complex<float>* bins = spectrum->getReadPointer();
+
+        double peak = 0, leakage = 0;
+        for (unsigned int k = 0; k < fftSize; k++) {
+            double power = std::norm(bins[k]);
+            // distance in units of the reference bin width, taking the wraparound into account
+            double distance = std::fabs((double) k / fftSize - frequency) * binSize;
+            distance = std::min(distance, binSize - distance);
+            if (distance < 1) {
+                peak = std::max(peak, power);
+            } else if (distance >= 3) {
+                leakage = std::max(leakage, power);
+            }
+        }
+        worst = std::max(worst, 10 * log10(leakage / peak));
+        spectrum->advance(spectrum->available());
+    }
+
+    delete spectrum;
+    delete buffer;
+    delete reader;
+    free(tone);
+    return worst;
+}
+
+void Benchmark::runPolyphaseFft() {
+    // the polyphase estimator against plain FFTs of the same and of a larger size, all producing 4096 bins worth of
+    // resolution per frame (the larger FFTs could be merged down to 4096 bins)
+    const unsigned int fftSize = 4096;
+    complex<float>* buf_c = getTestData<complex<float>>();
+    auto window = new BlackmanWindow();
+
+    struct ::timespec start_time, end_time;
+
+    std::vector<std::pair<unsigned int, unsigned int>> setups = { {fftSize, 1}, {fftSize * 4, 1}, {fftSize * 8, 1}, {fftSize, 4}, {fftSize, 8} };
+    for (auto setup: setups) {
+        unsigned int size = setup.first;
+        unsigned int taps = setup.second;
+        auto create = [size, taps, window] () -> Module<complex<float>, complex<float>>* {
+            if (taps > 1) return new PolyphaseFft(size, taps, size, window);
+            return new Fft<complex<float>>(size, size, window);
+        };
+        // setReader() unblocks the previous reader, so the timing runs on a fresh instance
+        auto module = create();
+        double leakage = spectrumLeakage(module, size, fftSize);
+        delete module;
+
+        module = create();
+
+        auto reader = new MemoryReader<complex<float>>(buf_c, T_BUFSIZE);
+        auto writer = new CountingWriter<complex<float>>(size * 2);
+        module->setReader(reader);
+        module->setWriter(writer);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            while (module->canProcess()) module->process();
+            reader->rewind();
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+
+        double frames = (double) writer->written / size;
+        std::cerr << (taps > 1 ? "polyphase fft " : "fft ") << size;
+        if (taps > 1) std::cerr << " with " << taps << " taps";
+        std::cerr << ": " << timeTaken(start_time, end_time) / frames * 1E6 << " us per frame, "
+                  << "leakage " << leakage << " dB\n";
+
+        delete module;
+        delete reader;
+        delete writer;
+    }
+
+    delete window;
+    free(buf_c);
+}
+
+void Benchmark::runBandPowerTap() {
+    // one FFT frame measured for many bands vs. a Power module on every channel. the accuracy of the readings is
+    // covered by the bandpowertap test.
+    const unsigned int fftSize = 4096;
+    complex<float>* buf_c = getTestData<complex<float>>();
+    struct ::timespec start_time, end_time;
+
+    const unsigned int bands = 100;
+    auto tap = new BandPowerTap(1);
+    for (unsigned int i = 0; i < bands; i++) tap->addBand(-0.5f + i * 0.01f, -0.49f + i * 0.01f);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < T_N * 100; i++) tap->measure(buf_c, fftSize, fftSize);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double tapTime = timeTaken(start_time, end_time) / (T_N * 100);
+    delete tap;
+
+    auto power = new Power(1, [] (float) {});
+    auto reader = new MemoryReader<complex<float>>(buf_c, T_BUFSIZE);
+    auto writer = new CountingWriter<complex<float>>(T_BUFSIZE);
+    power->setReader(reader);
+    power->setWriter(writer);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < T_N; i++) {
+        while (power->canProcess()) power->process();
+        reader->rewind();
+    }
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double powerTime = timeTaken(start_time, end_time) / ((double) T_N * T_BUFSIZE);
+    delete power;
+    delete reader;
+    delete writer;
+
+    std::cerr << "band power tap: " << tapTime * 1E6 << " us per frame for " << bands << " bands; "
+              << "Power: " << powerTime * 1E9 << " ns per channel sample\n";
+
+    free(buf_c);
+}
+
+void Benchmark::runOccupancyIndex() {
+    // waterfall lines of a large FFT: noise floor at -100 dB with some carriers. a second thread keeps reading
+    // snapshots all the time, which must neither block nor disturb the updates.
+    const unsigned int fftSize = 131072;
+    const unsigned int lines = 300;
+    const unsigned int carriers = 20;
+    std::minstd_rand generator;
+    std::normal_distribution<float> noise(-100.0f, 2.0f);
+    std::vector<float> line(fftSize * 4);
+    for (unsigned int k = 0; k < line.size(); k++) {
+        line[k] = noise(generator);
+    }
+    for (unsigned int c = 0; c < carriers; c++) {
+        unsigned int center = (c + 1) * fftSize / (carriers + 1);
+        for (unsigned int k = center - 50; k < center + 50; k++) {
+            for (unsigned int l = 0; l < 4; l++) line[l * fftSize + k] = -60.0f;
+        }
+    }
+
+    auto index = new OccupancyIndex(fftSize);
+    std::atomic<bool> running{true};
+    unsigned long reads = 0;
+    std::thread reader([index, &running, &reads] {
+        while (running) {
+            auto snapshot = index->acquire();
+            if (snapshot != nullptr) {
+                reads += snapshot->carriers.size() > 0;
+                index->release(snapshot);
+            }
+        }
+    });
+
+    struct ::timespec start_time, end_time;
+    // cpu time of this thread only, the reader may well share the core
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start_time);
+    for (unsigned int i = 0; i < lines; i++) {
+        index->update(line.data() + (i % 4) * fftSize);
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end_time);
+    running = false;
+    reader.join();
+
+    double perLine = timeTaken(start_time, end_time) / lines;
+    auto snapshot = index->acquire();
+    std::cerr << "occupancy index " << fftSize << " bins: " << perLine * 1E6 << " us per line ("
+              << perLine * 30 * 100 << "% of a core at 30 fps), noise floor " << snapshot->noiseFloor << " dB, "
+              << snapshot->carriers.size() << " of " << carriers << " carriers detected, "
+              << snapshot->sequence << " of " << lines << " lines published, " << reads << " concurrent reads\n";
+    index->release(snapshot);
+
+    delete index;
+}
+
+// the previous FmDemod implementation: five passes through scratch buffers of 1024 samples, with a division per sample
+static void fmDemodMultiPass(complex<float>* input, float* output, size_t size, complex<float>& last_sample, float* temp_dq, float* temp_di) {
+    for (size_t offset = 0; offset < size; offset += 1024) {
+        size_t work_size = std::min(size - offset, (size_t) 1024);
+        complex<float>* in = input + offset;
+        float* out = output + offset;
+        temp_dq[0] = in[0].q() - last_sample.q();
+        for (size_t i = 1; i < work_size; i++) temp_dq[i] = in[i].q() - in[i - 1].q();
+        temp_di[0] = in[0].i() - last_sample.i();
+        for (size_t i = 1; i < work_size; i++) temp_di[i] = in[i].i() - in[i - 1].i();
+        for (size_t i = 0; i < work_size; i++) out[i] = in[i].i() * temp_dq[i] - in[i].q() * temp_di[i];
+        for (size_t i = 0; i < work_size; i++) temp_dq[i] = in[i].i() * in[i].i() + in[i].q() * in[i].q();
+        for (size_t i = 0; i < work_size; i++) out[i] = temp_dq[i] ? fmdemod_quadri_K * out[i] / temp_dq[i] : 0;
+        last_sample = in[work_size - 1];
+    }
+}
+
+void Benchmark::runFmDemod() {
+    // a 1 kHz tone at full deviation, narrow FM at 48 kS/s and broadcast FM at 200 kS/s. the input arrives in blocks
+    // of 20ms, like it does in the demodulator chains.
+    auto input = (complex<float>*) malloc(sizeof(complex<float>) * T_BUFSIZE);
+    auto output = (float*) malloc(sizeof(float) * T_BUFSIZE);
+    auto temp_dq = (float*) malloc(sizeof(float) * 1024);
+    auto temp_di = (float*) malloc(sizeof(float) * 1024);
+    std::minstd_rand generator;
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    struct ::timespec start_time, end_time;
+
+    std::vector<std::pair<double, double>> setups = { {48000, 5000}, {200000, 75000} };
+    for (auto setup: setups) {
+        double rate = setup.first;
+        double deviation = setup.second;
+        double phase = 0;
+        for (int i = 0; i < T_BUFSIZE; i++) {
+            phase += 2 * M_PI * deviation / rate * sin(2 * M_PI * 1000 * i / rate);
+            input[i] = { (float) cos(phase) + noise(generator), (float) sin(phase) + noise(generator) };
+        }
+        size_t block = (size_t) rate / 50;
+        size_t blocks = T_BUFSIZE / block;
+
+        // accuracy against the exact phase difference
+        double legacyError = 0, fastError = 0;
+        complex<float> last = {0, 0};
+        fmDemodMultiPass(input, output, blocks * block, last, temp_dq, temp_di);
+        for (size_t i = 1; i < blocks * block; i++) {
+            double exact = fmdemod_quadri_K * std::arg(std::complex<double>(input[i].i(), input[i].q()) * std::conj(std::complex<double>(input[i - 1].i(), input[i - 1].q())));
+            legacyError = std::max(legacyError, std::fabs(output[i] - exact));
+        }
+        auto demod = new FmDemod();
+        for (size_t k = 0; k < blocks; k++) demod->process(input + k * block, output + k * block, block);
+        for (size_t i = 1; i < blocks * block; i++) {
+            double exact = fmdemod_quadri_K * std::arg(std::complex<double>(input[i].i(), input[i].q()) * std::conj(std::complex<double>(input[i - 1].i(), input[i - 1].q())));
+            fastError = std::max(fastError, std::fabs(output[i] - exact));
+        }
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < blocks; k++) fmDemodMultiPass(input + k * block, output + k * block, block, last, temp_dq, temp_di);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double legacy = timeTaken(start_time, end_time);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < blocks; k++) demod->process(input + k * block, output + k * block, block);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double fast = timeTaken(start_time, end_time);
+        delete demod;
+
+        double samples = (double) T_N * blocks * block;
+        std::cerr << "fm demodulation at " << rate / 1000 << " kS/s, " << deviation / 1000 << " kHz deviation: "
+                  << "multi-pass " << legacy / samples * 1E9 << " ns per sample (max error " << legacyError << "), "
+                  << "single pass " << fast / samples * 1E9 << " ns per sample (max error " << fastError << ")\n";
+    }
+
+    free(input);
+    free(output);
+    free(temp_dq);
+    free(temp_di);
+}
+
+void Benchmark::runNfmDeemphasis() {
+    for (unsigned int rate: {12000, 48000}) {
+        auto deemphasis = new NfmDeephasis(rate);
+        runModule("nfm deemphasis at " + std::to_string(rate) + " S/s", deemphasis);
+        delete deemphasis;
+    }
+}
+
+// the previous WfmDeemphasis implementation, one sample at a time
+static void deemphasisSerial(float* input, float* output, size_t size, float alpha, float& last_output) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = last_output = alpha * input[i] + (1 - alpha) * last_output;
+    }
+}
+
+void Benchmark::runIir() {
+    // the wfm deemphasis (50 us) at audio rate and at a typical wfm demodulator rate, the input arrives in blocks of
+    // 20 ms. noise instead of a tone, so that all frequencies contribute to the error.
+    auto input = (float*) malloc(sizeof(float) * T_BUFSIZE);
+    auto output = (float*) malloc(sizeof(float) * T_BUFSIZE);
+    auto reference = (float*) malloc(sizeof(float) * T_BUFSIZE);
+    std::minstd_rand generator;
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (int i = 0; i < T_BUFSIZE; i++) input[i] = noise(generator);
+    struct ::timespec start_time, end_time;
+
+    for (unsigned int rate: {48000, 200000}) {
+        size_t block = rate / 50;
+        size_t blocks = std::min((size_t) rate, (size_t) T_BUFSIZE) / block;
+        size_t length = blocks * block;
+        float dt = 1.0f / rate;
+        float alpha = dt / 50e-6f + dt;
+
+        // WfmDeemphasis runs exactly this
+        float last_output = 0.0f;
+        deemphasisSerial(input, reference, length, alpha, last_output);
+        FirstOrderIir iir(alpha, 1 - alpha);
+        for (size_t k = 0; k < blocks; k++) iir.process(input + k * block, output + k * block, block);
+        double error = 0;
+        for (size_t i = 0; i < length; i++) error = std::max(error, (double) std::fabs(output[i] - reference[i]));
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < blocks; k++) deemphasisSerial(input + k * block, output + k * block, block, alpha, last_output);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double serial = timeTaken(start_time, end_time);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < blocks; k++) iir.process(input + k * block, output + k * block, block);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double lookAhead = timeTaken(start_time, end_time);
+
+        auto dcBlock = new DcBlock();
+        size_t dcLength = length - length % dcBlock->getLength();
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            for (size_t k = 0; k < dcLength; k += dcBlock->getLength()) dcBlock->process(input + k, output + k);
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double dc = timeTaken(start_time, end_time);
+        delete dcBlock;
+
+        double samples = (double) T_N * length;
+        std::cerr << "wfm deemphasis at " << rate / 1000 << " kS/s: "
+                  << "serial " << samples / serial / 1E6 << " MS/s, "
+                  << "look-ahead " << samples / lookAhead / 1E6 << " MS/s (max error " << error << "); "
+                  << "dc block " << (double) T_N * dcLength / dc / 1E6 << " MS/s\n";
+    }
+
+    free(input);
+    free(output);
+    free(reference);
+}
+
+// tracks the squelch state from the data written: flush blocks are zeros, closed blocks aren't written at all
+class GateWriter: public VoidWriter<complex<float>> {
+    public:
+        explicit GateWriter(size_t buffer_size): VoidWriter<complex<float>>(buffer_size) {}
+        void advance(size_t how_much) override {
+            complex<float> sample = getWritePointer()[0];
+            bool now = sample.i() != 0.0f || sample.q() != 0.0f;
+            if (now != open) transitions++;
+            open = now;
+        }
+        bool open = false;
+        size_t transitions = 0;
+};
+
+void Benchmark::runSquelch() {
+    // the selector used to measure every 5th sample and hand every block to the callback, which had to count blocks.
+    // now every sample is measured (vectorized) and readings are averaged, 4 per second at 48 kS/s.
+    complex<float>* buf_c = getTestData<complex<float>>();
+    const unsigned int rate = 48000;
+    struct ::timespec start_time, end_time;
+
+    struct {
+        const char* name;
+        unsigned int decimation;
+        unsigned int reportInterval;
+    } configs[] = {
+        {"decimation 5, every block", 5, 1},
+        {"decimation 1, 4 readings/s", 1, rate / (4 * 1024)},
+    };
+    for (auto& config: configs) {
+        size_t callbacks = 0;
+        auto squelch = new Squelch(config.decimation, [&callbacks] (float power) { callbacks++; });
+        squelch->setReportInterval(config.reportInterval);
+        auto reader = new MemoryReader<complex<float>>(buf_c, T_BUFSIZE);
+        auto writer = new VoidWriter<complex<float>>(T_BUFSIZE);
+        squelch->setReader(reader);
+        squelch->setWriter(writer);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N; i++) {
+            while (squelch->canProcess()) squelch->process();
+            reader->rewind();
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double samples = (double) T_N * T_BUFSIZE;
+        std::cerr << "squelch " << config.name << ": " << timeTaken(start_time, end_time) * 1E9 / samples << " ns/sample, "
+                  << callbacks / (samples / rate) << " callbacks per second of signal\n";
+
+        delete squelch;
+        delete reader;
+        delete writer;
+    }
+    free(buf_c);
+
+    // a carrier fading +-6 dB around the squelch level over 2 seconds, with +-3 dB of block-to-block jitter.
+    // a good squelch opens and closes once per cycle.
+    const size_t block = 1024;
+    size_t blocks = T_BUFSIZE / block;
+    auto signal = (complex<float>*) malloc(sizeof(complex<float>) * T_BUFSIZE);
+    std::minstd_rand generator;
+    std::uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> phase(0.0f, 2 * M_PI);
+    for (size_t k = 0; k < blocks; k++) {
+        float db = 6.0f * sinf(2 * M_PI * k * block / (2.0f * rate)) + jitter(generator);
+        float amplitude = powf(10.0f, db / 20.0f);
+        for (size_t i = 0; i < block; i++) {
+            float p = phase(generator);
+            signal[k * block + i] = complex<float>(amplitude * cosf(p), amplitude * sinf(p));
+        }
+    }
+    double cycles = (double) T_BUFSIZE / (2.0 * rate);
+
+    struct {
+        const char* name;
+        float hysteresis;
+        unsigned int holdTime;
+    } gates[] = {
+        {"no hysteresis", 1.0f, 0},
+        {"2 dB hysteresis", powf(10.0f, 0.2f), 0},
+        {"2 dB hysteresis, 250 ms hold", powf(10.0f, 0.2f), (unsigned int) (rate * 0.25 / block)},
+    };
+    for (auto& gate: gates) {
+        auto squelch = new Squelch(1, [] (float power) {});
+        squelch->setSquelch(1.0f);
+        squelch->setHysteresis(gate.hysteresis);
+        squelch->setHoldTime(gate.holdTime);
+        auto reader = new MemoryReader<complex<float>>(signal, T_BUFSIZE);
+        auto writer = new GateWriter(T_BUFSIZE);
+        squelch->setReader(reader);
+        squelch->setWriter(writer);
+        while (squelch->canProcess()) squelch->process();
+        std::cerr << "squelch with " << gate.name << ": " << writer->transitions / cycles << " transitions per fading cycle\n";
+        delete squelch;
+        delete reader;
+        delete writer;
+    }
+    free(signal);
+}
+
+// keeps everything that has been written
+template <typename T>
+class CollectingWriter: public VoidWriter<T> {
+    public:
+        explicit CollectingWriter(size_t buffer_size): VoidWriter<T>(buffer_size) {}
+        void advance(size_t how_much) override {
+            T* data = this->getWritePointer();
+            collected.insert(collected.end(), data, data + how_much);
+        }
+        std::vector<T> collected;
+};
+
+void Benchmark::runTimingRecovery() {
+    // BPSK31 at 12 kS/s (integer samples per symbol) and at 11025 S/s (fractional), with the loop gain of the PSK
+    // demodulator
+    for (unsigned int rate: {12000, 11025}) {
+        auto recovery = new GardnerTimingRecovery(rate / 31.25f, 0.1f, 2.0f, true);
+        runModule("timing recovery BPSK31 at " + std::to_string(rate) + " S/s", recovery);
+        delete recovery;
+    }
+}
+
+void Benchmark::runPskDecoders() {
+    auto dbpsk = new DBPskDecoder();
+    runModule("dbpsk decoder", dbpsk);
+    delete dbpsk;
+    auto varicode = new VaricodeDecoder();
+    runModule("varicode decoder", varicode);
+    delete varicode;
+}
+
+void Benchmark::runCarrierRecovery() {
+    // a wide loop is updated on every sample, narrow ones once per block
+    for (float bandwidth: {0.01f, 0.0005f}) {
+        auto pll = new Pll(bandwidth);
+        runModule("pll, bandwidth " + std::to_string(bandwidth), pll);
+        delete pll;
+        auto costas = new CostasLoop(COSTAS_QPSK, bandwidth);
+        runModule("costas loop qpsk, bandwidth " + std::to_string(bandwidth), costas);
+        delete costas;
+    }
+}
+
+// picks the power of a few bins from every FFT frame, scaled like the output of GoertzelBank
+class BinPickingWriter: public VoidWriter<complex<float>> {
+    public:
+        BinPickingWriter(unsigned int fftSize, const std::vector<unsigned int>& bins):
+            VoidWriter<complex<float>>(fftSize * 2), bins(bins), scale(2.0f / ((float) fftSize * fftSize)) {}
+        void advance(size_t how_much) override {
+            complex<float>* frame = getWritePointer();
+            for (unsigned int bin: bins) {
+                collected.push_back(std::norm(frame[bin]) * scale);
+            }
+        }
+        std::vector<unsigned int> bins;
+        float scale;
+        std::vector<float> collected;
+};
+
+void Benchmark::runGoertzelBank() {
+    // tones on bin centers of a 1024 point FFT, so both methods measure exactly the same thing. the FFT input is
+    // converted to complex beforehand, the conversion is not part of the timing.
+    const unsigned int blockLength = 1024;
+    const size_t length = T_BUFSIZE;
+    std::minstd_rand generator;
+    std::normal_distribution<float> gauss(0.0f, 0.1f);
+    auto input = (float*) malloc(sizeof(float) * length);
+    auto input_c = (complex<float>*) malloc(sizeof(complex<float>) * length);
+    for (size_t i = 0; i < length; i++) {
+        input[i] = sinf(2 * M_PI * 17.0 / blockLength * i) + gauss(generator);
+        input_c[i] = complex<float>(input[i], 0.0f);
+    }
+    auto window = new BoxcarWindow();
+    struct ::timespec start_time, end_time;
+
+    for (unsigned int tones = 1; tones <= 64; tones *= 2) {
+        std::vector<unsigned int> bins;
+        std::vector<float> frequencies;
+        for (unsigned int t = 0; t < tones; t++) {
+            bins.push_back(17 + 7 * t);
+            frequencies.push_back((float) bins.back() / blockLength);
+        }
+
+        auto goertzel = new GoertzelBank(frequencies, blockLength);
+        auto reader = new MemoryReader<float>(input, length);
+        auto writer = new CollectingWriter<float>(tones);
+        goertzel->setReader(reader);
+        goertzel->setWriter(writer);
+        while (goertzel->canProcess()) goertzel->process();
+        std::vector<float> result = writer->collected;
+        delete writer;
+        auto counter = new CountingWriter<float>(tones);
+        goertzel->setWriter(counter);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N / 10; i++) {
+            reader->rewind();
+            while (goertzel->canProcess()) goertzel->process();
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double goertzelTime = timeTaken(start_time, end_time);
+        delete goertzel;
+        delete reader;
+        delete counter;
+
+        // Fft skips everyNSamples before its first frame, so frame n covers block n + 1
+        auto fft = new Fft<complex<float>>(blockLength, blockLength, window);
+        auto reader_c = new MemoryReader<complex<float>>(input_c, length);
+        auto picker = new BinPickingWriter(blockLength, bins);
+        fft->setReader(reader_c);
+        fft->setWriter(picker);
+        while (fft->canProcess()) fft->process();
+        // relative to the tone power (0.5)
+        double deviation = 0;
+        for (size_t i = 0; i < picker->collected.size() && i + tones < result.size(); i++) {
+            deviation = std::max(deviation, (double) std::fabs(result[i + tones] - picker->collected[i]) / 0.5);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < T_N / 10; i++) {
+            reader_c->rewind();
+            picker->collected.clear();
+            while (fft->canProcess()) fft->process();
+        }
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double fftTime = timeTaken(start_time, end_time);
+
+        std::cerr << "goertzel bank, " << tones << " tones: "
+                  << goertzelTime * 1E9 / ((double) T_N / 10 * length) << " ns per sample ("
+                  << fftTime * 1E9 / ((double) T_N / 10 * length) << " for fft " << blockLength << " + bin picking), "
+                  << "tone power " << result[0] << ", max deviation from fft " << deviation << "\n";
+
+        delete fft;
+        delete reader_c;
+        delete picker;
+    }
+
+    delete window;
+    free(input);
+    free(input_c);
+}
+
+// power of the signal remaining after removing the component at the given frequency (relative to the sample rate),
+// relative to the power of that component, in dB. the tests have a version for real signals in test/tone.hpp.
+static double toneResidual(complex<float>* signal, size_t size, double frequency) {
+    std::complex<double> amplitude = 0;
+    for (size_t i = 0; i < size; i++) {
+        amplitude += std::complex<double>(signal[i].i(), signal[i].q()) * std::polar(1.0, -2 * M_PI * frequency * i);
+    }
+    amplitude /= (double) size;
+    double tone = 0, residual = 0;
+    for (size_t i = 0; i < size; i++) {
+        std::complex<double> fit = amplitude * std::polar(1.0, 2 * M_PI * frequency * i);
+        tone += std::norm(fit);
+        residual += std::norm(std::complex<double>(signal[i].i(), signal[i].q()) - fit);
+    }
+    return 10 * log10(residual / tone);
+}
+
+void Benchmark::runAudioResampler() {
+    // the client audio chain resamples the demodulator output (12k, 24k or 48k) to the rate of the client's sound card.
+    // the input arrives in blocks of 20 ms.
+    std::vector<std::pair<unsigned int, unsigned int>> rates = {
+        {12000, 44100}, {12000, 48000}, {24000, 44100}, {48000, 44100}, {44100, 48000}
+    };
+    std::vector<std::pair<std::string, ResamplerQuality>> qualities = {
+        {"low", RESAMPLER_LOW}, {"medium", RESAMPLER_MEDIUM}, {"high", RESAMPLER_HIGH}
+    };
+    auto input = (float*) malloc(sizeof(float) * T_BUFSIZE);
+    auto output = (float*) malloc(sizeof(float) * T_BUFSIZE * 8);
+    for (int i = 0; i < T_BUFSIZE; i++) input[i] = 0.5 * sin(0.01 * i) + 0.25 * sin(0.2 * i);
+    struct ::timespec start_time, end_time;
+
+    // CPU time of one client, in % of a core
+    auto timeRealtime = [&] (double outputRate, std::function<size_t(float*, size_t, float*)> run) {
+        size_t outputs = 0;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (int i = 0; i < 10; i++) outputs += run(input, T_BUFSIZE, output);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        return timeTaken(start_time, end_time) / outputs * outputRate * 100;
+    };
+
+    for (auto r: rates) {
+        double inputRate = r.first, outputRate = r.second;
+        size_t block = r.first / 50;
+        for (auto q: qualities) {
+            auto run = [&] (float* in, size_t size, float* out) -> size_t {
+                auto resampler = new AudioResampler(r.first, r.second, q.second);
+                auto source = new Ringbuffer<float>(65536);
+                auto reader = new RingbufferReader<float>(source);
+                auto buffer = new Ringbuffer<float>(size * 8);
+                auto result = new RingbufferReader<float>(buffer);
+                resampler->setReader(reader);
+                resampler->setWriter(buffer);
+                for (size_t offset = 0; offset < size; offset += block) {
+                    size_t length = std::min(block, size - offset);
+                    std::memcpy(source->getWritePointer(), in + offset, sizeof(float) * length);
+                    source->advance(length);
+                    while (resampler->canProcess()) resampler->process();
+                }
+                size_t length = result->available();
+                std::memcpy(out, result->getReadPointer(), sizeof(float) * length);
+                delete result;
+                delete buffer;
+                delete reader;
+                delete source;
+                delete resampler;
+                return length;
+            };
+            double cpu = timeRealtime(outputRate, run);
+            std::cerr << "audio resampler " << r.first << " -> " << r.second << ", " << q.first << " quality: "
+                      << cpu << "% CPU per client\n";
+        }
+
+#ifdef CSDR_HAS_SAMPLERATE
+        auto run = [&] (float* in, size_t size, float* out) -> size_t {
+            int error = 0;
+            SRC_STATE* state = src_new(SRC_SINC_MEDIUM_QUALITY, 1, &error);
+            size_t produced = 0;
+            for (size_t offset = 0; offset < size; offset += block) {
+                SRC_DATA data = {};
+                data.data_in = in + offset;
+                data.data_out = out + produced;
+                data.input_frames = (long) std::min(block, size - offset);
+                data.output_frames = (long) (T_BUFSIZE * 8 - produced);
+                data.end_of_input = 0;
+                data.src_ratio = outputRate / inputRate;
+                src_process(state, &data);
+                produced += data.output_frames_gen;
+            }
+            src_delete(state);
+            return produced;
+        };
+        double cpu = timeRealtime(outputRate, run);
+        std::cerr << "audio resampler " << r.first << " -> " << r.second << ", libsamplerate medium quality: "
+                  << cpu << "% CPU per client\n";
+#endif
+    }
+
+    free(input);
+    free(output);
+}
+
+// the element by element conversions as they were in the Converter and in the connectors (no saturation).
+// u8 <-> s16 did not exist before, the reference goes through float.
+template <typename T, typename U>
+static U converterReference(T input);
+
+template <>
+float converterReference(unsigned char input) {
+    return ((float) input) / (UCHAR_MAX / 2.0f) - 1.0f;
+}
+
+template <>
+float converterReference(short input) {
+    return (float) input / SHRT_MAX;
+}
+
+template <>
+unsigned char converterReference(float input) {
+    return input * UCHAR_MAX * 0.5f + 128;
+}
+
+template <>
+short converterReference(float input) {
+    return input * SHRT_MAX;
+}
+
+template <>
+unsigned char converterReference(short input) {
+    return input / 32767.0f * 128.0f + 127.4f;
+}
+
+template <>
+short converterReference(unsigned char input) {
+    return converterReference<unsigned char, float>(input) * SHRT_MAX;
+}
+
+template <typename T, typename U>
+__attribute__((noinline, optimize("no-tree-vectorize")))
+static void convertScalar(const T* input, U* output, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = converterReference<T, U>(input[i]);
+    }
+}
+
+static void converterInput(unsigned char* data, size_t size, std::minstd_rand& generator) {
+    std::uniform_int_distribution<int> distribution(0, UCHAR_MAX);
+    for (size_t i = 0; i < size; i++) data[i] = distribution(generator);
+}
+
+static void converterInput(short* data, size_t size, std::minstd_rand& generator) {
+    std::uniform_int_distribution<int> distribution(SHRT_MIN, SHRT_MAX);
+    for (size_t i = 0; i < size; i++) data[i] = distribution(generator);
+}
+
+static void converterInput(float* data, size_t size, std::minstd_rand& generator) {
+    // within [-1, 1), where the previous conversions were defined
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < size; i++) data[i] = distribution(generator);
+}
+
+template <typename T, typename U>
+void Benchmark::runConverter(const std::string& name, bool isComplex) {
+    // complex samples are converted as pairs of their components, the same buffer just counts half the samples
+    size_t size = T_BUFSIZE * 2;
+    auto input = (T*) malloc(sizeof(T) * size);
+    auto output = (U*) malloc(sizeof(U) * size);
+    auto reference = (U*) malloc(sizeof(U) * size);
+    std::minstd_rand generator;
+    converterInput(input, size, generator);
+    struct ::timespec start_time, end_time;
+
+    convertScalar(input, reference, size);
+    if (isComplex) {
+        Converter<complex<T>, complex<U>>::convert((complex<T>*) input, (complex<U>*) output, size / 2);
+    } else {
+        Converter<T, U>::convert(input, output, size);
+    }
+    size_t mismatches = 0;
+    double maxError = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (output[i] != reference[i]) mismatches++;
+        maxError = std::max(maxError, std::fabs((double) output[i] - reference[i]));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < T_N; i++) convertScalar(input, output, size);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double scalar = timeTaken(start_time, end_time);
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    if (isComplex) {
+        for (int i = 0; i < T_N; i++) Converter<complex<T>, complex<U>>::convert((complex<T>*) input, (complex<U>*) output, size / 2);
+    } else {
+        for (int i = 0; i < T_N; i++) Converter<T, U>::convert(input, output, size);
+    }
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double fast = timeTaken(start_time, end_time);
+
+    double samples = (double) T_N * (isComplex ? size / 2 : size);
+    std::cerr << "convert " << name << ": "
+              << "scalar " << samples / scalar / 1E6 << " Msamples/s, "
+              << "vectorized " << samples / fast / 1E6 << " Msamples/s "
+              << "(speedup " << scalar / fast << ", " << mismatches << " of " << size << " values differ, max difference " << maxError << ")\n";
+
+    free(input);
+    free(output);
+    free(reference);
+}
+
+void Benchmark::runConverters() {
+    for (int isComplex = 0; isComplex <= 1; isComplex++) {
+        std::string prefix = isComplex ? "complex " : "";
+        runConverter<unsigned char, short>(prefix + "u8 -> s16", isComplex);
+        runConverter<unsigned char, float>(prefix + "u8 -> float", isComplex);
+        runConverter<short, unsigned char>(prefix + "s16 -> u8", isComplex);
+        runConverter<short, float>(prefix + "s16 -> float", isComplex);
+        runConverter<float, unsigned char>(prefix + "float -> u8", isComplex);
+        runConverter<float, short>(prefix + "float -> s16", isComplex);
+    }
+}
+
+// the Selector chain (Shift -> FirDecimate -> Bandpass) reading its input in format T. all of the input is processed,
+// the output of the bandpass is collected in output. returns the number of output samples.
+template <typename T>
+static size_t runSelector(T* input, size_t size, complex<float>* output, size_t outputSize, float shift, unsigned int decimation, float lowCut, float highCut) {
+    auto window = new HammingWindow();
+    Module<T, complex<float>>* shifter = new ShiftAddfast<T>(shift);
+    auto decimator = new FirDecimate<complex<float>>(decimation, 0.15f / decimation, window);
+    auto bandpass = new FilterModule<complex<float>>(new FftBandPassFilter(lowCut, highCut, 320.0f / 48000, window));
+    auto reader = new MemoryReader<T>(input, size);
+    auto shifted = new Ringbuffer<complex<float>>(65536);
+    auto decimated = new Ringbuffer<complex<float>>(65536);
+    auto filtered = new Ringbuffer<complex<float>>(65536);
+    auto result = new RingbufferReader<complex<float>>(filtered);
+    auto shiftedReader = new RingbufferReader<complex<float>>(shifted);
+    auto decimatedReader = new RingbufferReader<complex<float>>(decimated);
+    shifter->setReader(reader);
+    shifter->setWriter(shifted);
+    decimator->setReader(shiftedReader);
+    decimator->setWriter(decimated);
+    bandpass->setReader(decimatedReader);
+    bandpass->setWriter(filtered);
+
+    size_t length = 0;
+    bool busy = true;
+    while (busy) {
+        busy = false;
+        // ringbuffers don't block the writer, so every module only gets one step per round to avoid overruns
+        if (shifter->canProcess()) { shifter->process(); busy = true; }
+        if (decimator->canProcess()) { decimator->process(); busy = true; }
+        if (bandpass->canProcess()) { bandpass->process(); busy = true; }
+        size_t available = std::min(result->available(), outputSize - length);
+        std::memcpy(output + length, result->getReadPointer(), sizeof(complex<float>) * available);
+        result->advance(result->available());
+        length += available;
+    }
+
+    delete shifter;
+    delete decimator;
+    delete bandpass;
+    delete result;
+    delete decimatedReader;
+    delete shiftedReader;
+    delete filtered;
+    delete decimated;
+    delete shifted;
+    delete reader;
+    delete window;
+    return length;
+}
+
+// one second at 2.4 MS/s. the filters of the selector take a few hundred output samples to settle.
+#define TRANSPORT_SIZE 2400000
+#define TRANSPORT_SETTLE 1024
+
+template <typename T>
+static void transportConvert(complex<float>* input, T* output, size_t size) {
+    Converter<complex<float>, T>::convert(input, output, size);
+}
+
+static void transportConvert(complex<float>* input, complex<float>* output, size_t size) {
+    std::memcpy(output, input, sizeof(complex<float>) * size);
+}
+
+template <typename T>
+double Benchmark::runTransportFormat(const std::string& name, complex<float>* input, complex<float>* reference, size_t referenceLength, double frequency, double referenceSnr, double referenceTime) {
+    // 2.4 MS/s down to 48 kS/s, with the channel at +100 kHz and an 8 kHz wide bandpass
+    float shift = -100000.0f / 2400000;
+    unsigned int decimation = 50;
+    float lowCut = -4000.0f / 48000, highCut = 4000.0f / 48000;
+    auto converted = (T*) malloc(sizeof(T) * TRANSPORT_SIZE);
+    auto output = (complex<float>*) malloc(sizeof(complex<float>) * TRANSPORT_SIZE);
+    transportConvert(input, converted, TRANSPORT_SIZE);
+    struct ::timespec start_time, end_time;
+
+    size_t length = runSelector(converted, TRANSPORT_SIZE, output, TRANSPORT_SIZE, shift, decimation, lowCut, highCut);
+    double snr = -toneResidual(output + TRANSPORT_SETTLE, length - TRANSPORT_SETTLE, frequency);
+    double error = 0, power = 0;
+    for (size_t i = TRANSPORT_SETTLE; i < std::min(length, referenceLength); i++) {
+        error += std::norm(std::complex<float>(output[i]) - std::complex<float>(reference[i]));
+        power += std::norm(std::complex<float>(reference[i]));
+    }
+
+    int repetitions = 5;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < repetitions; i++) runSelector(converted, TRANSPORT_SIZE, output, TRANSPORT_SIZE, shift, decimation, lowCut, highCut);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double time = timeTaken(start_time, end_time) / ((double) repetitions * TRANSPORT_SIZE);
+
+    std::cerr << "selector with " << name << " input (" << sizeof(T) << " bytes per sample): "
+              << time * 1E9 << " ns per input sample";
+    if (referenceTime > 0) {
+        std::cerr << " (" << referenceTime / time << "x of float), "
+                  << "snr " << snr << " dB (loss " << referenceSnr - snr << " dB), "
+                  << "difference to float output " << 10 * log10(error / power) << " dB";
+    } else {
+        std::cerr << ", snr " << snr << " dB";
+    }
+    std::cerr << "\n";
+
+    free(converted);
+    free(output);
+    return time;
+}
+
+void Benchmark::runTransportFormats() {
+    // a strong carrier at -10 dBFS, a tone at -80 dBFS in the selected channel and noise at -90 dBFS (per sample), like a
+    // 16 bit SDR would deliver it at 2.4 MS/s.
+    auto input = (complex<float>*) malloc(sizeof(complex<float>) * TRANSPORT_SIZE);
+    auto reference = (complex<float>*) malloc(sizeof(complex<float>) * TRANSPORT_SIZE);
+    std::minstd_rand generator;
+    std::normal_distribution<float> noise(0.0f, 3E-5f / sqrt(2));
+    double carrier = -300000.0 / 2400000, tone = 101000.0 / 2400000;
+    for (size_t i = 0; i < TRANSPORT_SIZE; i++) {
+        std::complex<double> sample = 0.316 * std::polar(1.0, 2 * M_PI * carrier * i) + 1E-4 * std::polar(1.0, 2 * M_PI * tone * i);
+        input[i] = { (float) sample.real() + noise(generator), (float) sample.imag() + noise(generator) };
+    }
+    // the tone ends up at 1 kHz in the 48 kS/s output
+    double frequency = 1000.0 / 48000;
+
+    size_t length = runSelector(input, TRANSPORT_SIZE, reference, TRANSPORT_SIZE, -100000.0f / 2400000, 50, -4000.0f / 48000, 4000.0f / 48000);
+    double snr = -toneResidual(reference + TRANSPORT_SETTLE, length - TRANSPORT_SETTLE, frequency);
+    double time = runTransportFormat<complex<float>>("complex<float>", input, reference, length, frequency, snr, 0);
+    runTransportFormat<complex<short>>("complex<short>", input, reference, length, frequency, snr, time);
+    runTransportFormat<complex<half>>("complex<half>", input, reference, length, frequency, snr, time);
+
+    free(input);
+    free(reference);
+}
+
+// modules connected by ringbuffers. ringbuffers don't block the writer, so every module only gets one step per round.
+class BenchmarkChain {
+    public:
+        ~BenchmarkChain() {
+            for (auto module: modules) delete module;
+            for (auto& release: resources) release();
+        }
+        template <typename T, typename U, typename V>
+        void connect(Module<T, U>* from, Module<U, V>* to) {
+            auto buffer = new Ringbuffer<U>(32768);
+            auto reader = new RingbufferReader<U>(buffer);
+            from->setWriter(buffer);
+            to->setReader(reader);
+            resources.push_back([buffer, reader] { delete reader; delete buffer; });
+        }
+        void add(UntypedModule* module) {
+            modules.push_back(module);
+        }
+        template <typename T>
+        T* own(T* resource) {
+            resources.push_back([resource] { delete resource; });
+            return resource;
+        }
+        bool step() {
+            bool busy = false;
+            for (auto module: modules) {
+                if (module->canProcess()) {
+                    module->process();
+                    busy = true;
+                }
+            }
+            return busy;
+        }
+    private:
+        std::vector<UntypedModule*> modules;
+        std::vector<std::function<void()>> resources;
+};
+
+void Benchmark::runIdleListeners() {
+    // 50 users listening to nfm channels of a 2.4 MS/s receiver with the squelch closed: the selector (Shift ->
+    // FirDecimate -> Bandpass down to 12 kS/s) followed by the nfm demodulator (FmDemod -> Limit -> NfmDeemphasis -> Agc).
+    // the SquelchGate is either placed behind the selector (where the Squelch module has to be) or in front of it
+    // (possible when the squelch is driven by a BandPowerTap).
+    const unsigned int listeners = 50;
+    const unsigned int decimation = 200;
+    const size_t size = 2400000;
+    auto input = (complex<float>*) malloc(sizeof(complex<float>) * size);
+    std::minstd_rand generator;
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (size_t i = 0; i < size; i++) input[i] = { noise(generator), noise(generator) };
+    auto window = new HammingWindow();
+    struct ::timespec start_time, end_time;
+
+    for (bool gateFirst: {false, true}) {
+        std::vector<BenchmarkChain*> chains;
+        std::vector<MemoryReader<complex<float>>*> readers;
+        for (unsigned int i = 0; i < listeners; i++) {
+            auto chain = new BenchmarkChain();
+            auto gate = new SquelchGate(gateFirst ? 5120 * decimation : 5120);
+            gate->setOpen(false);
+            Module<complex<float>, complex<float>>* shift = new ShiftAddfast<complex<float>>(-0.1f + 0.002f * i);
+            auto decimator = new FirDecimate<complex<float>>(decimation, 0.15f / decimation, window);
+            auto bandpass = new FilterModule<complex<float>>(new FftBandPassFilter(-4000.0f / 12000, 4000.0f / 12000, 320.0f / 12000, window));
+            auto demod = new FmDemod();
+            auto limit = new Limit(1.0f);
+            auto deemphasis = new NfmDeephasis(12000);
+            auto agc = new Agc<float>();
+
+            std::vector<Module<complex<float>, complex<float>>*> selector;
+            if (gateFirst) {
+                selector = {gate, shift, decimator, bandpass};
+            } else {
+                selector = {shift, decimator, bandpass, gate};
+            }
+            auto reader = chain->own(new MemoryReader<complex<float>>(input, size));
+            selector[0]->setReader(reader);
+            for (size_t k = 0; k < selector.size() - 1; k++) chain->connect(selector[k], selector[k + 1]);
+            chain->connect(selector.back(), demod);
+            chain->connect(demod, limit);
+            chain->connect(limit, deemphasis);
+            chain->connect(deemphasis, agc);
+            agc->setWriter(chain->own(new VoidWriter<float>(32768)));
+            for (auto module: selector) chain->add(module);
+            chain->add(demod);
+            chain->add(limit);
+            chain->add(deemphasis);
+            chain->add(agc);
+
+            chains.push_back(chain);
+            readers.push_back(reader);
+        }
+
+        // the first second contains the flush after the gate was closed, only the second one is measured
+        for (auto chain: chains) while (chain->step());
+        for (auto reader: readers) reader->rewind();
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        for (auto chain: chains) while (chain->step());
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        double time = timeTaken(start_time, end_time);
+
+        std::cerr << listeners << " idle nfm listeners, squelch gate " << (gateFirst ? "in front of" : "behind")
+                  << " the selector: " << time * 100 << "% of a core\n";
+
+        for (auto chain: chains) delete chain;
+    }
+
+    delete window;
+    free(input);
+}
+
+void Benchmark::runTapCache() {
+    // 50 clients on the same profile: every one of them builds a selector (decimation from 2.4 MS/s, channel bandpass,
+    // fractional decimation), a waterfall and the resampler for its sound card. with the cache, only the first one
+    // designs the filters.
+    int clients = 50;
+    struct ::timespec start_time, end_time;
+    std::vector<UntypedModule*> modules;
+    auto window = new HammingWindow();
+    auto design = new RemezTapGenerator(0.25f, 320.0f / 48000, 0.1f, 60.0f);
+    size_t entries = TapCache::getEntries(), bytes = TapCache::getMemoryUsage();
+    size_t uncached = 0;
+    double first = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (int i = 0; i < clients; i++) {
+        modules.push_back(new FirDecimate<complex<float>>(50, 0.15f / 50, window));
+        modules.push_back(new FilterModule<complex<float>>(new FftBandPassFilter(-4000.0f / 48000, 4000.0f / 48000, design)));
+        modules.push_back(new WaterfallEngine<unsigned char>(8192, 2400000 / 10, 0, 0, window, 1, PYRAMID_MAX, 4));
+        modules.push_back(new FractionalDecimator<complex<float>>(2400000.0f / 50 / 44100));
+        modules.push_back(new AudioResampler(12000, 44100));
+        if (i == 0) {
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            first = timeTaken(start_time, end_time);
+            uncached = TapCache::getMemoryUsage() - bytes;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double others = timeTaken(start_time, end_time) / (clients - 1);
+
+    std::cerr << "tap cache with " << clients << " clients: " << TapCache::getEntries() - entries << " arrays, "
+              << (TapCache::getMemoryUsage() - bytes) / 1024 << " kB shared (" << uncached * clients / 1024
+              << " kB without the cache), setup " << first * 1E3 << " ms for the first client, "
+              << others * 1E3 << " ms for every other\n";
+
+    for (auto module: modules) delete module;
+    delete design;
+    delete window;
+}
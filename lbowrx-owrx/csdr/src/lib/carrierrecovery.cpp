@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "carrierrecovery.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace Csdr;
+
+static float wrapPhase(float phase) {
+    return phase - 2.0f * (float) M_PI * rintf(phase / (2.0f * (float) M_PI));
+}
+
+// input * exp(-j * (phase + k * frequency)). sine and cosine are polynomials around the nearest multiple of pi / 2,
+// which vectorizes (the libm functions don't). the error is below 1e-6 while the phase stays within a few turns.
+CSDR_TARGET_CLONES
+static void mix(const float* __restrict input, float* __restrict output, unsigned int size, float phase, float frequency) {
+    for (unsigned int k = 0; k < size; k++) {
+        float x = phase + k * frequency;
+        float qf = rintf(x * (float) M_2_PI);
+        int q = (int) qf;
+        float r = x - qf * (float) M_PI_2;
+        float r2 = r * r;
+        float sr = r * (1.0f + r2 * (-1.0f / 6 + r2 * (1.0f / 120 + r2 * (-1.0f / 5040))));
+        float cr = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24 + r2 * (-1.0f / 720 + r2 * (1.0f / 40320))));
+        float s = (q & 1) ? cr : sr;
+        float c = (q & 1) ? sr : cr;
+        s = (q & 2) ? -s : s;
+        c = ((q + 1) & 2) ? -c : c;
+        output[2 * k] = input[2 * k] * c + input[2 * k + 1] * s;
+        output[2 * k + 1] = input[2 * k + 1] * c - input[2 * k] * s;
+    }
+}
+
+// phase of the sample (sine, normalized)
+CSDR_TARGET_CLONES
+static float pllErrorSum(const float* __restrict input, unsigned int size) {
+    float sum = 0.0f;
+    for (unsigned int k = 0; k < size; k++) {
+        float i = input[2 * k], q = input[2 * k + 1];
+        float n = i * i + q * q;
+        sum += n > 0.0f ? q / sqrtf(n) : 0.0f;
+    }
+    return sum;
+}
+
+// i * q, normalized: half the sine of twice the phase, so the data sign doesn't matter
+CSDR_TARGET_CLONES
+static float bpskErrorSum(const float* __restrict input, unsigned int size) {
+    float sum = 0.0f;
+    for (unsigned int k = 0; k < size; k++) {
+        float i = input[2 * k], q = input[2 * k + 1];
+        float n = i * i + q * q;
+        sum += n > 0.0f ? i * q / n : 0.0f;
+    }
+    return sum;
+}
+
+// the usual QPSK detector sign(i) * q - sign(q) * i, normalized
+CSDR_TARGET_CLONES
+static float qpskErrorSum(const float* __restrict input, unsigned int size) {
+    float sum = 0.0f;
+    for (unsigned int k = 0; k < size; k++) {
+        float i = input[2 * k], q = input[2 * k + 1];
+        float n = i * i + q * q;
+        sum += n > 0.0f ? (copysignf(1.0f, i) * q - copysignf(1.0f, q) * i) / sqrtf(2.0f * n) : 0.0f;
+    }
+    return sum;
+}
+
+CarrierRecovery::CarrierRecovery(float bandwidth, float damping) {
+    setLoopParameters(bandwidth, damping);
+}
+
+void CarrierRecovery::setLoopParameters(float bandwidth, float damping) {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    // keep the loop bandwidth below 1% of the update rate
+    blockLength = 1;
+    while (blockLength < MAX_BLOCK_LENGTH && bandwidth * blockLength * 2 <= 0.01f) blockLength *= 2;
+
+    // the gains of the loop running at the block rate
+    // based on: http://gnuradio.squarespace.com/blog/2011/8/13/control-loop-gain-values.html
+    float bandwidth_omega = 2.0f * (float) M_PI * bandwidth * blockLength;
+    float denominator = 1.0f + 2.0f * damping * bandwidth_omega + bandwidth_omega * bandwidth_omega;
+    alpha = (4.0f * damping * bandwidth_omega) / denominator;
+    beta = (4.0f * bandwidth_omega * bandwidth_omega) / denominator;
+
+    blockFill = 0;
+    errorSum = 0.0f;
+}
+
+float CarrierRecovery::getFrequency() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    return frequency / (2.0f * (float) M_PI);
+}
+
+float CarrierRecovery::getPhase() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    return phase;
+}
+
+void CarrierRecovery::process(complex<float>* input, complex<float>* output, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        auto length = (unsigned int) std::min((size_t) (blockLength - blockFill), size - i);
+        mix((float*) (input + i), (float*) (output + i), length, phase, frequency);
+        errorSum += getErrorSum(output + i, length);
+        phase = wrapPhase(phase + length * frequency);
+        blockFill += length;
+        i += length;
+
+        if (blockFill == blockLength) {
+            float error = errorSum / blockLength;
+            phase = wrapPhase(phase + alpha * error);
+            frequency += beta * error / blockLength;
+            frequency = std::max(-(float) M_PI, std::min((float) M_PI, frequency));
+            blockFill = 0;
+            errorSum = 0.0f;
+        }
+    }
+
+    // a NaN would never leave the state
+    if (std::isnan(phase) || std::isnan(frequency)) {
+        phase = 0.0f;
+        frequency = 0.0f;
+    }
+}
+
+Pll::Pll(float bandwidth, float damping): CarrierRecovery(bandwidth, damping) {}
+
+float Pll::getErrorSum(complex<float>* output, size_t size) {
+    return pllErrorSum((float*) output, size);
+}
+
+CostasLoop::CostasLoop(CostasMode mode, float bandwidth, float damping): CarrierRecovery(bandwidth, damping), mode(mode) {}
+
+float CostasLoop::getErrorSum(complex<float>* output, size_t size) {
+    if (mode == COSTAS_QPSK) {
+        return qpskErrorSum((float*) output, size);
+    }
+    return bpskErrorSum((float*) output, size);
+}
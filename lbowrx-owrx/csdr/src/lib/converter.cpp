@@ -19,33 +19,65 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "converter.hpp"
 #include "complex.hpp"
-
-#include <climits>
+#include "fmv.h"
 
 using namespace Csdr;
 
-template <> void Converter<float, short>::process(float* input, short* output, size_t length) {
-    for (int i = 0; i < length; i++) {
-         output[i] = input[i] * SHRT_MAX;
+// complex samples are converted as interleaved pairs of their components
+template <typename T>
+struct ConverterSample {
+    typedef T type;
+    static const size_t components = 1;
+};
+
+template <typename T>
+struct ConverterSample<complex<T>> {
+    typedef T type;
+    static const size_t components = 2;
+};
+
+template <typename T, typename U>
+CSDR_TARGET_CLONES
+static void convertSamples(const T* __restrict__ input, U* __restrict__ output, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        output[i] = convertSample<T, U>(input[i]);
     }
 }
 
-template <> void Converter<short, float>::process(short* input, float* output, size_t length) {
-    for (int i = 0; i < length; i++) {
-        output[i] = (float) input[i] / SHRT_MAX;
-    }
+template <typename T, typename U>
+void Converter<T, U>::convert(const T* input, U* output, size_t length) {
+    static_assert(ConverterSample<T>::components == ConverterSample<U>::components, "cannot convert between real and complex samples");
+    convertSamples(
+        (const typename ConverterSample<T>::type*) input,
+        (typename ConverterSample<U>::type*) output,
+        length * ConverterSample<T>::components
+    );
 }
 
-template <>
-void Converter<complex<float>, complex<short>>::process(complex<float> *input, complex<short> *output, size_t length) {
-    for (int i = 0; i < length * 2; i++) {
-        ((short*) output)[i] = ((float*) input)[i] * SHRT_MAX;
-    }
+template <typename T, typename U>
+void Converter<T, U>::process(T* input, U* output, size_t length) {
+    convert(input, output, length);
 }
 
-template <>
-void Converter<complex<short>, complex<float>>::process(complex<short> *input, complex<float>* output, size_t length) {
-    for (int i = 0; i < length * 2; i++) {
-        ((float*) output)[i] = (float) ((short*) input)[i] / SHRT_MAX;
-    }
-}
\ No newline at end of file
+namespace Csdr {
+    template class Converter<unsigned char, short>;
+    template class Converter<unsigned char, float>;
+    template class Converter<short, unsigned char>;
+    template class Converter<short, float>;
+    template class Converter<float, unsigned char>;
+    template class Converter<float, short>;
+
+    template class Converter<complex<unsigned char>, complex<short>>;
+    template class Converter<complex<unsigned char>, complex<float>>;
+    template class Converter<complex<short>, complex<unsigned char>>;
+    template class Converter<complex<short>, complex<float>>;
+    template class Converter<complex<float>, complex<unsigned char>>;
+    template class Converter<complex<float>, complex<short>>;
+
+    template class Converter<complex<unsigned char>, complex<half>>;
+    template class Converter<complex<short>, complex<half>>;
+    template class Converter<complex<float>, complex<half>>;
+    template class Converter<complex<half>, complex<unsigned char>>;
+    template class Converter<complex<half>, complex<short>>;
+    template class Converter<complex<half>, complex<float>>;
+}
@@ -30,22 +30,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "dbpsk.hpp"
-#include <cmath>
 
 using namespace Csdr;
 
 void DBPskDecoder::process(complex<float> *input, unsigned char *output, size_t size) {
     for (size_t i = 0; i < size; i++) {
-        float phase = std::arg(input[i]);
-        if (std::isnan(phase)) phase = 0.0f;
-        float dphase = phase - last_phase;
-        while (dphase < -M_PI) dphase += 2 * M_PI;
-        while (dphase >= M_PI) dphase -= 2 * M_PI;
-        if (dphase > (M_PI / 2) || dphase < (-M_PI / 2)) {
-            output[i] = 0;
-        } else {
-            output[i] = 1;
-        }
-        last_phase = phase;
+        complex<float> sample = input[i];
+        // the phase of these used to be taken as 0
+        if (!(std::norm(sample) > 0.0f)) sample = complex<float>(1.0f, 0.0f);
+        // the real part of sample * conj(last) has the sign of the cosine of the phase difference:
+        // a phase change of more than 90 degrees is a 0
+        float dot = sample.i() * last.i() + sample.q() * last.q();
+        output[i] = dot >= 0.0f;
+        last = sample;
     }
 }
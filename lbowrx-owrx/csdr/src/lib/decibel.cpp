@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "decibel.hpp"
+#include "fmv.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace Csdr;
+
+// 10 * log10(2)
+#define DB_PER_OCTAVE 3.0102999566f
+
+// log2() approximation that the compiler can vectorize:
+// x = 2^e * m with m in [2/3, 4/3), and log2(m) = log2(1 + t) approximated by a degree 5 polynomial
+static inline float fastLog2(float x) {
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(float));
+    // 0x3f2aaaab is 2/3; subtracting it before extracting the exponent centers the mantissa around 1
+    int32_t e = (bits - 0x3f2aaaab) >> 23;
+    bits -= e << 23;
+    float m;
+    std::memcpy(&m, &bits, sizeof(float));
+    float t = m - 1.0f;
+    float p = 0.33359017849728884f;
+    p = p * t - 0.40195172835363124f;
+    p = p * t + 0.47829799056793015f;
+    p = p * t - 0.71986701983926900f;
+    p = p * t + 1.44273185903214960f;
+    return p * t + (float) e;
+}
+
+CSDR_TARGET_CLONES
+void Csdr::powerToDb(const float* input, float* output, size_t size, float offset) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = DB_PER_OCTAVE * fastLog2(input[i]) + offset;
+    }
+}
+
+CSDR_TARGET_CLONES
+void Csdr::complexToDb(const complex<float>* input, float* output, size_t size, float offset) {
+    for (size_t i = 0; i < size; i++) {
+        float power = input[i].i() * input[i].i() + input[i].q() * input[i].q();
+        output[i] = DB_PER_OCTAVE * fastLog2(power) + offset;
+    }
+}
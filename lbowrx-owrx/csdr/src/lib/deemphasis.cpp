@@ -30,13 +30,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "deemphasis.hpp"
-#include "predefined.h"
 
 #include <cmath>
+#include <complex>
+#include <algorithm>
 
 using namespace Csdr;
 
-WfmDeemphasis::WfmDeemphasis(unsigned int sampleRate, float tau): dt(1.0f / sampleRate), alpha(dt / tau + dt) {}
+WfmDeemphasis::WfmDeemphasis(unsigned int sampleRate, float tau): dt(1.0f / sampleRate), alpha(dt / tau + dt), iir(alpha, 1 - alpha) {}
 
 void WfmDeemphasis::process(float *input, float *output, size_t size) {
     /*
@@ -46,28 +47,82 @@ void WfmDeemphasis::process(float *input, float *output, size_t size) {
         More info at: http://www.cliftonlaboratories.com/fm_receivers_and_de-emphasis.htm
         Simulate in octave: tau=75e-6; dt=1/48000; alpha = dt/(tau+dt); freqz([alpha],[1 -(1-alpha)])
     */
-    if (std::isnan(last_output)) last_output = 0.0;
-    for (int i = 0; i < size; i++) {
-        output[i] = last_output = alpha * input[i] + (1 - alpha) * last_output; //this is the simplest IIR LPF
+    iir.process(input, output, size); //this is the simplest IIR LPF
+}
+
+NfmDeephasis::NfmDeephasis(unsigned int sampleRate): sampleRate(sampleRate) {
+    // 4th order butterworth highpass
+    sections[0] = bilinear(300, 300, 0, 0, 1, 1, 2 * sin(M_PI / 8), 1);
+    sections[1] = bilinear(300, 300, 0, 0, 1, 1, 2 * sin(3 * M_PI / 8), 1);
+    // -6 dB per octave
+    sections[2] = bilinear(1200, 1200, 1, 0, 0, 1, 1, 0);
+    // 6th order butterworth lowpass. prewarped at the edge of the passband, where the bilinear transform would
+    // otherwise bend the slope the most at low sample rates.
+    for (unsigned int k = 0; k < 3; k++) {
+        sections[3 + k] = bilinear(3100, 3500, 1, 0, 0, 1, 2 * sin((2 * k + 1) * M_PI / 12), 1);
+    }
+
+    float gain = (float) (1 / getGain(500));
+    sections[0].b0 *= gain;
+    sections[0].b1 *= gain;
+    sections[0].b2 *= gain;
+}
+
+NfmDeephasis::Section NfmDeephasis::bilinear(double frequency, double prewarp, double n0, double n1, double n2, double d0, double d1, double d2) {
+    // frequencies close to nyquist can't be prewarped, at low sample rates they are moved down
+    prewarp = std::min(prewarp, 0.45 * sampleRate);
+    double k = tan(M_PI * prewarp / sampleRate) * frequency / prewarp;
+    Section section;
+    if (n2 == 0 && d2 == 0) {
+        // first order sections must not be expanded to second order, that would place a pole at nyquist
+        double a0 = d0 * k + d1;
+        section.b0 = (float) ((n0 * k + n1) / a0);
+        section.b1 = (float) ((n0 * k - n1) / a0);
+        section.b2 = 0.0f;
+        section.a1 = (float) ((d0 * k - d1) / a0);
+        section.a2 = 0.0f;
+    } else {
+        double a0 = d0 * k * k + d1 * k + d2;
+        section.b0 = (float) ((n0 * k * k + n1 * k + n2) / a0);
+        section.b1 = (float) ((2 * n0 * k * k - 2 * n2) / a0);
+        section.b2 = (float) ((n0 * k * k - n1 * k + n2) / a0);
+        section.a1 = (float) ((2 * d0 * k * k - 2 * d2) / a0);
+        section.a2 = (float) ((d0 * k * k - d1 * k + d2) / a0);
     }
+    return section;
 }
 
-NfmDeephasis::NfmDeephasis(unsigned int sampleRate): FilterModule<float>(getFilter(sampleRate)) {}
+double NfmDeephasis::getGain(double frequency) {
+    std::complex<double> z1 = std::polar(1.0, -2 * M_PI * frequency / sampleRate);
+    std::complex<double> z2 = z1 * z1;
+    std::complex<double> h = 1;
+    for (auto& s: sections) {
+        h *= ((double) s.b0 + (double) s.b1 * z1 + (double) s.b2 * z2) / (1.0 + (double) s.a1 * z1 + (double) s.a2 * z2);
+    }
+    return std::abs(h);
+}
 
-FirFilter<float, float>* NfmDeephasis::getFilter(unsigned int sampleRate) {
-    switch (sampleRate) {
-        // we only cover selected sample rates. see predefined.h for details.
-        case 8000:
-            return new FirFilter<float, float>(deemphasis_nfm_predefined_fir_8000, 79);
-        case 11025:
-            return new FirFilter<float, float>(deemphasis_nfm_predefined_fir_11025, 79);
-        case 12000:
-            return new FirFilter<float, float>(deemphasis_nfm_predefined_fir_12000, 79);
-        case 44100:
-            return new FirFilter<float, float>(deemphasis_nfm_predefined_fir_44100, 199);
-        case 48000:
-            return new FirFilter<float, float>(deemphasis_nfm_predefined_fir_48000, 199);
-        default:
-            throw std::runtime_error("invalid sample rate");
+void NfmDeephasis::process(float* input, float* output, size_t size) {
+    // transposed direct form II. every sample passes all sections before the next one is started, so the recursions
+    // of the sections can overlap. the local copy keeps the state in registers.
+    Section s[SECTIONS];
+    std::copy(sections, sections + SECTIONS, s);
+    for (size_t i = 0; i < size; i++) {
+        float x = input[i];
+        for (unsigned int k = 0; k < SECTIONS; k++) {
+            float y = s[k].b0 * x + s[k].z1;
+            s[k].z1 = s[k].b1 * x - s[k].a1 * y + s[k].z2;
+            s[k].z2 = s[k].b2 * x - s[k].a2 * y;
+            x = y;
+        }
+        output[i] = x;
     }
-}
\ No newline at end of file
+    for (unsigned int k = 0; k < SECTIONS; k++) {
+        // the state decays into denormals on silence, which is slow on most CPUs. NaNs would never go away.
+        if (std::isnan(s[k].z1) || std::isnan(s[k].z2) || (std::fabs(s[k].z1) < 1E-30f && std::fabs(s[k].z2) < 1E-30f)) {
+            s[k].z1 = 0.0f;
+            s[k].z2 = 0.0f;
+        }
+        sections[k] = s[k];
+    }
+}
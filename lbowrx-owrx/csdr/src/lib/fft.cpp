@@ -18,63 +18,102 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "fft.hpp"
+#include "fftplanner.hpp"
+#include "half.hpp"
 
 #include <cstring>
+#include <utility>
 
 using namespace Csdr;
 
-Fft::Fft(unsigned int fftSize, unsigned int everyNSamples, Window* window): fftSize(fftSize), everyNSamples(everyNSamples) {
+template <typename T>
+Fft<T>::Fft(unsigned int fftSize, unsigned int everyNSamples, Window* window, unsigned int threads): fftSize(fftSize), everyNSamples(everyNSamples) {
     windowed = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
     output_buffer = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
-    plan = fftwf_plan_dft_1d(fftSize, (fftwf_complex*) windowed, (fftwf_complex*) output_buffer, FFTW_FORWARD, FFTW_ESTIMATE);
+    plan = FftPlanner::planDft(fftSize, windowed, output_buffer, threads);
+    HammingWindow defaultWindow;
+    if (window == nullptr) window = &defaultWindow;
     this->window = window->precalculate(fftSize);
 }
 
-Fft::~Fft() {
+template <typename T>
+Fft<T>::~Fft() {
     free(windowed);
     free(output_buffer);
     delete window;
-    fftwf_destroy_plan(plan);
+    FftPlanner::destroy(plan);
 }
 
-bool Fft::canProcess() {
+template <typename T>
+bool Fft<T>::canProcess() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    return std::min(reader->available(), writer->writeable()) > fftSize;
+    return std::min(this->reader->available(), this->writer->writeable()) > fftSize;
 }
 
-void Fft::process() {
-    std::lock_guard<std::mutex> lock(processMutex);
-    size_t available = reader->available();
+template <typename T>
+void Fft<T>::process() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    size_t available = this->reader->available();
     if (skipped + available >= everyNSamples) {
         // start of next fft is in range
         if (everyNSamples > skipped) {
             // move forward to the beginning (align)
             unsigned int toSkip = everyNSamples - skipped;
-            reader->advance(toSkip);
+            this->reader->advance(toSkip);
             skipped += toSkip;
             available -= toSkip;
         }
 
         // do we still have enough data for an fft now?
         if (available >= fftSize) {
-            if (window != nullptr) {
-                window->apply(reader->getReadPointer(), windowed, fftSize);
-            } else {
-                memcpy(windowed, reader->getReadPointer(), fftSize);
-            }
+            // the window also converts the input to complex<float>
+            window->apply(this->reader->getReadPointer(), windowed, fftSize);
             fftwf_execute(plan);
-            std::memcpy(writer->getWritePointer(), output_buffer, sizeof(complex<float>) * fftSize);
-            writer->advance(fftSize);
+            if (powerTap != nullptr) {
+                powerTap->measure(output_buffer, fftSize, fftSize * window->getPower());
+            }
+            std::memcpy(this->writer->getWritePointer(), output_buffer, sizeof(complex<float>) * fftSize);
+            this->writer->advance(fftSize);
 
             skipped = 0;
         }
     } else {
         // drop data
-        reader->advance(available);
+        this->reader->advance(available);
         skipped += available;
     }
 }
 
-void Fft::setEveryNSamples(unsigned int everyNSamples) {
+template <typename T>
+void Fft<T>::setEveryNSamples(unsigned int everyNSamples) {
     this->everyNSamples = everyNSamples;
 }
+
+template <typename T>
+void Fft<T>::setPowerTap(BandPowerTap* powerTap) {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    this->powerTap = powerTap;
+}
+
+template <typename T>
+void Fft<T>::setThreads(unsigned int threads) {
+    // measuring a large plan takes a while, so it is made on new buffers while processing continues
+    auto newWindowed = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    auto newOutput = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    fftwf_plan newPlan = FftPlanner::planDft(fftSize, newWindowed, newOutput, threads);
+    {
+        std::lock_guard<std::mutex> lock(this->processMutex);
+        std::swap(plan, newPlan);
+        std::swap(windowed, newWindowed);
+        std::swap(output_buffer, newOutput);
+    }
+    FftPlanner::destroy(newPlan);
+    free(newWindowed);
+    free(newOutput);
+}
+
+namespace Csdr {
+    template class Fft<complex<float>>;
+    template class Fft<complex<short>>;
+    template class Fft<complex<half>>;
+}
@@ -0,0 +1,213 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "fftdelta.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+using namespace Csdr;
+
+// MSB-first bit writer, individual writes must not exceed 24 bits.
+// every write stores 8 bytes unconditionally (no unpredictable flush branch), so the output needs some slack.
+#define BIT_WRITER_SLACK 8
+class BitWriter {
+    public:
+        explicit BitWriter(unsigned char* output): output(output) {}
+        void write(uint32_t value, unsigned int bits) {
+            acc = (acc << bits) | (value & ((1u << bits) - 1));
+            count += bits;
+            uint64_t aligned = __builtin_bswap64(acc << (64 - count));
+            memcpy(output + pos, &aligned, sizeof(aligned));
+            pos += count >> 3;
+            count &= 7;
+        }
+        size_t finish() {
+            return pos + (count > 0);
+        }
+    private:
+        unsigned char* output;
+        size_t pos = 0;
+        uint64_t acc = 0;
+        unsigned int count = 0;
+};
+
+// quotients from this value on are escaped, the value is then sent as 8 raw bits
+#define RICE_ESCAPE 15
+
+// approximate size of a Rice coded block in bits, ignoring escapes
+static inline unsigned int riceEstimate(unsigned int sum, unsigned int length, unsigned int k) {
+    return length * (k + 1) + (sum >> k);
+}
+
+static inline void riceWrite(BitWriter& writer, unsigned int value, unsigned int k) {
+    unsigned int q = value >> k;
+    if (q < RICE_ESCAPE) {
+        // q ones terminated by a zero, then k bits of remainder
+        writer.write((((1u << (q + 1)) - 2) << k) | (value & ((1u << k) - 1)), q + 1 + k);
+    } else {
+        writer.write((1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+        writer.write(value, 8);
+    }
+}
+
+// residuals are taken modulo 256 and mapped to 0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...
+static inline unsigned char zigzag(unsigned char actual, unsigned char prediction) {
+    int residual = (int8_t) (unsigned char) (actual - prediction);
+    // branchless, the sign of noise residuals is unpredictable
+    return (unsigned char) ((residual << 1) ^ (residual >> 31));
+}
+
+// pick the Rice parameter from the mean of the block: the optimum is close to log2(mean)
+static inline unsigned int riceParameter(unsigned int sum, unsigned int length) {
+    unsigned int k = 0;
+    while (k < 7 && (length << (k + 1)) <= sum) k++;
+    return k;
+}
+
+static void writeLe16(unsigned char* output, uint16_t value) {
+    output[0] = value & 0xFF;
+    output[1] = value >> 8;
+}
+
+static void writeLe32(unsigned char* output, uint32_t value) {
+    for (int i = 0; i < 4; i++) output[i] = (value >> (8 * i)) & 0xFF;
+}
+
+FftDeltaCodec::FftDeltaCodec(unsigned int fftSize, int floor, unsigned int range, unsigned int keyframeInterval):
+    fftSize(fftSize),
+    floor(floor),
+    range(std::max(range, 1u)),
+    keyframeInterval(keyframeInterval)
+{
+    current = (unsigned char*) malloc(fftSize);
+    previous = (unsigned char*) malloc(fftSize);
+    spatial = (unsigned char*) malloc(fftSize);
+    temporal = (unsigned char*) malloc(fftSize);
+}
+
+FftDeltaCodec::~FftDeltaCodec() {
+    free(current);
+    free(previous);
+    free(spatial);
+    free(temporal);
+}
+
+void FftDeltaCodec::reset() {
+    hasPrevious = false;
+}
+
+size_t FftDeltaCodec::maxEncodedSize(unsigned int fftSize) {
+    size_t blocks = (fftSize + FFT_DELTA_BLOCK_SIZE - 1) / FFT_DELTA_BLOCK_SIZE;
+    return FFT_DELTA_HEADER_SIZE + (blocks * 4 + (size_t) fftSize * (RICE_ESCAPE + 8) + 7) / 8 + BIT_WRITER_SLACK;
+}
+
+CSDR_TARGET_CLONES
+void FftDeltaCodec::quantize(const float* input, unsigned char* output) {
+    float scale = 255.0f / range;
+    for (unsigned int i = 0; i < fftSize; i++) {
+        float v = (input[i] - floor) * scale + 0.5f;
+        output[i] = (unsigned char) std::min(std::max(v, 0.0f), 255.0f);
+    }
+}
+
+CSDR_TARGET_CLONES
+void FftDeltaCodec::residuals(bool keyframe) {
+    // spatial prediction from the previous bin, the first bin is predicted as 0
+    spatial[0] = zigzag(current[0], 0);
+    for (unsigned int i = 1; i < fftSize; i++) {
+        spatial[i] = zigzag(current[i], current[i - 1]);
+    }
+    if (keyframe) return;
+    for (unsigned int i = 0; i < fftSize; i++) {
+        temporal[i] = zigzag(current[i], previous[i]);
+    }
+}
+
+size_t FftDeltaCodec::encode(const float* input, unsigned char* output) {
+    quantize(input, current);
+
+    bool keyframe = !hasPrevious || keyframeInterval == 0 || sinceKeyframe >= keyframeInterval;
+    sinceKeyframe = keyframe ? 1 : sinceKeyframe + 1;
+
+    residuals(keyframe);
+
+    BitWriter writer(output + FFT_DELTA_HEADER_SIZE);
+    for (unsigned int start = 0; start < fftSize; start += FFT_DELTA_BLOCK_SIZE) {
+        unsigned int length = std::min(fftSize - start, (unsigned int) FFT_DELTA_BLOCK_SIZE);
+
+        unsigned char* block = spatial + start;
+        unsigned int sum = 0;
+        for (unsigned int i = 0; i < length; i++) sum += spatial[start + i];
+        unsigned int k = riceParameter(sum, length);
+
+        bool useTemporal = false;
+        if (!keyframe) {
+            unsigned int temporalSum = 0;
+            for (unsigned int i = 0; i < length; i++) temporalSum += temporal[start + i];
+            unsigned int temporalK = riceParameter(temporalSum, length);
+            if (riceEstimate(temporalSum, length, temporalK) < riceEstimate(sum, length, k)) {
+                useTemporal = true;
+                block = temporal + start;
+                k = temporalK;
+            }
+        }
+
+        // block header: 1 bit predictor (1 = previous line), 3 bits Rice parameter
+        writer.write((useTemporal << 3) | k, 4);
+        for (unsigned int i = 0; i < length; i++) {
+            riceWrite(writer, block[i], k);
+        }
+    }
+    size_t payload = writer.finish();
+
+    output[0] = keyframe ? FFT_DELTA_FLAG_KEYFRAME : 0;
+    output[1] = 0;
+    writeLe16(output + 2, (uint16_t) (int16_t) floor);
+    writeLe16(output + 4, (uint16_t) range);
+    writeLe32(output + 6, fftSize);
+    writeLe32(output + 10, payload);
+
+    std::swap(current, previous);
+    hasPrevious = true;
+
+    return FFT_DELTA_HEADER_SIZE + payload;
+}
+
+FftDeltaEncoder::FftDeltaEncoder(unsigned int fftSize, int floor, unsigned int range, unsigned int keyframeInterval):
+    fftSize(fftSize),
+    codec(fftSize, floor, range, keyframeInterval)
+{}
+
+FftDeltaEncoder::FftDeltaEncoder(unsigned int fftSize): FftDeltaEncoder(fftSize, -140, 120, 16) {}
+
+bool FftDeltaEncoder::canProcess() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    return reader->available() >= fftSize && writer->writeable() >= FftDeltaCodec::maxEncodedSize(fftSize);
+}
+
+void FftDeltaEncoder::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    size_t written = codec.encode(reader->getReadPointer(), writer->getWritePointer());
+    reader->advance(fftSize);
+    writer->advance(written);
+}
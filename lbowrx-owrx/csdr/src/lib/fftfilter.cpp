@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "fftfilter.hpp"
 #include "fir.hpp"
+#include "fftplanner.hpp"
 
 #include <cstring>
 
@@ -47,10 +48,10 @@ FftFilter<T>::FftFilter(size_t fftSize):
     fftSize(fftSize),
     forwardInput(fftwf_alloc_complex(fftSize)),
     forwardOutput(fftwf_alloc_complex(fftSize)),
-    forwardPlan(fftwf_plan_dft_1d(fftSize, forwardInput, forwardOutput, FFTW_FORWARD, CSDR_FFTW_FLAGS)),
+    forwardPlan(FftPlanner::planDft(fftSize, forwardInput, forwardOutput, FFTW_FORWARD, CSDR_FFTW_FLAGS)),
     inverseInput(fftwf_alloc_complex(fftSize)),
     inverseOutput(fftwf_alloc_complex(fftSize)),
-    inversePlan(fftwf_plan_dft_1d(fftSize, inverseInput, inverseOutput, FFTW_BACKWARD, CSDR_FFTW_FLAGS)),
+    inversePlan(FftPlanner::planDft(fftSize, inverseInput, inverseOutput, FFTW_BACKWARD, CSDR_FFTW_FLAGS)),
     overlap((T*) calloc(sizeof(T), fftSize))
 {
     // fill with zeros so that the padding works
@@ -62,18 +63,23 @@ FftFilter<T>::FftFilter(size_t fftSize):
 
 template <typename T>
 FftFilter<T>::FftFilter(size_t fftSize, complex<float> *taps, size_t taps_length): FftFilter(fftSize) {
-    this->taps = taps;
+    setTaps(std::make_shared<Taps<complex<float>>>(taps, fftSize), taps_length);
+}
+
+template <typename T>
+void FftFilter<T>::setTaps(std::shared_ptr<Taps<complex<float>>> taps, size_t taps_length) {
+    table = taps;
+    this->taps = taps->getData();
     this->taps_length = taps_length;
     inputSize = fftSize - taps_length + 1;
 }
 
 template<typename T>
 FftFilter<T>::~FftFilter() {
-    free(taps);
-    fftwf_destroy_plan(forwardPlan);
+    FftPlanner::destroy(forwardPlan);
     fftwf_free(forwardInput);
     fftwf_free(forwardOutput);
-    fftwf_destroy_plan(inversePlan);
+    FftPlanner::destroy(inversePlan);
     fftwf_free(inverseInput);
     fftwf_free(inverseOutput);
     free(overlap);
@@ -138,11 +144,23 @@ size_t FftFilter<T>::getFftSize(size_t taps_length) {
 FftBandPassFilter::FftBandPassFilter(float lowcut, float highcut, float transition, Window* window):
     FftFilter<complex<float>>(FftBandPassFilter::getFftSize(FftBandPassFilter::filterLength(transition)))
 {
-    taps_length = FftBandPassFilter::filterLength(transition);
-    auto generator = new BandPassTapGenerator(lowcut, highcut, window);
-    taps = generator->generateFftTaps(taps_length, fftSize);
-    delete generator;
-    inputSize = fftSize - taps_length + 1;
+    size_t length = FftBandPassFilter::filterLength(transition);
+    setTaps(BandPassTapGenerator(lowcut, highcut, window).getFftTaps(length, fftSize), length);
+}
+
+FftBandPassFilter::FftBandPassFilter(float lowcut, float highcut, MinimumLengthTapGenerator* design):
+    FftBandPassFilter(std::make_shared<BandPassTapGenerator>(lowcut, highcut, design))
+{}
+
+FftBandPassFilter::FftBandPassFilter(std::shared_ptr<BandPassTapGenerator> generator):
+    FftBandPassFilter(generator, generator->getTaps(0))
+{}
+
+FftBandPassFilter::FftBandPassFilter(std::shared_ptr<BandPassTapGenerator> generator, std::shared_ptr<Taps<complex<float>>> taps):
+    FftFilter<complex<float>>(FftBandPassFilter::getFftSize(taps->getLength())),
+    designTaps(taps)
+{
+    setTaps(generator->getFftTaps(0, fftSize), taps->getLength());
 }
 
 namespace Csdr {
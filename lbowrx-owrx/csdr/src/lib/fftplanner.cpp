@@ -0,0 +1,62 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "fftplanner.hpp"
+
+using namespace Csdr;
+
+std::mutex FftPlanner::plannerMutex;
+
+fftwf_plan FftPlanner::planDft(unsigned int size, complex<float>* input, complex<float>* output, unsigned int threads) {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+#ifdef CSDR_FFTW_THREADS
+    static bool threadsInitialized = fftwf_init_threads() != 0;
+    if (threads > 1 && threadsInitialized) {
+        // FFTW_MEASURE overwrites the buffers, so this needs to happen before they are used
+        fftwf_plan_with_nthreads(threads);
+        fftwf_plan plan = fftwf_plan_dft_1d(size, (fftwf_complex*) input, (fftwf_complex*) output, FFTW_FORWARD, FFTW_MEASURE);
+        fftwf_plan_with_nthreads(1);
+        return plan;
+    }
+#endif
+    return fftwf_plan_dft_1d(size, (fftwf_complex*) input, (fftwf_complex*) output, FFTW_FORWARD, FFTW_ESTIMATE);
+}
+
+fftwf_plan FftPlanner::planDft(unsigned int size, fftwf_complex* input, fftwf_complex* output, int sign, unsigned int flags) {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    return fftwf_plan_dft_1d(size, input, output, sign, flags);
+}
+
+fftwf_plan FftPlanner::planDftR2c(unsigned int size, float* input, fftwf_complex* output, unsigned int flags) {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    return fftwf_plan_dft_r2c_1d(size, input, output, flags);
+}
+
+void FftPlanner::destroy(fftwf_plan plan) {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    fftwf_destroy_plan(plan);
+}
+
+bool FftPlanner::hasThreads() {
+#ifdef CSDR_FFTW_THREADS
+    return true;
+#else
+    return false;
+#endif
+}
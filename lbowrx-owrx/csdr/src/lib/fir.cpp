@@ -32,30 +32,37 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "fir.hpp"
 #include "complex.hpp"
 #include "fmv.h"
+#include "fftplanner.hpp"
 
 #include <cmath>
 #include <cstring>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
 #include <fftw3.h>
 
 #include <iostream>
 
 using namespace Csdr;
 
-template <typename T, typename U>
-FirFilter<T, U>::FirFilter(size_t length) {
-    allocateTaps(length);
+template <typename U>
+static Taps<U>* copyTaps(U* taps, size_t length) {
+    // better to copy the taps to our memory since that is aligned
+    auto copy = (U*) malloc(sizeof(U) * length);
+    std::memcpy(copy, taps, sizeof(U) * length);
+    return new Taps<U>(copy, length);
 }
 
 template <typename T, typename U>
-FirFilter<T, U>::FirFilter(U* taps, size_t length): FirFilter(length) {
-    // better to copy the taps to our memory since that is aligned
-    std::memcpy(this->taps, taps, sizeof(U) * length);
-}
+FirFilter<T, U>::FirFilter(U* taps, size_t length): FirFilter(std::shared_ptr<Taps<U>>(copyTaps(taps, length))) {}
 
 template <typename T, typename U>
-FirFilter<T, U>::~FirFilter() {
-    free(taps);
-}
+FirFilter<T, U>::FirFilter(std::shared_ptr<Taps<U>> taps):
+    table(taps),
+    taps(taps->getData()),
+    taps_length(taps->getLength())
+{}
 
 template <typename T, typename U>
 T FirFilter<T, U>::processSample(T *data, size_t index) {
@@ -84,45 +91,63 @@ size_t FirFilter<T, U>::getOverhead() {
     return taps_length;
 }
 
-template<typename T, typename U>
-void FirFilter<T, U>::allocateTaps(size_t length) {
-    taps = (U*) malloc(length * sizeof(U));
-    taps_length = length;
-}
-
 template<typename T>
 TapGenerator<T>::TapGenerator(Window *window): window(window) {}
 
-template <>
-complex<float>* TapGenerator<complex<float>>::generateFftTaps(size_t length, size_t fftSize) {
-    complex<float>* taps = generateTaps(length);
+static complex<float>* transformTaps(const complex<float>* input, size_t length, size_t fftSize) {
+    auto taps = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
     for (size_t i = 0; i < length; i++) {
         // reverse the taps - in FFT, things are upside down
-        taps[i] = { taps[i].q(), taps[i].i() };
+        taps[i] = { input[i].q(), input[i].i() };
     }
-    taps = (complex<float>*) realloc(taps, sizeof(complex<float>) * fftSize);
     for (size_t i = length; i < fftSize; i++) taps[i] = 0.0f;
     fftwf_complex* output_buffer = fftwf_alloc_complex(fftSize);
-    fftwf_plan plan = fftwf_plan_dft_1d(fftSize, (fftwf_complex*) taps, output_buffer, FFTW_FORWARD, FFTW_ESTIMATE);
+    fftwf_plan plan = FftPlanner::planDft(fftSize, (fftwf_complex*) taps, output_buffer, FFTW_FORWARD, FFTW_ESTIMATE);
     fftwf_execute(plan);
-    fftwf_destroy_plan(plan);
+    FftPlanner::destroy(plan);
     free(taps);
     return (complex<float>*) output_buffer;
 }
 
-template <>
-complex<float>* TapGenerator<float>::generateFftTaps(size_t length, size_t fftSize) {
-    float* taps = generateTaps(length);
-    taps = (float*) realloc(taps, sizeof(float) * fftSize);
+static complex<float>* transformTaps(const float* input, size_t length, size_t fftSize) {
+    auto taps = (float*) malloc(sizeof(float) * fftSize);
+    std::memcpy(taps, input, sizeof(float) * length);
     for (size_t i = length; i < fftSize; i++) taps[i] = 0.0f;
     fftwf_complex* output_buffer = fftwf_alloc_complex(fftSize);
-    fftwf_plan plan = fftwf_plan_dft_r2c_1d(fftSize, taps, output_buffer, FFTW_ESTIMATE);
+    fftwf_plan plan = FftPlanner::planDftR2c(fftSize, taps, output_buffer, FFTW_ESTIMATE);
     fftwf_execute(plan);
-    fftwf_destroy_plan(plan);
+    FftPlanner::destroy(plan);
     free(taps);
     return (complex<float>*) output_buffer;
 }
 
+template <typename T>
+complex<float>* TapGenerator<T>::generateFftTaps(size_t length, size_t fftSize) {
+    T* taps = generateTaps(length);
+    complex<float>* result = transformTaps(taps, length, fftSize);
+    free(taps);
+    return result;
+}
+
+template <typename T>
+std::shared_ptr<Taps<T>> TapGenerator<T>::getTaps(size_t length) {
+    std::string key = getKey() + " " + (length ? std::to_string(length) : "minimum");
+    return TapCache::get<T>(key, [this, length] () {
+        size_t l = length ? length : getLength();
+        if (l == 0) throw std::runtime_error("tap generator can not determine the length by itself");
+        return new Taps<T>(generateTaps(l), l);
+    });
+}
+
+template <typename T>
+std::shared_ptr<Taps<complex<float>>> TapGenerator<T>::getFftTaps(size_t length, size_t fftSize) {
+    std::string key = "fft " + getKey() + " " + (length ? std::to_string(length) : "minimum") + " " + std::to_string(fftSize);
+    return TapCache::get<complex<float>>(key, [this, length, fftSize] () {
+        auto taps = getTaps(length);
+        return new Taps<complex<float>>(transformTaps(taps->getData(), taps->getLength(), fftSize), fftSize);
+    });
+}
+
 template<>
 void TapGenerator<float>::normalize(float* taps, size_t length) {
     //Normalize filter kernel
@@ -144,6 +169,12 @@ LowPassTapGenerator::LowPassTapGenerator(float cutoff, Window *window):
     cutoff(cutoff)
 {}
 
+std::string LowPassTapGenerator::getKey() {
+    std::ostringstream key;
+    key << "lowpass " << std::hexfloat << cutoff << " " << window->getKey();
+    return key.str();
+}
+
 float* LowPassTapGenerator::generateTaps(size_t length) {
     //Generates symmetric windowed sinc FIR filter real taps
     //  cutoff_rate is (cutoff frequency/sampling frequency)
@@ -161,32 +192,334 @@ float* LowPassTapGenerator::generateTaps(size_t length) {
     return taps;
 }
 
-template <typename T>
-LowPassFilter<T>::LowPassFilter(float cutoff, float transition, Window *window):
-    FirFilter<T, float>(LowPassFilter<T>::filterLength(transition))
+MinimumLengthTapGenerator::MinimumLengthTapGenerator(float cutoff, float transition, float ripple, float attenuation):
+    TapGenerator<float>(nullptr),
+    cutoff(cutoff),
+    transition(transition),
+    ripple(ripple),
+    attenuation(attenuation)
+{}
+
+double MinimumLengthTapGenerator::getPassbandDeviation() {
+    // ripple is peak to peak: (1 + d) / (1 - d)
+    double r = pow(10, ripple / 20);
+    return (r - 1) / (r + 1);
+}
+
+double MinimumLengthTapGenerator::getStopbandDeviation() {
+    return pow(10, -attenuation / 20);
+}
+
+size_t MinimumLengthTapGenerator::getLength() {
+    if (length) return length;
+    // the estimates are close, but not exact. starting from there, steps of growing size find an interval that contains
+    // the shortest filter that meets the specification, which is then narrowed down by bisection (odd lengths only).
+    size_t estimate = std::max(estimateLength(), (size_t) 3) | 1;
+    size_t failing = 1, passing, step = 2;
+    if (meetsSpecification(estimate)) {
+        passing = estimate;
+        while (passing > 3) {
+            size_t next = passing >= step + 3 ? passing - step : 3;
+            if (!meetsSpecification(next)) {
+                failing = next;
+                break;
+            }
+            passing = next;
+            step *= 2;
+        }
+    } else {
+        failing = estimate;
+        while (true) {
+            passing = failing + step;
+            if (meetsSpecification(passing)) break;
+            // specifications that can't be met (e.g. with the precision of float taps) end up here
+            if (passing > 4 * estimate + 64) break;
+            failing = passing;
+            step *= 2;
+        }
+    }
+    while (passing - failing > 2) {
+        size_t middle = ((failing + passing) / 2) | 1;
+        if (meetsSpecification(middle)) {
+            passing = middle;
+        } else {
+            failing = middle;
+        }
+    }
+    length = passing;
+    return length;
+}
+
+bool MinimumLengthTapGenerator::meetsSpecification(size_t length) {
+    float* taps = generateTaps(length);
+    float achievedRipple, achievedAttenuation;
+    measure(taps, length, cutoff, transition, &achievedRipple, &achievedAttenuation);
+    free(taps);
+    return achievedRipple <= ripple && achievedAttenuation >= attenuation;
+}
+
+void MinimumLengthTapGenerator::measure(float* taps, size_t length, float cutoff, float transition, float* ripple, float* attenuation) {
+    double passband = cutoff - transition / 2, stopband = cutoff + transition / 2;
+    size_t points = std::max(length * 8, (size_t) 64);
+    auto response = [taps, length] (double frequency) {
+        std::complex<double> sum = 0, rotation = std::polar(1.0, -2 * M_PI * frequency), phase = 1;
+        for (size_t i = 0; i < length; i++) {
+            sum += (double) taps[i] * phase;
+            phase *= rotation;
+        }
+        return std::abs(sum);
+    };
+    // the extrema between the grid points are estimated with a parabola through the neighbouring points. the grid
+    // alone misses the peaks by up to 0.1 dB.
+    auto extremum = [] (std::vector<double>& r, size_t i) {
+        double d = r[i - 1] - 2 * r[i] + r[i + 1];
+        return d != 0 ? r[i] - (r[i + 1] - r[i - 1]) * (r[i + 1] - r[i - 1]) / (8 * d) : r[i];
+    };
+    double gain = response(0), minimum = gain, maximum = gain;
+    std::vector<double> r(points + 1);
+    if (passband > 0) {
+        for (size_t i = 0; i <= points; i++) r[i] = response(passband * i / points);
+        for (size_t i = 0; i <= points; i++) {
+            double value = r[i];
+            if (i > 0 && i < points && ((r[i] >= r[i - 1] && r[i] >= r[i + 1]) || (r[i] <= r[i - 1] && r[i] <= r[i + 1]))) {
+                value = extremum(r, i);
+            }
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+        }
+    }
+    double stop = 0;
+    if (stopband < 0.5) {
+        for (size_t i = 0; i <= points; i++) r[i] = response(stopband + (0.5 - stopband) * i / points);
+        for (size_t i = 0; i <= points; i++) {
+            bool peak = i > 0 && i < points && r[i] >= r[i - 1] && r[i] >= r[i + 1];
+            stop = std::max(stop, peak ? extremum(r, i) : r[i]);
+        }
+    }
+    *ripple = 20 * log10(maximum / minimum);
+    *attenuation = stop > 0 ? -20 * log10(stop / gain) : INFINITY;
+}
+
+KaiserTapGenerator::KaiserTapGenerator(float cutoff, float transition, float ripple, float attenuation):
+    MinimumLengthTapGenerator(cutoff, transition, ripple, attenuation)
 {
+    // a window design has the same deviation in both bands, so the tighter one of the two counts
+    double deviation = std::min(getPassbandDeviation(), getStopbandDeviation());
+    window = new KaiserWindow(KaiserWindow::beta(-20 * log10(deviation)));
+}
+
+KaiserTapGenerator::~KaiserTapGenerator() {
+    delete window;
+}
+
+float* KaiserTapGenerator::generateTaps(size_t length) {
     auto generator = new LowPassTapGenerator(cutoff, window);
-    float* taps = generator->generateTaps(this->taps_length);
-    memcpy(this->taps, taps, sizeof(float) * this->taps_length);
-    free(taps);
+    float* taps = generator->generateTaps(length);
     delete generator;
+    return taps;
 }
 
+std::string KaiserTapGenerator::getKey() {
+    std::ostringstream key;
+    key << "kaiser " << std::hexfloat << cutoff << " " << transition << " " << ripple << " " << attenuation;
+    return key.str();
+}
+
+MinimumLengthTapGenerator* KaiserTapGenerator::withCutoff(float cutoff) {
+    return new KaiserTapGenerator(cutoff, transition, ripple, attenuation);
+}
+
+size_t KaiserTapGenerator::estimateLength() {
+    double a = -20 * log10(std::min(getPassbandDeviation(), getStopbandDeviation()));
+    return ceil((a - 7.95) / (2.285 * 2 * M_PI * transition)) + 1;
+}
+
+RemezTapGenerator::RemezTapGenerator(float cutoff, float transition, float ripple, float attenuation):
+    MinimumLengthTapGenerator(cutoff, transition, ripple, attenuation)
+{}
+
+float* RemezTapGenerator::generateTaps(size_t length) {
+    //Parks-McClellan design of a symmetric (type I) lowpass. the response is a polynomial of degree m in cos(w), which
+    //is fitted to the desired response on a dense frequency grid by exchanging the m + 2 extremal frequencies until the
+    //weighted error alternates with equal magnitude (see Oppenheim / Schafer, Discrete-Time Signal Processing).
+    size_t m = length / 2;
+    size_t r = m + 2;
+    double passband = std::max(0.0, (double) cutoff - transition / 2);
+    double stopband = std::min(0.5, (double) cutoff + transition / 2);
+    // errors are weighted so that the stopband deviation ends up in the specified ratio to the passband deviation
+    double weight = getPassbandDeviation() / getStopbandDeviation();
+
+    size_t gridSize = 16 * r;
+    size_t passbandPoints = std::max((size_t) 1, (size_t) (gridSize * passband / (passband + 0.5 - stopband)));
+    size_t stopbandPoints = std::max(r, gridSize - passbandPoints);
+    gridSize = passbandPoints + stopbandPoints;
+    std::vector<double> x(gridSize), desired(gridSize), weights(gridSize), error(gridSize);
+    for (size_t i = 0; i < gridSize; i++) {
+        bool pass = i < passbandPoints;
+        double frequency = pass ?
+            (passbandPoints > 1 ? passband * i / (passbandPoints - 1) : 0) :
+            stopband + (0.5 - stopband) * (i - passbandPoints) / (stopbandPoints - 1);
+        x[i] = cos(2 * M_PI * frequency);
+        desired[i] = pass ? 1 : 0;
+        weights[i] = pass ? 1 : weight;
+    }
+
+    std::vector<size_t> extremals(r);
+    for (size_t i = 0; i < r; i++) extremals[i] = i * (gridSize - 1) / (r - 1);
+    std::vector<double> xe(r), b(r), y(r);
+
+    // barycentric interpolation through the values y at the extremal frequencies
+    auto evaluate = [&xe, &b, &y, r] (double xv) {
+        double numerator = 0, denominator = 0;
+        for (size_t i = 0; i < r; i++) {
+            double d = xv - xe[i];
+            if (fabs(d) < 1E-14) return y[i];
+            numerator += b[i] * y[i] / d;
+            denominator += b[i] / d;
+        }
+        return numerator / denominator;
+    };
+
+    for (int iteration = 0; iteration < 50; iteration++) {
+        // the barycentric weights would overflow for long filters, so they are calculated in the log domain
+        // and scaled (the scale cancels out everywhere below)
+        std::vector<double> logs(r);
+        std::vector<bool> negative(r);
+        double maxLog = -INFINITY;
+        for (size_t i = 0; i < r; i++) {
+            xe[i] = x[extremals[i]];
+        }
+        for (size_t i = 0; i < r; i++) {
+            logs[i] = 0;
+            negative[i] = false;
+            for (size_t j = 0; j < r; j++) {
+                if (j == i) continue;
+                double d = xe[i] - xe[j];
+                logs[i] -= log(fabs(d));
+                if (d < 0) negative[i] = !negative[i];
+            }
+            maxLog = std::max(maxLog, logs[i]);
+        }
+        double numerator = 0, denominator = 0;
+        for (size_t i = 0; i < r; i++) {
+            b[i] = exp(logs[i] - maxLog) * (negative[i] ? -1 : 1);
+            numerator += b[i] * desired[extremals[i]];
+            denominator += b[i] * (i % 2 ? -1 : 1) / weights[extremals[i]];
+        }
+        double delta = numerator / denominator;
+        for (size_t i = 0; i < r; i++) {
+            y[i] = desired[extremals[i]] - (i % 2 ? -1 : 1) * delta / weights[extremals[i]];
+        }
+
+        double maxError = 0;
+        for (size_t i = 0; i < gridSize; i++) {
+            error[i] = weights[i] * (desired[i] - evaluate(x[i]));
+            maxError = std::max(maxError, fabs(error[i]));
+        }
+        if (maxError - fabs(delta) < 1E-4 * maxError) break;
+
+        // new extremals: local extrema of the error, alternating in sign
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < gridSize; i++) {
+            double e = error[i];
+            bool left = i == 0 || (e > 0 ? e >= error[i - 1] : e <= error[i - 1]);
+            bool right = i == gridSize - 1 || (e > 0 ? e >= error[i + 1] : e <= error[i + 1]);
+            if (!left || !right || e == 0) continue;
+            if (!candidates.empty() && (error[candidates.back()] > 0) == (e > 0)) {
+                if (fabs(e) > fabs(error[candidates.back()])) candidates.back() = i;
+            } else {
+                candidates.push_back(i);
+            }
+        }
+        if (candidates.size() < r) break;
+        while (candidates.size() > r) {
+            // dropping an end keeps the alternation intact
+            if (fabs(error[candidates.front()]) < fabs(error[candidates.back()])) {
+                candidates.erase(candidates.begin());
+            } else {
+                candidates.pop_back();
+            }
+        }
+        if (candidates == extremals) break;
+        extremals = candidates;
+    }
+
+    // sample the response and transform back into (symmetric) taps
+    std::vector<double> amplitude(m + 1);
+    for (size_t k = 0; k <= m; k++) amplitude[k] = evaluate(cos(2 * M_PI * k / length));
+    auto taps = (float*) malloc(sizeof(float) * length);
+    for (size_t n = 0; n <= m; n++) {
+        double sum = amplitude[0];
+        for (size_t k = 1; k <= m; k++) sum += 2 * amplitude[k] * cos(2 * M_PI * k * ((double) n - m) / length);
+        taps[n] = taps[length - 1 - n] = (float) (sum / length);
+    }
+    this->normalize(taps, length);
+    return taps;
+}
+
+std::string RemezTapGenerator::getKey() {
+    std::ostringstream key;
+    key << "remez " << std::hexfloat << cutoff << " " << transition << " " << ripple << " " << attenuation;
+    return key.str();
+}
+
+MinimumLengthTapGenerator* RemezTapGenerator::withCutoff(float cutoff) {
+    return new RemezTapGenerator(cutoff, transition, ripple, attenuation);
+}
+
+size_t RemezTapGenerator::estimateLength() {
+    //Estimate by Kaiser for equiripple filters
+    double a = -20 * log10(sqrt(getPassbandDeviation() * getStopbandDeviation()));
+    return ceil((a - 13) / (14.6 * transition)) + 1;
+}
+
+template <typename T>
+LowPassFilter<T>::LowPassFilter(float cutoff, float transition, Window *window):
+    FirFilter<T, float>(LowPassTapGenerator(cutoff, window).getTaps(LowPassFilter<T>::filterLength(transition)))
+{}
+
+template <typename T>
+LowPassFilter<T>::LowPassFilter(MinimumLengthTapGenerator* generator):
+    FirFilter<T, float>(generator->getTaps(0))
+{}
+
 BandPassTapGenerator::BandPassTapGenerator(float lowcut, float highcut, Window *window):
     TapGenerator<complex<float>>(window),
     lowcut(lowcut),
-    highcut(highcut)
+    highcut(highcut),
+    prototype(new LowPassTapGenerator((highcut - lowcut) / 2, window))
 {}
 
+BandPassTapGenerator::BandPassTapGenerator(float lowcut, float highcut, MinimumLengthTapGenerator* design):
+    TapGenerator<complex<float>>(nullptr),
+    lowcut(lowcut),
+    highcut(highcut),
+    design(design->withCutoff((highcut - lowcut) / 2))
+{
+    prototype = this->design;
+}
+
+BandPassTapGenerator::~BandPassTapGenerator() {
+    delete prototype;
+}
+
+size_t BandPassTapGenerator::getLength() {
+    return design != nullptr ? design->getLength() : 0;
+}
+
+std::string BandPassTapGenerator::getKey() {
+    std::ostringstream key;
+    key << "bandpass " << std::hexfloat << lowcut << " " << highcut << " " << prototype->getKey();
+    return key.str();
+}
+
 complex<float> * BandPassTapGenerator::generateTaps(size_t length) {
     //To generate a complex filter:
     //  1. we generate a real lowpass filter with a bandwidth of highcut-lowcut
     //  2. we shift the filter taps spectrally by multiplying with e^(j*w), so we get complex taps
     //(tnx HA5FT)
 
-    auto lowpassGenerator = new LowPassTapGenerator((highcut - lowcut) / 2, window);
-    float* realTaps = lowpassGenerator->generateTaps(length);
-    delete lowpassGenerator;
+    float* realTaps = prototype->generateTaps(length);
 
     auto taps = (complex<float>*) malloc(sizeof(complex<float>) * length);
     float filter_center = (highcut + lowcut) / 2;
@@ -206,16 +539,18 @@ complex<float> * BandPassTapGenerator::generateTaps(size_t length) {
 
 template<typename T>
 BandPassFilter<T>::BandPassFilter(float lowcut, float highcut, float transition, Window *window):
-    FirFilter<T, complex<float>>(BandPassFilter<T>::filterLength(transition))
-{
-    auto generator = new BandPassTapGenerator(lowcut, highcut, window);
-    complex<float>* taps = generator->generateTaps(this->taps_length);
-    memcpy(this->taps, taps, sizeof(complex<float>) * this->taps_length);
-    delete generator;
-    free(taps);
-}
+    FirFilter<T, complex<float>>(BandPassTapGenerator(lowcut, highcut, window).getTaps(BandPassFilter<T>::filterLength(transition)))
+{}
+
+template<typename T>
+BandPassFilter<T>::BandPassFilter(float lowcut, float highcut, MinimumLengthTapGenerator* design):
+    FirFilter<T, complex<float>>(BandPassTapGenerator(lowcut, highcut, design).getTaps(0))
+{}
 
 namespace Csdr {
+    template class TapGenerator<float>;
+    template class TapGenerator<complex<float>>;
+
     template class FirFilter<complex<float>, complex<float>>;
     template class FirFilter<complex<float>, float>;
     template class FirFilter<float, float>;
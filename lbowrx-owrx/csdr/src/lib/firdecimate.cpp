@@ -18,26 +18,52 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "firdecimate.hpp"
+#include "converter.hpp"
+#include "fmv.h"
 
 using namespace Csdr;
 
-FirDecimate::FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window, float cutoff):
+template <typename T>
+FirDecimate<T>::FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window, float cutoff):
     decimation(decimation),
     lowpass(new LowPassFilter<complex<float>>(cutoff / (float) decimation, transitionBandwidth, window))
 {}
 
-FirDecimate::FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window):
+template <typename T>
+FirDecimate<T>::FirDecimate(unsigned int decimation, float transitionBandwidth, Window* window):
     FirDecimate(decimation, transitionBandwidth, window, 0.5f)
 {}
 
-FirDecimate::~FirDecimate() {
+template <typename T>
+FirDecimate<T>::FirDecimate(unsigned int decimation, MinimumLengthTapGenerator* design):
+    decimation(decimation),
+    lowpass(new LowPassFilter<complex<float>>(design))
+{}
+
+template <typename T>
+FirDecimate<T>::~FirDecimate() {
     delete lowpass;
 }
 
-void FirDecimate::process() {
-    std::lock_guard<std::mutex> lock(processMutex);
-    size_t available = reader->available();
-    size_t writeable = writer->writeable();
+template <typename T>
+CSDR_TARGET_CLONES
+static void firDecimate(T* input, complex<float>* output, size_t samples, unsigned int decimation, const float* taps, size_t length) {
+    for (size_t s = 0; s < samples; s++) {
+        T* data = input + s * decimation;
+        float i = 0, q = 0;
+        for (size_t k = 0; k < length; k++) {
+            i += convertSample<typename T::value_type, float>(data[k].i()) * taps[k];
+            q += convertSample<typename T::value_type, float>(data[k].q()) * taps[k];
+        }
+        output[s] = {i, q};
+    }
+}
+
+template <typename T>
+void FirDecimate<T>::process() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    size_t available = this->reader->available();
+    size_t writeable = this->writer->writeable();
     size_t lpLen = lowpass->getOverhead();
 
     // sanity check
@@ -46,19 +72,22 @@ void FirDecimate::process() {
 
     size_t samples = std::min((available - lpLen) / decimation, writeable);
 
-    complex<float>* output = writer->getWritePointer();
-    SparseView<complex<float>> sparseView = lowpass->sparse(reader->getReadPointer());
-    for (size_t i = 0; i < samples; i++) {
-        output[i] = sparseView[i * decimation];
-    }
-    reader->advance(samples * decimation);
-    writer->advance(samples);
+    firDecimate(this->reader->getReadPointer(), this->writer->getWritePointer(), samples, decimation, lowpass->getTaps(), lpLen);
+    this->reader->advance(samples * decimation);
+    this->writer->advance(samples);
 }
 
-bool FirDecimate::canProcess() {
-    std::lock_guard<std::mutex> lock(processMutex);
-    size_t available = reader->available();
-    size_t writeable = writer->writeable();
+template <typename T>
+bool FirDecimate<T>::canProcess() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    size_t available = this->reader->available();
+    size_t writeable = this->writer->writeable();
     size_t lpLen = lowpass->getOverhead();
     return available > lpLen && (available - lpLen) / decimation > 0 && writeable > 0;
 }
+
+namespace Csdr {
+    template class FirDecimate<complex<float>>;
+    template class FirDecimate<complex<short>>;
+    template class FirDecimate<complex<half>>;
+}
@@ -30,43 +30,45 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "fmdemod.hpp"
+#include "fmv.h"
 
+#include <cmath>
 #include <algorithm>
 
 using namespace Csdr;
 
-FmDemod::FmDemod(): AnyLengthModule() {
-    temp_dq = (float*) malloc(sizeof(float) * buffer_size);
-    temp_di = (float*) malloc(sizeof(float) * buffer_size);
+// atan2 without branches, so it can be vectorized. the argument is reduced to [0, 1] and approximated by the odd
+// polynomial from Abramowitz & Stegun 4.4.49, absolute error below 1e-5 rad over the full circle.
+// returns 0 for (0, 0).
+static inline float fastAtan2(float y, float x) {
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+    float mx = std::max(ax, ay);
+    float mn = std::min(ax, ay);
+    float a = mx > 0.0f ? mn / mx : 0.0f;
+    float s = a * a;
+    float r = ((((0.0208351f * s - 0.0851330f) * s + 0.1801410f) * s - 0.3302995f) * s + 0.9998660f) * a;
+    r = ay > ax ? 1.57079637f - r : r;
+    r = x < 0.0f ? 3.14159274f - r : r;
+    return y < 0.0f ? -r : r;
 }
 
-FmDemod::~FmDemod() {
-    free(temp_dq);
-    free(temp_di);
+static inline float discriminate(complex<float> current, complex<float> previous) {
+    // x[n] * conj(x[n - 1])
+    float re = current.i() * previous.i() + current.q() * previous.q();
+    float im = current.q() * previous.i() - current.i() * previous.q();
+    return (float) fmdemod_quadri_K * fastAtan2(im, re);
 }
 
-void FmDemod::process(complex<float>* input, float* output, size_t work_size) {
-    temp_dq[0] = input[0].q() - last_sample.q();
-    for (int i = 1; i < work_size; i++) {
-        temp_dq[i] = input[i].q() - input[i-1].q();
-    }
-
-    temp_di[0] = input[0].i() - last_sample.i();
-    for (int i = 1; i < work_size; i++) {
-        temp_di[i] = input[i].i() - input[i-1].i();
-    }
-
-    for (int i = 0; i < work_size; i++){
-        output[i] = (input[i].i() * temp_dq[i] - input[i].q() * temp_di[i]);
-    }
-
-    for (int i = 0; i < work_size; i++) {
-        temp_dq[i] = input[i].i() * input[i].i() + input[i].q() * input[i].q();
-    }
-
-    for (int i = 0; i < work_size; i++) {
-        output[i] = temp_dq[i] ? fmdemod_quadri_K * output[i] / temp_dq[i] : 0;
+CSDR_TARGET_CLONES
+static void fmDemod(complex<float>* input, float* output, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        output[i] = discriminate(input[i], input[i - 1]);
     }
+}
 
+void FmDemod::process(complex<float>* input, float* output, size_t work_size) {
+    output[0] = discriminate(input[0], last_sample);
+    fmDemod(input, output, work_size);
     last_sample = input[work_size - 1];
-}
\ No newline at end of file
+}
@@ -30,87 +30,115 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "fractionaldecimator.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <algorithm>
+#include <sstream>
 
 using namespace Csdr;
 
 template <typename T>
-FractionalDecimator<T>::FractionalDecimator(float rate, unsigned int num_poly_points, FirFilter<T, float> *filter):
-    num_poly_points(num_poly_points &~ 1),
-    poly_precalc_denomiator((float*) malloc(this->num_poly_points * sizeof(float))),
-    xifirst(-(this->num_poly_points / 2) + 1),
-    xilast(this->num_poly_points / 2),
-    coeffs_buf((float*) malloc(this->num_poly_points * sizeof(float))),
-    rate(rate),
-    filter(filter)
+FractionalDecimator<T>::FractionalDecimator(float rate, unsigned int num_poly_points, float transition, Window* window):
+    rate(rate)
 {
-    int id = 0; //index in poly_precalc_denomiator
-    for (int xi = xifirst; xi <= xilast; xi++) {
-        poly_precalc_denomiator[id] = 1;
-        for(int xj = xifirst; xj <= xilast; xj++) {
-            //poly_precalc_denomiator could be integer as well. But that would later add a necessary conversion.
-            if (xi != xj) poly_precalc_denomiator[id] *= (xi - xj);
-        }
-        id++;
+    HammingWindow defaultWindow;
+    if (window == nullptr) window = &defaultWindow;
+
+    // cutoff relative to the input sample rate
+    double cutoff = 0;
+    length = num_poly_points;
+    if (transition > 0) {
+        // the transition band ends at the output nyquist frequency
+        cutoff = std::min(0.5, 0.5 / rate) - transition / 2;
+        length = 4.0 / transition;
     }
+    length = std::max(length + (length & 1), 2u);
 
-    where = -xifirst;
-}
+    std::ostringstream key;
+    key << "fractional decimator " << length << " ";
+    if (transition > 0) {
+        key << "sinc " << std::hexfloat << cutoff << " " << window->getKey();
+    } else {
+        key << "lagrange";
+    }
+    table = TapCache::get<float>(key.str(), [this, transition, cutoff, window] () {
+        // kernel taps for output positions between two input samples. tap j is applied to input sample j of the window,
+        // and phase p is for an output sample (p / FRACTIONAL_DECIMATOR_PHASES) behind input sample (length / 2 - 1).
+        int middle = length / 2 - 1;
+        auto taps = (float*) malloc(sizeof(float) * length * (FRACTIONAL_DECIMATOR_PHASES * 2 + 1));
+        for (int p = 0; p <= FRACTIONAL_DECIMATOR_PHASES; p++) {
+            float* phase = taps + p * length;
+            double fraction = (double) p / FRACTIONAL_DECIMATOR_PHASES;
+            double sum = 0;
+            for (int j = 0; j < length; j++) {
+                double t = j - middle - fraction;
+                double coefficient;
+                if (transition > 0) {
+                    // windowed sinc lowpass
+                    coefficient = t == 0 ? 2 * cutoff : sin(2 * M_PI * cutoff * t) / (M_PI * t);
+                    coefficient *= window->kernel(t / (length / 2));
+                } else {
+                    // lagrange polynomial through the input samples of the window
+                    coefficient = 1;
+                    for (int k = 0; k < length; k++) {
+                        if (k != j) coefficient *= (fraction - (k - middle)) / (j - k);
+                    }
+                }
+                phase[j] = (float) coefficient;
+                sum += coefficient;
+            }
+            // unity gain at DC for every phase. otherwise the gain would be modulated by the fractional position.
+            for (int j = 0; j < length; j++) phase[j] /= sum;
+        }
+        float* deltas = taps + length * (FRACTIONAL_DECIMATOR_PHASES + 1);
+        for (int i = 0; i < length * FRACTIONAL_DECIMATOR_PHASES; i++) deltas[i] = taps[i + length] - taps[i];
+        return new Taps<float>(taps, length * (FRACTIONAL_DECIMATOR_PHASES * 2 + 1));
+    });
+    taps = table->getData();
+    deltas = taps + length * (FRACTIONAL_DECIMATOR_PHASES + 1);
 
-template <typename T>
-FractionalDecimator<T>::~FractionalDecimator() {
-    free(poly_precalc_denomiator);
-    free(coeffs_buf);
+    int middle = length / 2 - 1;
+    where = middle;
 }
 
 template <typename T>
 bool FractionalDecimator<T>::canProcess() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    size_t size = std::min(this->reader->available(), (size_t) ceilf(this->writer->writeable() / rate));
-    size_t filterLen = filter != nullptr ? filter->getOverhead() : 0;
-    return ceilf(where) + num_poly_points + filterLen < size;
+    return (size_t) where + length / 2 < this->reader->available() && this->writer->writeable() > 0;
+}
+
+template <typename T>
+CSDR_TARGET_CLONES
+static T interpolate(const T* input, const float* taps, const float* deltas, float fraction, unsigned int length) {
+    T acc = 0;
+    for (unsigned int i = 0; i < length; i++) {
+        acc += input[i] * (taps[i] + fraction * deltas[i]);
+    }
+    return acc;
 }
 
 template <typename T>
 void FractionalDecimator<T>::process() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    //This routine can handle floating point decimation rates.
-    //It applies polynomial interpolation to samples that are taken into consideration from a pre-filtered input.
-    //The pre-filter can be switched off by applying filter = nullptr.
-    int oi = 0; //output index
-    int index_high, index;
-    size_t size = std::min(this->reader->available(), (size_t) ceilf(this->writer->writeable() / rate));
-    size_t filterLen = filter != nullptr ? filter->getOverhead() : 0;
+    size_t available = this->reader->available();
+    size_t writeable = this->writer->writeable();
     T* input = this->reader->getReadPointer();
     T* output = this->writer->getWritePointer();
-    //we optimize to calculate ceilf(where) only once every iteration, so we do it here:
-    while ((index_high = ceilf(where)) + num_poly_points + filterLen < size) {
-        // num_poly_points above is theoretically more than we could have here, but this makes the spectrum look good
-        index = index_high - 1;
-        int id = 0;
-        float xwhere = where - index;
-        for (int xi = xifirst; xi <= xilast; xi++) {
-            coeffs_buf[id] = 1;
-            for (int xj = xifirst; xj <= xilast; xj++) {
-                if (xi != xj) coeffs_buf[id] *= (xwhere - xj);
-            }
-            id++;
-        }
-        T acc = 0;
-        if (filter != nullptr) {
-            for (int i = 0; i < num_poly_points; i++) {
-                SparseView<T> sparse = filter->sparse(input);
-                acc += (coeffs_buf[i] / poly_precalc_denomiator[i]) * sparse[index + i];
-            }
-        } else {
-            for (int i = 0; i < num_poly_points; i++) {
-                acc += (coeffs_buf[i] / poly_precalc_denomiator[i]) * input[index + i];
-            }
-        }
-        output[oi++] = acc;
+    int middle = length / 2 - 1;
+
+    size_t oi = 0;
+    size_t index;
+    while ((index = (size_t) where) + length / 2 < available && oi < writeable) {
+        double position = (where - index) * FRACTIONAL_DECIMATOR_PHASES;
+        int phase = (int) position;
+        size_t offset = phase * length;
+        output[oi++] = interpolate(input + index - middle, taps + offset, deltas + offset, (float) (position - phase), length);
         where += rate;
     }
 
-    int input_processed = index + xifirst;
+    // keep the input that the next output sample needs
+    size_t input_processed = (size_t) where - middle;
     where -= input_processed;
 
     this->reader->advance(input_processed);
@@ -120,4 +148,4 @@ void FractionalDecimator<T>::process() {
 namespace Csdr {
     template class FractionalDecimator<float>;
     template class FractionalDecimator<complex<float>>;
-}
\ No newline at end of file
+}
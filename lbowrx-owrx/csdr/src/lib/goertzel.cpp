@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "goertzel.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Csdr;
+
+// runs the recursion for TONE_GROUP frequencies at once. input is transposed: one sample of every segment after
+// another. the state is kept in local arrays so it can live in vector registers.
+CSDR_TARGET_CLONES
+static void goertzel(const float* __restrict input, unsigned int length, const float* __restrict coefficients, float* __restrict s1, float* __restrict s2) {
+    const unsigned int segments = GoertzelBank::SEGMENTS;
+    const unsigned int size = GoertzelBank::TONE_GROUP * segments;
+    float c[size], a[size], b[size];
+    for (unsigned int j = 0; j < size; j++) {
+        c[j] = coefficients[j / segments];
+        a[j] = 0.0f;
+        b[j] = 0.0f;
+    }
+    for (unsigned int i = 0; i < length; i++) {
+        const float* x = input + i * segments;
+        for (unsigned int g = 0; g < GoertzelBank::TONE_GROUP; g++) {
+            for (unsigned int k = 0; k < segments; k++) {
+                float s0 = x[k] + c[g * segments + k] * a[g * segments + k] - b[g * segments + k];
+                b[g * segments + k] = a[g * segments + k];
+                a[g * segments + k] = s0;
+            }
+        }
+    }
+    std::copy(a, a + size, s1);
+    std::copy(b, b + size, s2);
+}
+
+GoertzelBank::GoertzelBank(const std::vector<float>& frequencies, unsigned int blockLength):
+    blockLength(blockLength),
+    segmentLength(blockLength / SEGMENTS),
+    transposed(segmentLength * SEGMENTS),
+    tones(frequencies.size()),
+    // padded to complete groups, the additional coefficients are never output
+    coefficients((tones + TONE_GROUP - 1) / TONE_GROUP * TONE_GROUP),
+    s1(coefficients.size() * SEGMENTS),
+    s2(coefficients.size() * SEGMENTS)
+{
+    if (frequencies.empty()) {
+        throw std::runtime_error("at least one frequency is required");
+    }
+    if (blockLength == 0) {
+        throw std::runtime_error("block length must be greater than 0");
+    }
+    for (size_t t = 0; t < tones; t++) {
+        float c = 2.0f * cosf(2.0f * (float) M_PI * frequencies[t]);
+        coefficients[t] = c;
+        // the recursion without input, (s1, s2) -> (c * s1 - s2, s1), applied segmentLength times
+        double m[4] = {1, 0, 0, 1};
+        for (unsigned int i = 0; i < segmentLength; i++) {
+            double n[4] = {c * m[0] - m[2], c * m[1] - m[3], m[0], m[1]};
+            std::copy(n, n + 4, m);
+        }
+        propagation.insert(propagation.end(), m, m + 4);
+    }
+}
+
+size_t GoertzelBank::getFrameSize() {
+    return tones;
+}
+
+bool GoertzelBank::canProcess() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    return reader->available() >= blockLength && writer->writeable() >= tones;
+}
+
+void GoertzelBank::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    // |X|^2 is (N * A / 2)^2 for a sine of amplitude A
+    float scale = 2.0f / ((float) blockLength * blockLength);
+
+    while (reader->available() >= blockLength && writer->writeable() >= tones) {
+        float* input = reader->getReadPointer();
+        for (unsigned int i = 0; i < segmentLength; i++) {
+            for (unsigned int k = 0; k < SEGMENTS; k++) {
+                transposed[i * SEGMENTS + k] = input[k * segmentLength + i];
+            }
+        }
+        for (size_t t = 0; t < tones; t += TONE_GROUP) {
+            goertzel(transposed.data(), segmentLength, coefficients.data() + t, s1.data() + t * SEGMENTS, s2.data() + t * SEGMENTS);
+        }
+
+        float* output = writer->getWritePointer();
+        for (size_t t = 0; t < tones; t++) {
+            // chain the segments: the state at the end of a segment is carried through the next one, and the
+            // segment's own response (calculated from a zero state) is added
+            const float* m = propagation.data() + t * 4;
+            float a = 0.0f, b = 0.0f;
+            for (unsigned int k = 0; k < SEGMENTS; k++) {
+                float na = m[0] * a + m[1] * b + s1[t * SEGMENTS + k];
+                float nb = m[2] * a + m[3] * b + s2[t * SEGMENTS + k];
+                a = na;
+                b = nb;
+            }
+            // samples that did not fit evenly into the segments
+            for (unsigned int i = segmentLength * SEGMENTS; i < blockLength; i++) {
+                float s0 = input[i] + coefficients[t] * a - b;
+                b = a;
+                a = s0;
+            }
+            output[t] = (a * a + b * b - coefficients[t] * a * b) * scale;
+        }
+
+        reader->advance(blockLength);
+        writer->advance(tones);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "iir.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace Csdr;
+
+FirstOrderIir::FirstOrderIir(float b, float a) {
+    double power = 1.0;
+    for (unsigned int j = 0; j < LOOKAHEAD; j++) {
+        taps[j] = (float) (b * power);
+        power *= a;
+    }
+    feedback = (float) power;
+}
+
+void FirstOrderIir::reset() {
+    std::fill(inputs, inputs + LOOKAHEAD, 0.0f);
+    std::fill(outputs, outputs + LOOKAHEAD, 0.0f);
+}
+
+CSDR_TARGET_CLONES
+static void lookAhead(const float* input, float* output, size_t size, const float* taps, float feedback) {
+    const unsigned int L = FirstOrderIir::LOOKAHEAD;
+    for (size_t i = L; i < size; i++) {
+        float acc = 0.0f;
+        for (unsigned int j = 0; j < L; j++) {
+            acc += taps[j] * input[i - j];
+        }
+        output[i] = acc + feedback * output[i - L];
+    }
+}
+
+void FirstOrderIir::process(const float* input, float* output, size_t size) {
+    const unsigned int L = LOOKAHEAD;
+    // the first samples reach back into the previous call
+    for (size_t i = 0; i < std::min(size, (size_t) L); i++) {
+        float acc = 0.0f;
+        for (unsigned int j = 0; j < L; j++) {
+            acc += taps[j] * (i >= j ? input[i - j] : inputs[L + i - j]);
+        }
+        output[i] = acc + feedback * outputs[i];
+    }
+    lookAhead(input, output, size, taps, feedback);
+
+    float newInputs[L], newOutputs[L];
+    for (unsigned int i = 0; i < L; i++) {
+        // k < 0 is still in the history
+        long k = (long) size - L + i;
+        newInputs[i] = k >= 0 ? input[k] : inputs[L + k];
+        newOutputs[i] = k >= 0 ? output[k] : outputs[L + k];
+    }
+    std::copy(newInputs, newInputs + L, inputs);
+    std::copy(newOutputs, newOutputs + L, outputs);
+
+    // a NaN would never leave the state
+    if (std::isnan(outputs[L - 1])) reset();
+}
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "logaveragepower.hpp"
+#include "decibel.hpp"
 
 #include <cstring>
 
@@ -65,14 +66,7 @@ void LogAveragePower::process() {
     if (++collected == avgNumber) {
         float* output = writer->getWritePointer();
         float correction = add_db - 10.0 * log10(avgNumber);
-
-        for (int i = 0; i < fftSize; i++) {
-            output[i] = log10(collector[i]);
-        }
-
-        for (int i = 0; i < fftSize; i++) {
-            output[i] = 10 * output[i] + correction;
-        }
+        powerToDb(collector, output, fftSize, correction);
 
         writer->advance(fftSize);
 
@@ -18,6 +18,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "module.hpp"
+#include "half.hpp"
 
 #include <algorithm>
 
@@ -111,6 +112,17 @@ namespace Csdr {
     template class Module<unsigned char, unsigned char>;
     template class Module<complex<float>, complex<short>>;
     template class Module<complex<short>, complex<float>>;
+    template class Module<unsigned char, float>;
+    template class Module<complex<unsigned char>, complex<short>>;
+    template class Module<complex<unsigned char>, complex<float>>;
+    template class Module<complex<short>, complex<unsigned char>>;
+    template class Module<complex<float>, complex<unsigned char>>;
+    template class Module<complex<unsigned char>, complex<half>>;
+    template class Module<complex<short>, complex<half>>;
+    template class Module<complex<float>, complex<half>>;
+    template class Module<complex<half>, complex<unsigned char>>;
+    template class Module<complex<half>, complex<short>>;
+    template class Module<complex<half>, complex<float>>;
 
     template class AnyLengthModule<short, short>;
     template class AnyLengthModule<float, float>;
@@ -121,7 +133,23 @@ namespace Csdr {
     template class AnyLengthModule<complex<float>, unsigned char>;
     template class AnyLengthModule<complex<float>, complex<short>>;
     template class AnyLengthModule<complex<short>, complex<float>>;
+    template class AnyLengthModule<unsigned char, short>;
+    template class AnyLengthModule<unsigned char, float>;
+    template class AnyLengthModule<short, unsigned char>;
+    template class AnyLengthModule<float, unsigned char>;
+    template class AnyLengthModule<complex<unsigned char>, complex<short>>;
+    template class AnyLengthModule<complex<unsigned char>, complex<float>>;
+    template class AnyLengthModule<complex<short>, complex<unsigned char>>;
+    template class AnyLengthModule<complex<float>, complex<unsigned char>>;
+    template class AnyLengthModule<complex<unsigned char>, complex<half>>;
+    template class AnyLengthModule<complex<short>, complex<half>>;
+    template class AnyLengthModule<complex<float>, complex<half>>;
+    template class AnyLengthModule<complex<half>, complex<unsigned char>>;
+    template class AnyLengthModule<complex<half>, complex<short>>;
+    template class AnyLengthModule<complex<half>, complex<float>>;
 
     template class FixedLengthModule<float, float>;
     template class FixedLengthModule<complex<float>, complex<float>>;
+    template class FixedLengthModule<complex<short>, complex<float>>;
+    template class FixedLengthModule<complex<half>, complex<float>>;
 }
\ No newline at end of file
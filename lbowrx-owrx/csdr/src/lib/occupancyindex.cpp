@@ -0,0 +1,172 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "occupancyindex.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace Csdr;
+
+// noise floor histogram: 0.5 dB buckets from -200 dB upwards
+#define OCCUPANCY_HISTOGRAM_MIN -200.0f
+#define OCCUPANCY_HISTOGRAM_RESOLUTION 0.5f
+#define OCCUPANCY_HISTOGRAM_SIZE 512
+#define OCCUPANCY_MAX_CARRIERS 1024
+
+OccupancyIndex::OccupancyIndex(unsigned int fftSize, float averaging, float threshold):
+    fftSize(fftSize),
+    averaging(averaging),
+    threshold(threshold),
+    histogram(OCCUPANCY_HISTOGRAM_SIZE)
+{
+    for (auto& slot: slots) {
+        slot.snapshot.spectrum.resize(fftSize);
+        slot.snapshot.carriers.reserve(OCCUPANCY_MAX_CARRIERS);
+    }
+}
+
+OccupancyIndex::OccupancyIndex(unsigned int fftSize): OccupancyIndex(fftSize, 0.1f, 10.0f) {}
+
+bool OccupancyIndex::canProcess() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    return reader->available() >= fftSize && writer->writeable() >= fftSize;
+}
+
+void OccupancyIndex::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    float* input = reader->getReadPointer();
+    updateLine(input);
+    std::memcpy(writer->getWritePointer(), input, sizeof(float) * fftSize);
+    reader->advance(fftSize);
+    writer->advance(fftSize);
+}
+
+unsigned int OccupancyIndex::getFftSize() {
+    return fftSize;
+}
+
+void OccupancyIndex::setAveraging(float averaging) {
+    this->averaging = averaging;
+}
+
+void OccupancyIndex::setThreshold(float threshold) {
+    this->threshold = threshold;
+}
+
+void OccupancyIndex::update(const float* line) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    updateLine(line);
+}
+
+CSDR_TARGET_CLONES
+static void exponentialAverage(const float* previous, const float* line, float* output, size_t size, float averaging) {
+    for (size_t i = 0; i < size; i++) {
+        output[i] = previous[i] + averaging * (line[i] - previous[i]);
+    }
+}
+
+void OccupancyIndex::updateLine(const float* line) {
+    int previous = current.load();
+
+    // any slot that is neither published nor held by a reader can be written. a reader that picks up the slot
+    // concurrently will notice that it is not the current one anymore and back off.
+    int target = -1;
+    for (int i = 0; i < OCCUPANCY_INDEX_SLOTS; i++) {
+        if (i != previous && slots[i].readers.load() == 0) {
+            target = i;
+            break;
+        }
+    }
+    if (target < 0) return;
+
+    OccupancySnapshot& snapshot = slots[target].snapshot;
+    if (previous < 0) {
+        std::memcpy(snapshot.spectrum.data(), line, sizeof(float) * fftSize);
+    } else {
+        exponentialAverage(slots[previous].snapshot.spectrum.data(), line, snapshot.spectrum.data(), fftSize, averaging);
+    }
+    snapshot.noiseFloor = estimateNoiseFloor(snapshot.spectrum.data());
+    detectCarriers(snapshot);
+    snapshot.sequence = ++sequence;
+
+    current.store(target);
+}
+
+float OccupancyIndex::estimateNoiseFloor(const float* spectrum) {
+    // median of the averaged spectrum. this is robust as long as less than half of the band is occupied, and a
+    // histogram is a lot cheaper than sorting for large FFTs.
+    std::fill(histogram.begin(), histogram.end(), 0);
+    for (unsigned int i = 0; i < fftSize; i++) {
+        // argument order matters: this also maps NaN and -inf (empty bins) to the lowest bucket
+        float position = std::max(0.0f, (spectrum[i] - OCCUPANCY_HISTOGRAM_MIN) * (1.0f / OCCUPANCY_HISTOGRAM_RESOLUTION));
+        histogram[(int) std::min(position, (float) (OCCUPANCY_HISTOGRAM_SIZE - 1))]++;
+    }
+    unsigned int remaining = fftSize / 2;
+    int bucket = 0;
+    for (; bucket < OCCUPANCY_HISTOGRAM_SIZE - 1; bucket++) {
+        if (histogram[bucket] > remaining) break;
+        remaining -= histogram[bucket];
+    }
+    return OCCUPANCY_HISTOGRAM_MIN + (bucket + 0.5f) * OCCUPANCY_HISTOGRAM_RESOLUTION;
+}
+
+void OccupancyIndex::detectCarriers(OccupancySnapshot& snapshot) {
+    snapshot.carriers.clear();
+    const float* spectrum = snapshot.spectrum.data();
+    float level = snapshot.noiseFloor + threshold;
+    unsigned int i = 0;
+    while (i < fftSize && snapshot.carriers.size() < OCCUPANCY_MAX_CARRIERS) {
+        if (spectrum[i] < level) {
+            i++;
+            continue;
+        }
+        OccupancyCarrier carrier = { i, i, i, spectrum[i] };
+        for (; i < fftSize && spectrum[i] >= level; i++) {
+            if (spectrum[i] > carrier.level) {
+                carrier.level = spectrum[i];
+                carrier.peak = i;
+            }
+        }
+        carrier.end = i;
+        snapshot.carriers.push_back(carrier);
+    }
+}
+
+const OccupancySnapshot* OccupancyIndex::acquire() {
+    while (true) {
+        int index = current.load();
+        if (index < 0) return nullptr;
+        slots[index].readers++;
+        // the writer may have moved on (and started to reuse the slot) in the meantime
+        if (current.load() == index) return &slots[index].snapshot;
+        slots[index].readers--;
+    }
+}
+
+void OccupancyIndex::release(const OccupancySnapshot* snapshot) {
+    for (auto& slot: slots) {
+        if (&slot.snapshot == snapshot) {
+            slot.readers--;
+            return;
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "polyphasefft.hpp"
+#include "fftplanner.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+
+using namespace Csdr;
+
+PolyphaseWindow::PolyphaseWindow(unsigned int fftSize, unsigned int taps, Window* window): fftSize(fftSize), taps(taps) {
+    if (taps < 1) {
+        throw std::runtime_error("polyphase window needs at least one tap per bin");
+    }
+    std::string key = "polyphase " + std::to_string(fftSize) + " " + std::to_string(taps) + " " + window->getKey();
+    table = TapCache::get<float>(key, [fftSize, taps, window] () {
+        unsigned int length = fftSize * taps;
+        auto coefficients = (float*) malloc(sizeof(float) * length * 2);
+
+        // scale to the same coherent gain as a plain window of fftSize, so levels stay comparable to Fft
+        double windowGain = 0;
+        for (unsigned int i = 0; i < fftSize; i++) {
+            windowGain += window->kernel(2.0 * i / (fftSize - 1) + 1.0);
+        }
+
+        double gain = 0;
+        double center = (length - 1) / 2.0;
+        for (unsigned int i = 0; i < length; i++) {
+            // sinc lowpass with a cutoff of half a bin on either side
+            double x = M_PI * (i - center) / fftSize;
+            double sinc = x == 0 ? 1.0 : sin(x) / x;
+            double coefficient = sinc * window->kernel(2.0 * i / (length - 1) + 1.0);
+            coefficients[2 * i] = coefficients[2 * i + 1] = coefficient;
+            gain += coefficient;
+        }
+
+        float scale = windowGain / gain;
+        for (unsigned int i = 0; i < length * 2; i++) {
+            coefficients[i] *= scale;
+        }
+        return new Taps<float>(coefficients, length * 2);
+    });
+    coefficients = table->getData();
+    // needed for every frame that is measured, see BandPowerTap
+    for (unsigned int i = 0; i < fftSize * taps; i++) {
+        power += coefficients[2 * i] * coefficients[2 * i];
+    }
+}
+
+unsigned int PolyphaseWindow::getLength() {
+    return fftSize * taps;
+}
+
+float PolyphaseWindow::getPower() {
+    return power;
+}
+
+CSDR_TARGET_CLONES
+void PolyphaseWindow::apply(complex<float>* input, complex<float>* output) {
+    // complex samples are processed as interleaved floats
+    auto in = (float*) input;
+    auto out = (float*) output;
+    unsigned int width = fftSize * 2;
+    for (unsigned int i = 0; i < width; i++) {
+        out[i] = in[i] * coefficients[i];
+    }
+    for (unsigned int tap = 1; tap < taps; tap++) {
+        float* segment = in + tap * width;
+        const float* weights = coefficients + tap * width;
+        for (unsigned int i = 0; i < width; i++) {
+            out[i] += segment[i] * weights[i];
+        }
+    }
+}
+
+PolyphaseFft::PolyphaseFft(unsigned int fftSize, unsigned int taps, unsigned int everyNSamples, Window* window, unsigned int threads):
+    fftSize(fftSize),
+    everyNSamples(everyNSamples)
+{
+    this->window = new PolyphaseWindow(fftSize, taps, window);
+    folded = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    output_buffer = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    plan = FftPlanner::planDft(fftSize, folded, output_buffer, threads);
+}
+
+PolyphaseFft::~PolyphaseFft() {
+    free(folded);
+    free(output_buffer);
+    delete window;
+    FftPlanner::destroy(plan);
+}
+
+bool PolyphaseFft::canProcess() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    return reader->available() > window->getLength() && writer->writeable() > fftSize;
+}
+
+void PolyphaseFft::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    size_t available = reader->available();
+    // frame alignment works exactly like in Fft, only the frames are longer
+    if (skipped + available >= everyNSamples) {
+        if (everyNSamples > skipped) {
+            unsigned int toSkip = everyNSamples - skipped;
+            reader->advance(toSkip);
+            skipped += toSkip;
+            available -= toSkip;
+        }
+
+        if (available >= window->getLength()) {
+            window->apply(reader->getReadPointer(), folded);
+            fftwf_execute(plan);
+            if (powerTap != nullptr) {
+                powerTap->measure(output_buffer, fftSize, fftSize * window->getPower());
+            }
+            std::memcpy(writer->getWritePointer(), output_buffer, sizeof(complex<float>) * fftSize);
+            writer->advance(fftSize);
+
+            skipped = 0;
+        }
+    } else {
+        // drop data
+        reader->advance(available);
+        skipped += available;
+    }
+}
+
+void PolyphaseFft::setEveryNSamples(unsigned int everyNSamples) {
+    this->everyNSamples = everyNSamples;
+}
+
+void PolyphaseFft::setPowerTap(BandPowerTap* powerTap) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    this->powerTap = powerTap;
+}
+
+void PolyphaseFft::setThreads(unsigned int threads) {
+    // measuring a large plan takes a while, so it is made on new buffers while processing continues
+    auto newFolded = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    auto newOutput = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    fftwf_plan newPlan = FftPlanner::planDft(fftSize, newFolded, newOutput, threads);
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        std::swap(plan, newPlan);
+        std::swap(folded, newFolded);
+        std::swap(output_buffer, newOutput);
+    }
+    FftPlanner::destroy(newPlan);
+    free(newFolded);
+    free(newOutput);
+}
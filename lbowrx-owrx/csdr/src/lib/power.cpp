@@ -18,13 +18,32 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "power.hpp"
+#include "fmv.h"
 
 #include <cstring>
+#include <cmath>
 #include <utility>
 
 using namespace Csdr;
 
-Power::Power(unsigned int decimation, std::function<void(float)> callback): decimation(decimation), callback(std::move(callback)) {}
+CSDR_TARGET_CLONES
+static float blockPower(const complex<float>* input, size_t length, unsigned int decimation) {
+    float acc = 0.0f;
+    if (decimation == 1) {
+        // contiguous case, reduces to a sum of squares over the interleaved floats
+        const float* in = (const float*) input;
+        for (size_t i = 0; i < length * 2; i++) {
+            acc += in[i] * in[i];
+        }
+        return acc / length;
+    }
+    for (size_t i = 0; i < length; i += decimation) {
+        acc += std::norm(input[i]);
+    }
+    return acc / ceilf((float) length / decimation);
+}
+
+Power::Power(unsigned int decimation, std::function<void(float)> callback): decimation(decimation > 0 ? decimation : 1), callback(std::move(callback)) {}
 
 bool Power::canProcess() {
     std::lock_guard<std::mutex> lock(processMutex);
@@ -34,25 +53,34 @@ bool Power::canProcess() {
 
 void Power::process() {
     std::lock_guard<std::mutex> lock(processMutex);
-    complex<float>* input = reader->getReadPointer();
     size_t length = getLength();
 
-    float acc = 0;
-    for (size_t i = 0; i < length; i += decimation){
-        acc += std::norm(input[i]);
-    }
-    float power = acc / ceilf((float) length / decimation);
-    callback(power);
-    // pass data
-    forwardData(input, power);
+    while (reader->available() > length && writer->writeable() > length) {
+        complex<float>* input = reader->getReadPointer();
+        float power = blockPower(input, length, decimation);
+
+        reportAccumulator += power;
+        if (++reportBlocks >= reportInterval) {
+            callback(reportAccumulator / reportBlocks);
+            reportAccumulator = 0.0f;
+            reportBlocks = 0;
+        }
 
-    reader->advance(length);
+        // pass data
+        forwardData(input, power);
+
+        reader->advance(length);
+    }
 }
 
 size_t Power::getLength() {
     return 1024;
 }
 
+void Power::setReportInterval(unsigned int reportInterval) {
+    this->reportInterval = reportInterval > 0 ? reportInterval : 1;
+}
+
 void Power::forwardData(complex<float>* input, float power) {
     complex<float>* output = writer->getWritePointer();
     size_t length = getLength();
@@ -64,8 +92,30 @@ void Squelch::setSquelch(float squelchLevel) {
     this->squelchLevel = squelchLevel;
 }
 
+void Squelch::setHysteresis(float hysteresis) {
+    this->hysteresis = hysteresis > 1.0f ? hysteresis : 1.0f;
+}
+
+void Squelch::setHoldTime(unsigned int holdTime) {
+    this->holdTime = holdTime;
+}
+
 void Squelch::forwardData(complex<float> *input, float power) {
     if (squelchLevel == 0 || power >= squelchLevel) {
+        open = true;
+        holdRemaining = holdTime;
+    } else if (open && power >= squelchLevel / hysteresis) {
+        // the hold time only counts while the power stays below the lower threshold
+        holdRemaining = holdTime;
+    } else if (open) {
+        if (holdRemaining > 0) {
+            holdRemaining--;
+        } else {
+            open = false;
+        }
+    }
+
+    if (open) {
         Power::forwardData(input, power);
         flushCounter = 0;
     } else if (flushCounter < 5) {
@@ -77,4 +127,4 @@ void Squelch::forwardData(complex<float> *input, float power) {
         // increment inside because an unsigned char would overflow soon...
         flushCounter++;
     }
-}
\ No newline at end of file
+}
@@ -19,6 +19,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "reader.hpp"
 #include "complex.hpp"
+#include "half.hpp"
 
 using namespace Csdr;
 
@@ -54,4 +55,7 @@ namespace Csdr {
     template class MemoryReader<complex<float>>;
     template class MemoryReader<float>;
     template class MemoryReader<short>;
+    template class MemoryReader<complex<short>>;
+    template class MemoryReader<complex<half>>;
+    template class MemoryReader<unsigned char>;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "ringbuffer.hpp"
 #include "complex.hpp"
+#include "half.hpp"
 
 #include <sys/mman.h>
 
@@ -241,6 +242,9 @@ namespace Csdr {
     template class Ringbuffer<complex<short>>;
     template class RingbufferReader<complex<short>>;
 
+    template class Ringbuffer<complex<half>>;
+    template class RingbufferReader<complex<half>>;
+
     template class Ringbuffer<complex<float>>;
     template class RingbufferReader<complex<float>>;
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "shift.hpp"
+#include "converter.hpp"
 #include "fmv.h"
 
 #include <cmath>
@@ -42,11 +43,13 @@ void Shift::setRate(float rate) {
     this->rate = rate;
 }
 
-ShiftAddfast::ShiftAddfast(float rate): Shift(rate) {
-    ShiftAddfast::setRate(rate);
+template <typename T>
+ShiftAddfast<T>::ShiftAddfast(float rate): Shift(rate) {
+    ShiftAddfast<T>::setRate(rate);
 }
 
-void ShiftAddfast::setRate(float rate) {
+template <typename T>
+void ShiftAddfast<T>::setRate(float rate) {
     Shift::setRate(rate);
     phase_increment = 2.0f * rate * M_PI;
     for (int i = 0; i < 4; i++) {
@@ -57,16 +60,20 @@ void ShiftAddfast::setRate(float rate) {
 
 #define SADF_L1(j) cos_vals_ ## j = cos_start * dcos_ ## j - sin_start * dsin_ ## j; \
     sin_vals_ ## j = sin_start * dcos_ ## j + cos_start * dsin_ ## j;
-#define SADF_L2(j) output[4 * i + j].i((cos_vals_ ## j) * input[4 * i + j].i() - (sin_vals_ ## j) * input[4 * i + j].q()); \
-    output[4 * i + j].q((sin_vals_ ## j) * input[4 * i + j].i() + (cos_vals_ ## j) * input[4 * i + j].q());
+#define SADF_L2(j) in_i = convertSample<typename T::value_type, float>(input[4 * i + j].i()); \
+    in_q = convertSample<typename T::value_type, float>(input[4 * i + j].q()); \
+    output[4 * i + j].i((cos_vals_ ## j) * in_i - (sin_vals_ ## j) * in_q); \
+    output[4 * i + j].q((sin_vals_ ## j) * in_i + (cos_vals_ ## j) * in_q);
 
-void ShiftAddfast::process(complex<float>* input, complex<float>* output) {
+template <typename T>
+void ShiftAddfast<T>::process(T* input, complex<float>* output) {
     // indirection since FMV on virtual functions does not work...
     process_fmv(input, output, 1024);
 }
 
+template <typename T>
 CSDR_TARGET_CLONES
-void ShiftAddfast::process_fmv(complex<float>* input, complex<float>* output, size_t size) {
+void ShiftAddfast<T>::process_fmv(T* input, complex<float>* output, size_t size) {
     //input_size should be multiple of 4
     float cos_start = cos(starting_phase);
     float sin_start = sin(starting_phase);
@@ -74,6 +81,7 @@ void ShiftAddfast::process_fmv(complex<float>* input, complex<float>* output, si
         sin_vals_0, sin_vals_1, sin_vals_2, sin_vals_3,
         dsin_0 = dsin[0], dsin_1 = dsin[1], dsin_2 = dsin[2], dsin_3 = dsin[3],
         dcos_0 = dcos[0], dcos_1 = dcos[1], dcos_2 = dcos[2], dcos_3 = dcos[3];
+    float in_i, in_q;
 
     for (int i = 0; i < size / 4; i++) {
         SADF_L1(0)
@@ -121,3 +129,9 @@ void ShiftMath::process_fmv(complex<float>* input, complex<float>* output, size_
     while (phase < 0) phase += 2 * M_PI;
 
 }
+
+namespace Csdr {
+    template class ShiftAddfast<complex<float>>;
+    template class ShiftAddfast<complex<short>>;
+    template class ShiftAddfast<complex<half>>;
+}
@@ -18,6 +18,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "sink.hpp"
+#include "half.hpp"
 
 using namespace Csdr;
 
@@ -44,7 +45,9 @@ bool Sink<T>::hasReader() {
 namespace Csdr {
     template class Sink<short>;
     template class Sink<float>;
+    template class Sink<complex<unsigned char>>;
     template class Sink<complex<short>>;
+    template class Sink<complex<half>>;
     template class Sink<complex<float>>;
     template class Sink<unsigned char>;
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "source.hpp"
+#include "half.hpp"
 
 #include <cstring>
 #include <unistd.h>
@@ -105,13 +106,17 @@ void TcpSource<T>::stop() {
 namespace Csdr {
     template class Source<float>;
     template class Source<short>;
+    template class Source<complex<unsigned char>>;
     template class Source<complex<short>>;
+    template class Source<complex<half>>;
     template class Source<complex<float>>;
     template class Source<unsigned char>;
 
     template class TcpSource<unsigned char>;
     template class TcpSource<short>;
     template class TcpSource<float>;
+    template class TcpSource<complex<unsigned char>>;
     template class TcpSource<complex<short>>;
+    template class TcpSource<complex<half>>;
     template class TcpSource<complex<float>>;
 }
\ No newline at end of file
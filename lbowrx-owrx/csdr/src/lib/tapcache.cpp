@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tapcache.hpp"
+
+#include <map>
+#include <mutex>
+
+using namespace Csdr;
+
+struct TapCacheEntry {
+    std::weak_ptr<void> entry;
+    size_t bytes;
+};
+
+static std::mutex mutex;
+static std::map<std::string, TapCacheEntry> entries;
+
+static void purge() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.entry.expired()) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::shared_ptr<void> TapCache::lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) return nullptr;
+    return it->second.entry.lock();
+}
+
+std::shared_ptr<void> TapCache::insert(const std::string& key, std::shared_ptr<void> entry, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        auto existing = it->second.entry.lock();
+        if (existing != nullptr) return existing;
+    }
+    // expired entries are only cleaned up here, so the map can't grow beyond the number of keys used at a time
+    purge();
+    entries[key] = { entry, bytes };
+    return entry;
+}
+
+size_t TapCache::getEntries() {
+    std::lock_guard<std::mutex> lock(mutex);
+    purge();
+    return entries.size();
+}
+
+size_t TapCache::getMemoryUsage() {
+    std::lock_guard<std::mutex> lock(mutex);
+    purge();
+    size_t bytes = 0;
+    for (auto& it: entries) bytes += it.second.bytes;
+    return bytes;
+}
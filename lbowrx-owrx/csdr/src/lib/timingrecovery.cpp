@@ -31,79 +31,97 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "timingrecovery.hpp"
 
+#include <cmath>
+
 using namespace Csdr;
 
-TimingRecovery::TimingRecovery(unsigned int decimation, float loop_gain, float max_error, bool use_q):
+TimingRecovery::TimingRecovery(float decimation, float loop_gain, float max_error, bool use_q):
     decimation(decimation),
     loop_gain(loop_gain),
     max_error(max_error),
     use_q(use_q)
 {}
 
+size_t TimingRecovery::getWindowLength() {
+    // the window reaches 1.5 symbols, plus one sample in front and two behind for the interpolation
+    return (size_t) (decimation * 3 / 2) + 4;
+}
+
 bool TimingRecovery::canProcess() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    return reader->available() > (decimation / 2) * 3 && writer->writeable() > 0;
+    return reader->available() > getWindowLength() && writer->writeable() > 0;
 }
 
 void TimingRecovery::process() {
     std::lock_guard<std::mutex> lock(this->processMutex);
     //We always assume that the input starts at center of the first symbol cross before the first symbol.
     //Last time we consumed that much from the input samples that it is there.
-    unsigned int num_samples_bit = decimation;
-    unsigned int num_samples_halfbit = decimation / 2;
-    unsigned int num_samples_quarterbit = decimation / 4;
-
-    if (correction_offset <= 0.9 * -num_samples_quarterbit || correction_offset >= 0.9 * num_samples_quarterbit) {
-        correction_offset = 0;
+    float num_samples_halfbit = decimation / 2;
+    float num_samples_quarterbit = decimation / 4;
+
+    while (reader->available() > getWindowLength() && writer->writeable() > 0) {
+        if (correction_offset <= 0.9f * -num_samples_quarterbit || correction_offset >= 0.9f * num_samples_quarterbit) {
+            correction_offset = 0;
+        }
+
+        //should check if the sign of the correction_offset (or disabling it) has an effect on the EVM.
+        //it is also a possibility to disable multiplying with the magnitude
+        float error = getError(reader->getReadPointer(), *(writer->getWritePointer()));
+        writer->advance(1);
+
+        if (error > max_error) error = max_error;
+        if (error < -max_error) error = -max_error;
+
+        correction_offset = num_samples_halfbit * getErrorSign() * error * loop_gain;
+        // never step back more than half a symbol, regardless of the loop parameters
+        if (correction_offset < -num_samples_halfbit) correction_offset = -num_samples_halfbit;
+        if (correction_offset > num_samples_halfbit) correction_offset = num_samples_halfbit;
+
+        float next = fraction + decimation + correction_offset;
+        auto advance = (size_t) next;
+        fraction = next - advance;
+        reader->advance(advance);
     }
+}
 
-    //should check if the sign of the correction_offset (or disabling it) has an effect on the EVM.
-    //it is also a possibility to disable multiplying with the magnitude
-    float error = getError();
-
-    if (error > max_error) error = max_error;
-    if (error < -max_error) error = -max_error;
-
-    correction_offset = (int) num_samples_halfbit * getErrorSign() * error * loop_gain;
-
-    reader->advance(num_samples_bit + correction_offset);
+complex<float> TimingRecovery::interpolate(complex<float>* input, float position) {
+    // one sample of margin in front of the window
+    float p = 1.0f + fraction + position;
+    auto n = (size_t) p;
+    float mu = p - n;
+    // 4 point lagrange interpolation between input[n] and input[n + 1]
+    float hm1 = -mu * (mu - 1.0f) * (mu - 2.0f) / 6.0f;
+    float h0 = (mu + 1.0f) * (mu - 1.0f) * (mu - 2.0f) / 2.0f;
+    float h1 = -(mu + 1.0f) * mu * (mu - 2.0f) / 2.0f;
+    float h2 = (mu + 1.0f) * mu * (mu - 1.0f) / 6.0f;
+    return input[n - 1] * hm1 + input[n] * h0 + input[n + 1] * h1 + input[n + 2] * h2;
 }
 
-float TimingRecovery::calculateError(int el_point_right_index, int el_point_left_index, int el_point_mid_index) {
-    complex<float>* input = reader->getReadPointer();
-    float error = (input[el_point_right_index].i() - input[el_point_left_index].i()) * input[el_point_mid_index].i();
+float TimingRecovery::calculateError(const complex<float>& right, const complex<float>& left, const complex<float>& mid) {
+    float error = (right.i() - left.i()) * mid.i();
     if (use_q) {
-        error = (input[el_point_right_index].q() - input[el_point_left_index].q()) * input[el_point_mid_index].q();
+        error += (right.q() - left.q()) * mid.q();
         error /= 2;
     }
     return error;
 }
 
-float GardnerTimingRecovery::getError() {
-    complex<float>* input = reader->getReadPointer();
+float GardnerTimingRecovery::getError(complex<float>* input, complex<float>& symbol) {
     //maximum effect point is at current_bitstart_index
-    int num_samples_halfbit = decimation / 2;
+    float num_samples_halfbit = decimation / 2;
 
-    int el_point_right_index  = num_samples_halfbit * 3;
-    int el_point_left_index   = num_samples_halfbit * 1;
-    int el_point_mid_index    = num_samples_halfbit * 2;
-    *(writer->getWritePointer()) = input[el_point_left_index];
-    writer->advance(1);
+    complex<float> left = interpolate(input, num_samples_halfbit);
+    symbol = left;
 
-    return calculateError(el_point_right_index, el_point_left_index, el_point_mid_index);
+    return calculateError(interpolate(input, num_samples_halfbit * 3), left, interpolate(input, num_samples_halfbit * 2));
 }
 
-float EarlyLateTimingRecovery::getError() {
-    complex<float>* input = reader->getReadPointer();
-    int num_samples_bit = decimation;
-    int num_samples_halfbit = decimation / 2;
-    int num_samples_earlylate_wing = num_samples_bit * earlylate_ratio;
+float EarlyLateTimingRecovery::getError(complex<float>* input, complex<float>& symbol) {
+    float num_samples_halfbit = decimation / 2;
+    float num_samples_earlylate_wing = decimation * earlylate_ratio;
 
-    int el_point_right_index  = num_samples_earlylate_wing * 3;
-    int el_point_left_index   = num_samples_earlylate_wing - correction_offset;
-    int el_point_mid_index    = num_samples_halfbit;
-    *(writer->getWritePointer()) = input[el_point_mid_index];
-    writer->advance(1);
+    complex<float> mid = interpolate(input, num_samples_halfbit);
+    symbol = mid;
 
-    return calculateError(el_point_right_index, el_point_left_index, el_point_mid_index);
-}
\ No newline at end of file
+    return calculateError(interpolate(input, num_samples_earlylate_wing * 3), interpolate(input, num_samples_earlylate_wing - correction_offset), mid);
+}
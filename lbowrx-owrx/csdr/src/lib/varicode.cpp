@@ -31,9 +31,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "varicode.hpp"
 
+#include <vector>
+#include <algorithm>
+
 using namespace Csdr;
 
 constexpr varicode_item VaricodeDecoder::varicode_items[];
+constexpr unsigned int VaricodeDecoder::MAX_BITS;
+
+const short* VaricodeDecoder::getLookupTable() {
+    static const std::vector<short> table = [] () {
+        std::vector<short> table(1 << MAX_BITS, -1);
+        for (auto item: varicode_items) {
+            table[item.code] = item.ascii;
+        }
+        return table;
+    }();
+    return table.data();
+}
 
 bool VaricodeDecoder::canProcess() {
     std::lock_guard<std::mutex> lock(this->processMutex);
@@ -42,18 +57,36 @@ bool VaricodeDecoder::canProcess() {
 
 void VaricodeDecoder::process() {
     std::lock_guard<std::mutex> lock(this->processMutex);
-    unsigned char symbol = *(reader->getReadPointer());
-    reader->advance(1);
+    const short* table = getLookupTable();
+    const unsigned int invalid = 1 << MAX_BITS;
+    // at most one character per bit
+    size_t length = std::min(reader->available(), writer->writeable());
+    unsigned char* input = reader->getReadPointer();
+    unsigned char* output = writer->getWritePointer();
+    size_t produced = 0;
 
-    status = (status << 1) | (symbol & 0b1); //shift new bit in shift register
-
-    if ((status & 0xFFF) == 0) return;
-
-    for (auto item: varicode_items) {
-        unsigned long long mask = (1 << (item.bitcount + 4)) - 1;
-        if ((item.code << 2) == (status & mask)) {
-            *(writer->getWritePointer()) = item.ascii;
-            writer->advance(1);
+    for (size_t i = 0; i < length; i++) {
+        if (input[i] & 0b1) {
+            if (zeros >= 2) {
+                // start of a new character
+                code = 1;
+            } else {
+                // a single 0 is part of the code
+                code = (code << (zeros + 1)) | 1;
+            }
+            if (code > invalid) code = invalid;
+            zeros = 0;
+        } else if (++zeros == 2 && code != 0) {
+            // end of the character
+            if (code < invalid && table[code] >= 0) {
+                output[produced++] = (unsigned char) table[code];
+            }
+            code = 0;
         }
+        // prevent overflow during long pauses
+        if (zeros > 2) zeros = 2;
     }
+
+    reader->advance(length);
+    writer->advance(produced);
 }
@@ -0,0 +1,289 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "waterfallengine.hpp"
+#include "decibel.hpp"
+#include "fftplanner.hpp"
+#include "fmv.h"
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+using namespace Csdr;
+
+template <typename T>
+WaterfallEngine<T>::WaterfallEngine(unsigned int fftSize, unsigned int everyNSamples, unsigned int avgNumber, float add_db, Window* window, unsigned int levels, PyramidMode pyramidMode, unsigned int taps):
+    fftSize(fftSize),
+    everyNSamples(everyNSamples),
+    avgNumber(avgNumber),
+    add_db(add_db),
+    levels(levels),
+    pyramidMode(pyramidMode)
+{
+    // every level needs to halve evenly, and the ADPCM codec works on pairs of bins
+    if (levels < 1 || levels > 16 || (fftSize >> (levels - 1)) < 2 || fftSize % (1 << levels) != 0) {
+        throw std::runtime_error("invalid number of waterfall levels");
+    }
+    // same allocation and planning as in Fft, so the FFT output is bit-identical
+    windowed = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    spectrum = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    plan = FftPlanner::planDft(fftSize, windowed, spectrum, 1);
+    collector = (float*) malloc(sizeof(float) * fftSize);
+    this->window = window->precalculate(fftSize);
+    if (taps > 1) {
+        polyphase = new PolyphaseWindow(fftSize, taps, window);
+    }
+    if (levels > 1) {
+        // N/2 + N/4 + ... always fits into N
+        pyramid = (float*) malloc(sizeof(float) * fftSize);
+    }
+}
+
+template <typename T>
+WaterfallEngine<T>::WaterfallEngine(unsigned int fftSize, unsigned int everyNSamples, unsigned int avgNumber, float add_db, Window* window):
+    WaterfallEngine(fftSize, everyNSamples, avgNumber, add_db, window, 1, PYRAMID_MAX)
+{}
+
+template <typename T>
+WaterfallEngine<T>::~WaterfallEngine() {
+    free(windowed);
+    free(spectrum);
+    free(collector);
+    free(pyramid);
+    delete window;
+    delete polyphase;
+    FftPlanner::destroy(plan);
+}
+
+template <typename T>
+bool WaterfallEngine<T>::canProcess() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    return this->reader->available() > getInputLength() && this->writer->writeable() > getOutputSize();
+}
+
+template <typename T>
+void WaterfallEngine<T>::process() {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    size_t available = this->reader->available();
+    // frame alignment works exactly like in Fft
+    if (skipped + available >= everyNSamples) {
+        if (everyNSamples > skipped) {
+            unsigned int toSkip = everyNSamples - skipped;
+            this->reader->advance(toSkip);
+            skipped += toSkip;
+            available -= toSkip;
+        }
+
+        if (available >= getInputLength()) {
+            if (polyphase != nullptr) {
+                polyphase->apply(this->reader->getReadPointer(), windowed);
+            } else {
+                window->apply(this->reader->getReadPointer(), windowed, fftSize);
+            }
+            fftwf_execute(plan);
+            if (powerTap != nullptr) {
+                float power = polyphase != nullptr ? polyphase->getPower() : window->getPower();
+                powerTap->measure(spectrum, fftSize, fftSize * power);
+            }
+            collect(spectrum);
+
+            if (++collected >= avgNumber) {
+                emit(this->writer->getWritePointer());
+                this->writer->advance(getOutputSize());
+                collected = 0;
+            }
+
+            skipped = 0;
+        }
+    } else {
+        // drop data
+        this->reader->advance(available);
+        skipped += available;
+    }
+}
+
+template <typename T>
+CSDR_TARGET_CLONES
+void WaterfallEngine<T>::collect(complex<float>* input) {
+    unsigned int half = fftSize / 2;
+    // exchange sides while collecting: the lower half of the spectrum goes to the upper half of the line and vice versa
+    float* lower = collector + half;
+    float* upper = collector;
+    complex<float>* secondHalf = input + half;
+    if (collected == 0) {
+        // first FFT of a line overwrites, so the collector never needs to be cleared
+        for (unsigned int i = 0; i < half; i++) {
+            lower[i] = input[i].i() * input[i].i() + input[i].q() * input[i].q();
+        }
+        for (unsigned int i = 0; i < half; i++) {
+            upper[i] = secondHalf[i].i() * secondHalf[i].i() + secondHalf[i].q() * secondHalf[i].q();
+        }
+    } else {
+        for (unsigned int i = 0; i < half; i++) {
+            lower[i] += input[i].i() * input[i].i() + input[i].q() * input[i].q();
+        }
+        for (unsigned int i = 0; i < half; i++) {
+            upper[i] += secondHalf[i].i() * secondHalf[i].i() + secondHalf[i].q() * secondHalf[i].q();
+        }
+    }
+}
+
+template <typename T>
+CSDR_TARGET_CLONES
+void WaterfallEngine<T>::decimate(float* input, float* output, unsigned int size) {
+    unsigned int half = size / 2;
+    if (pyramidMode == PYRAMID_MAX) {
+        for (unsigned int i = 0; i < half; i++) {
+            output[i] = std::max(input[2 * i], input[2 * i + 1]);
+        }
+    } else {
+        for (unsigned int i = 0; i < half; i++) {
+            output[i] = 0.5f * (input[2 * i] + input[2 * i + 1]);
+        }
+    }
+}
+
+template <typename T>
+void WaterfallEngine<T>::emit(T* output) {
+    float correction = add_db - 10.0 * log10(std::max(avgNumber, 1u));
+
+    // the pyramid has to be built from the power values before any of them are converted
+    float* level = collector;
+    float* next = pyramid;
+    unsigned int size = fftSize;
+    for (unsigned int i = 1; i < levels; i++) {
+        decimate(level, next, size);
+        level = next;
+        next += size / 2;
+        size /= 2;
+    }
+
+    level = collector;
+    size = fftSize;
+    for (unsigned int i = 0; i < levels; i++) {
+        size_t written = emitLevel(level, size, correction, output);
+        if (i == 0 && occupancyIndex != nullptr) {
+            occupancyIndex->update(getLevelDb(level, output));
+        }
+        output += written;
+        level = i == 0 ? pyramid : level + size;
+        size /= 2;
+    }
+}
+
+template <>
+size_t WaterfallEngine<float>::getLevelSize(unsigned int size) {
+    return size;
+}
+
+template <>
+size_t WaterfallEngine<unsigned char>::getLevelSize(unsigned int size) {
+    return (COMPRESS_FFT_PAD_N + size) / 2;
+}
+
+template <>
+size_t WaterfallEngine<float>::emitLevel(float* level, unsigned int size, float correction, float* output) {
+    powerToDb(level, output, size, correction);
+    return size;
+}
+
+template <>
+size_t WaterfallEngine<unsigned char>::emitLevel(float* level, unsigned int size, float correction, unsigned char* output) {
+    // the levels are overwritten by the next line anyway, so we can convert in place
+    powerToDb(level, level, size, correction);
+    codec.encodeFft(level, output, size);
+    return getLevelSize(size);
+}
+
+template <>
+float* WaterfallEngine<float>::getLevelDb(float* level, float* output) {
+    return output;
+}
+
+template <>
+float* WaterfallEngine<unsigned char>::getLevelDb(float* level, unsigned char* output) {
+    // converted in place by emitLevel()
+    return level;
+}
+
+template <typename T>
+unsigned int WaterfallEngine<T>::getInputLength() {
+    return polyphase != nullptr ? polyphase->getLength() : fftSize;
+}
+
+template <typename T>
+size_t WaterfallEngine<T>::getOutputSize() {
+    size_t total = 0;
+    for (unsigned int i = 0; i < levels; i++) {
+        total += getLevelSize(fftSize >> i);
+    }
+    return total;
+}
+
+template <typename T>
+void WaterfallEngine<T>::setEveryNSamples(unsigned int everyNSamples) {
+    this->everyNSamples = everyNSamples;
+}
+
+template <typename T>
+void WaterfallEngine<T>::setAvgNumber(unsigned int avgNumber) {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    // switching between averaging and plain power starts a new line, just like replacing the module would
+    if (avgNumber == 0 || this->avgNumber == 0) collected = 0;
+    this->avgNumber = avgNumber;
+}
+
+template <typename T>
+void WaterfallEngine<T>::setThreads(unsigned int threads) {
+    // measuring a large plan takes a while, so it is made on new buffers while processing continues
+    auto newWindowed = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    auto newSpectrum = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    fftwf_plan newPlan = FftPlanner::planDft(fftSize, newWindowed, newSpectrum, threads);
+    {
+        std::lock_guard<std::mutex> lock(this->processMutex);
+        std::swap(plan, newPlan);
+        std::swap(windowed, newWindowed);
+        std::swap(spectrum, newSpectrum);
+    }
+    FftPlanner::destroy(newPlan);
+    free(newWindowed);
+    free(newSpectrum);
+}
+
+template <typename T>
+void WaterfallEngine<T>::setPowerTap(BandPowerTap* powerTap) {
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    this->powerTap = powerTap;
+}
+
+template <typename T>
+void WaterfallEngine<T>::setOccupancyIndex(OccupancyIndex* occupancyIndex) {
+    if (occupancyIndex != nullptr && occupancyIndex->getFftSize() != fftSize) {
+        throw std::runtime_error("occupancy index size does not match the fft size");
+    }
+    std::lock_guard<std::mutex> lock(this->processMutex);
+    this->occupancyIndex = occupancyIndex;
+}
+
+namespace Csdr {
+    template class WaterfallEngine<float>;
+    template class WaterfallEngine<unsigned char>;
+}
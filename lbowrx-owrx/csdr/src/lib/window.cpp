@@ -31,7 +31,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "window.hpp"
 #include "complex.hpp"
+#include "converter.hpp"
 #include <cmath>
+#include <sstream>
+#include <typeinfo>
 
 using namespace Csdr;
 
@@ -51,34 +54,66 @@ template<> void Window::apply<complex<float>>(complex<float>* input, complex<flo
 }
 
 PrecalculatedWindow* Window::precalculate(size_t size) {
-    float *windowt;
-    windowt = (float*) malloc(sizeof(float) * size);
+    auto table = TapCache::get<float>("window " + getKey() + " " + std::to_string(size), [this, size] () {
+        float *windowt;
+        windowt = (float*) malloc(sizeof(float) * size);
+        for (size_t i = 0; i < size; i++) {
+            float rate = (float) i / (size-1);
+            windowt[i] = kernel(2.0 * rate + 1.0);
+        }
+        return new Taps<float>(windowt, size);
+    });
+    return new PrecalculatedWindow(table);
+}
+
+std::string Window::getKey() {
+    return typeid(*this).name();
+}
+
+PrecalculatedWindow::PrecalculatedWindow(std::shared_ptr<Taps<float>> windowt):
+    table(windowt),
+    windowt(windowt->getData()),
+    size(windowt->getLength())
+{
+    // needed for every frame that is measured, see BandPowerTap
     for (size_t i = 0; i < size; i++) {
-        float rate = (float) i / (size-1);
-        windowt[i] = kernel(2.0 * rate + 1.0);
+        power += this->windowt[i] * this->windowt[i];
     }
-    return new PrecalculatedWindow(windowt, size);
 }
 
-PrecalculatedWindow::PrecalculatedWindow(float* windowt, size_t size): windowt(windowt), size(size) {}
-
-PrecalculatedWindow::~PrecalculatedWindow() {
-    free(windowt);
+float PrecalculatedWindow::getPower() {
+    return power;
 }
 
-template<> void PrecalculatedWindow::apply<float>(float* input, float* output, size_t size) {
+template<> void PrecalculatedWindow::apply<float, float>(float* input, float* output, size_t size) {
 	for (size_t i = 0; i < size; i++) {
 		output[i] = input[i] * windowt[i];
 	}
 }
 
-template<> void PrecalculatedWindow::apply<complex<float>>(complex<float>* input, complex<float>* output, size_t size) {
+template<> void PrecalculatedWindow::apply<complex<float>, complex<float>>(complex<float>* input, complex<float>* output, size_t size) {
     for (size_t i = 0; i < size; i++) {
         output[i].i(input[i].i() * windowt[i]);
         output[i].q(input[i].q() * windowt[i]);
     }
 }
 
+template <typename T>
+static void applyConverting(T* input, complex<float>* output, const float* windowt, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        output[i].i(convertSample<typename T::value_type, float>(input[i].i()) * windowt[i]);
+        output[i].q(convertSample<typename T::value_type, float>(input[i].q()) * windowt[i]);
+    }
+}
+
+template<> void PrecalculatedWindow::apply<complex<short>, complex<float>>(complex<short>* input, complex<float>* output, size_t size) {
+    applyConverting(input, output, windowt, size);
+}
+
+template<> void PrecalculatedWindow::apply<complex<half>, complex<float>>(complex<half>* input, complex<float>* output, size_t size) {
+    applyConverting(input, output, windowt, size);
+}
+
 float BoxcarWindow::kernel(float rate) {
     //"Dummy" window kernel, do not use; an unwindowed FIR filter may have bad frequency response
     return 1.0;
@@ -97,3 +132,37 @@ float HammingWindow::kernel(float rate) {
     rate = 0.5 + rate / 2;
     return 0.54 - 0.46 * cos(2 * M_PI * rate);
 }
+
+KaiserWindow::KaiserWindow(float beta): b(beta), norm(bessel(beta)) {}
+
+float KaiserWindow::kernel(float rate) {
+    //Kaiser window: the stopband attenuation can be chosen by beta (see beta()), at the cost of a wider main lobe.
+    //The kernel repeats every 2, like the cosine windows above, so both [-1, 1] and [1, 3] cover the whole window.
+    double r = std::remainder((double) rate, 2.0);
+    double x = 1 - r * r;
+    return bessel(b * sqrt(x > 0 ? x : 0)) / norm;
+}
+
+float KaiserWindow::beta(float attenuation) {
+    //Empirical formula by Kaiser, see Oppenheim / Schafer, Discrete-Time Signal Processing
+    if (attenuation > 50) return 0.1102 * (attenuation - 8.7);
+    if (attenuation >= 21) return 0.5842 * pow(attenuation - 21, 0.4) + 0.07886 * (attenuation - 21);
+    return 0;
+}
+
+std::string KaiserWindow::getKey() {
+    std::ostringstream key;
+    key << Window::getKey() << " " << std::hexfloat << b;
+    return key.str();
+}
+
+double KaiserWindow::bessel(double x) {
+    //Modified Bessel function of the first kind, order 0 (power series)
+    double sum = 1, term = 1;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1E-12) break;
+    }
+    return sum;
+}
@@ -19,6 +19,7 @@ along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "writer.hpp"
 #include "complex.hpp"
+#include "half.hpp"
 
 #include <unistd.h>
 
@@ -82,6 +83,9 @@ namespace Csdr {
     template class StdoutWriter<unsigned char>;
     template class StdoutWriter<short>;
     template class StdoutWriter<float>;
+    template class StdoutWriter<complex<unsigned char>>;
+    template class StdoutWriter<complex<short>>;
+    template class StdoutWriter<complex<half>>;
     template class StdoutWriter<complex<float>>;
 
     template class VoidWriter<complex<float>>;
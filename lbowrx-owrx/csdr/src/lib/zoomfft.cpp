@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "zoomfft.hpp"
+#include "fftplanner.hpp"
+
+#include <cmath>
+#include <cstring>
+
+using namespace Csdr;
+
+ZoomFft::ZoomFft(float center, unsigned int decimation, unsigned int fftSize, unsigned int everyNSamples, Window* window):
+    center(center),
+    decimation(decimation),
+    fftSize(fftSize),
+    everyNSamples(everyNSamples)
+{
+    decimated = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    windowed = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    output_buffer = (complex<float>*) malloc(sizeof(complex<float>) * fftSize);
+    plan = FftPlanner::planDft(fftSize, windowed, output_buffer, 1);
+    this->window = window->precalculate(fftSize);
+    updateFilter();
+}
+
+ZoomFft::~ZoomFft() {
+    free(decimated);
+    free(windowed);
+    free(output_buffer);
+    delete window;
+    delete bandpass;
+    FftPlanner::destroy(plan);
+}
+
+void ZoomFft::updateFilter() {
+    // the edges of the zoomed spectrum show the filter rolloff, just like the edges of the full spectrum
+    // show the rolloff of the SDR hardware
+    float halfSpan = 0.5f / decimation;
+    auto filterWindow = new HammingWindow();
+    auto next = new BandPassFilter<complex<float>>(center - halfSpan, center + halfSpan, 0.2f / decimation, filterWindow);
+    delete filterWindow;
+    delete bandpass;
+    bandpass = next;
+}
+
+bool ZoomFft::canProcess() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    size_t available = reader->available();
+    size_t lpLen = bandpass->getOverhead();
+    return available > lpLen && (available - lpLen) / decimation > 0 && writer->writeable() >= fftSize;
+}
+
+void ZoomFft::process() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    size_t available = reader->available();
+    size_t lpLen = bandpass->getOverhead();
+
+    // see FirDecimate
+    if (available < lpLen) return;
+
+    size_t samples = (available - lpLen) / decimation;
+    size_t consumed = collect(reader->getReadPointer(), samples);
+    reader->advance(consumed * decimation);
+
+    if (filled < fftSize) return;
+
+    window->apply(decimated, windowed, fftSize);
+    fftwf_execute(plan);
+    std::memcpy(writer->getWritePointer(), output_buffer, sizeof(complex<float>) * fftSize);
+    writer->advance(fftSize);
+
+    if (everyNSamples < fftSize) {
+        // overlapping frames: keep the most recent samples for the next FFT
+        unsigned int keep = fftSize - everyNSamples;
+        std::memmove(decimated, decimated + everyNSamples, sizeof(complex<float>) * keep);
+        filled = keep;
+    } else {
+        filled = 0;
+        toSkip = everyNSamples - fftSize;
+    }
+}
+
+size_t ZoomFft::collect(complex<float>* input, size_t samples) {
+    // returns the number of decimated samples consumed; stops as soon as a frame is complete
+    SparseView<complex<float>> sparseView = bandpass->sparse(input);
+    // after decimation, the band has been aliased to the fractional part of center * decimation.
+    // rotating it down by that amount centers it at 0.
+    double alias = center * decimation - round(center * decimation);
+    double increment = -2.0 * M_PI * alias;
+    float sinval, cosval;
+    size_t i = 0;
+    for (; i < samples && filled < fftSize; i++) {
+        if (toSkip > 0) {
+            // no need to run the filter for samples that would be dropped anyway
+            toSkip--;
+        } else {
+            sincosf(phase, &sinval, &cosval);
+            decimated[filled++] = sparseView[i * decimation] * complex<float>(cosval, sinval);
+        }
+        phase += increment;
+        if (phase > M_PI) phase -= 2 * M_PI;
+        if (phase < -M_PI) phase += 2 * M_PI;
+    }
+    return i;
+}
+
+void ZoomFft::setCenter(float center) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    this->center = center;
+    updateFilter();
+}
+
+void ZoomFft::setEveryNSamples(unsigned int everyNSamples) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    this->everyNSamples = everyNSamples;
+}
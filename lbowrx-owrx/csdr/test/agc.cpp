@@ -0,0 +1,238 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "agc.hpp"
+#include "complex.hpp"
+
+#include <cmath>
+#include <random>
+#include <climits>
+#include <algorithm>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+// 60 seconds at 12 kS/s
+#define LENGTH (12000 * 60)
+// the input arrives in blocks of 20 ms, like it does in the demodulator chains
+#define CHUNK 240
+// the output levels are compared in windows of 10 ms
+#define WINDOW 120
+
+// the previous Agc implementation, updating the gain on every sample
+template <typename T>
+class SerialAgc {
+    public:
+        void process(T* input, T* output, size_t work_size) {
+            float dt = 0.5;
+            float beta = 0.005;
+            for (size_t i = 0; i < work_size; i++) {
+                if (!isZero(input[i])) {
+                    float error = (abs(input[i]) * gain) / reference;
+                    float dgain;
+                    if (error > 1) {
+                        dgain = 1 - attack_rate;
+                        hang_counter = hang_time;
+                    } else if (hang_counter > 0) {
+                        hang_counter--;
+                        dgain = 1;
+                    } else {
+                        dgain = 1 + decay_rate;
+                    }
+                    gain = gain * dgain;
+                }
+                xk += vk * dt;
+                float rk = gain - xk;
+                xk += gain_filter_alpha * rk;
+                vk += (beta * rk) / dt;
+                gain = xk;
+                if (gain > max_gain) gain = max_gain;
+                if (gain < 0) gain = 0;
+                output[i] = scale(input[i]);
+            }
+        }
+
+        float reference = 0.8;
+        float attack_rate = 0.1;
+        float decay_rate = 0.001;
+        float max_gain = 65535;
+        unsigned long int hang_time = 200;
+        float gain_filter_alpha = 1.5;
+        float gain = 1;
+    private:
+        unsigned long int hang_counter = 0;
+        float xk = 0;
+        float vk = 0;
+
+        static float abs(short in) { return std::fabs((float) in) / SHRT_MAX; }
+        static float abs(float in) { return std::fabs(in); }
+        static float abs(complex<float> in) { return std::abs(in); }
+        static bool isZero(short in) { return in == 0; }
+        static bool isZero(float in) { return in == 0.0f; }
+        static bool isZero(complex<float> in) { return in == complex<float>(0, 0); }
+        static float clamp(float val) { return std::min(std::max(val, -1.0f), 1.0f); }
+        short scale(short in) { return (short) std::min(std::max(gain * in, (float) SHRT_MIN), (float) SHRT_MAX); }
+        float scale(float in) { return clamp(in * gain); }
+        complex<float> scale(complex<float> in) { return { clamp(in.i() * gain), clamp(in.q() * gain) }; }
+};
+
+static double power(short sample) { return std::pow((double) sample / SHRT_MAX, 2); }
+static double power(float sample) { return (double) sample * sample; }
+static double power(complex<float> sample) { return std::norm(sample); }
+
+// level difference between the outputs in dB, per window. windows where the previous implementation is 50 dB below
+// full scale or quieter are skipped, that's the digital silence and the noise right after it.
+template <typename T>
+static std::vector<double> levelDeviation(T* reference, T* output, size_t length) {
+    std::vector<double> deviation;
+    for (size_t k = 0; k + WINDOW <= length; k += WINDOW) {
+        double a = 0, b = 0;
+        for (size_t i = k; i < k + WINDOW; i++) {
+            a += power(reference[i]);
+            b += power(output[i]);
+        }
+        if (a < WINDOW * 1E-5) continue;
+        deviation.push_back(std::fabs(10 * log10((b + 1E-20) / a)));
+    }
+    return deviation;
+}
+
+struct Profile {
+    const char* name;
+    float attack;
+    float decay;
+    unsigned long int hangTime;
+    float initialGain;
+    // limits for the level deviation in dB: mean, 99th percentile and maximum
+    double meanDeviation;
+    double p99Deviation;
+    double maxDeviation;
+};
+
+template <typename T>
+static void testAgc(const std::string& name, T* input, const Profile& profile) {
+    auto expected = (T*) malloc(sizeof(T) * LENGTH);
+    auto output = (T*) malloc(sizeof(T) * LENGTH);
+    struct ::timespec start_time, end_time;
+
+    auto createSerial = [&profile] () {
+        auto serial = new SerialAgc<T>();
+        serial->attack_rate = profile.attack;
+        serial->decay_rate = profile.decay;
+        serial->hang_time = profile.hangTime;
+        serial->gain = profile.initialGain;
+        return serial;
+    };
+    auto createAgc = [&profile] () {
+        auto agc = new Agc<T>();
+        agc->setAttack(profile.attack);
+        agc->setDecay(profile.decay);
+        agc->setHangTime(profile.hangTime);
+        agc->setInitialGain(profile.initialGain);
+        return agc;
+    };
+
+    auto serial = createSerial();
+    for (size_t k = 0; k < LENGTH; k += CHUNK) serial->process(input + k, expected + k, CHUNK);
+    delete serial;
+    auto agc = createAgc();
+    for (size_t k = 0; k < LENGTH; k += CHUNK) agc->process(input + k, output + k, CHUNK);
+    delete agc;
+
+    std::vector<double> deviation = levelDeviation(expected, output, LENGTH);
+    std::sort(deviation.begin(), deviation.end());
+    double mean = 0;
+    for (double d: deviation) mean += d;
+    mean /= deviation.size();
+
+    std::string description = "agc " + name + ", " + profile.name + " profile";
+    checkAbove(description + ", windows compared", deviation.size(), LENGTH / WINDOW / 2);
+    checkBelow(description + ", mean level deviation in dB", mean, profile.meanDeviation);
+    checkBelow(description + ", 99th percentile of the level deviation in dB", deviation[deviation.size() * 99 / 100], profile.p99Deviation);
+    checkBelow(description + ", max level deviation in dB", deviation.back(), profile.maxDeviation);
+
+    // timed again on the buffers that have been written already
+    serial = createSerial();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (size_t k = 0; k < LENGTH; k += CHUNK) serial->process(input + k, expected + k, CHUNK);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double serialTime = timeTaken(start_time, end_time);
+    delete serial;
+    agc = createAgc();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    for (size_t k = 0; k < LENGTH; k += CHUNK) agc->process(input + k, output + k, CHUNK);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double blockTime = timeTaken(start_time, end_time);
+    delete agc;
+
+    report(description + ": previous " + std::to_string(serialTime / LENGTH * 1E9) + " ns per sample, block " +
+           std::to_string(blockTime / LENGTH * 1E9) + " ns per sample");
+
+    free(expected);
+    free(output);
+}
+
+int main() {
+    // speech-like test signal: syllables of voiced harmonics with random levels over 50 dB, pauses with background
+    // noise and stretches of digital silence.
+    auto real = (float*) malloc(sizeof(float) * LENGTH);
+    auto iq = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    auto pcm = (short*) malloc(sizeof(short) * LENGTH);
+    std::minstd_rand generator;
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    size_t i = 0;
+    while (i < LENGTH) {
+        size_t length = 1200 + uniform(generator) * 2400;
+        float amplitude = powf(10, -uniform(generator) * 2.5);
+        bool pause = uniform(generator) < 0.2;
+        bool silence = uniform(generator) < 0.1;
+        float f0 = 100 + uniform(generator) * 150;
+        for (size_t k = 0; k < length && i < LENGTH; k++, i++) {
+            float voiced = 0;
+            for (int h = 1; h < 8; h++) voiced += sinf(2 * M_PI * f0 * h * i / 12000) / h;
+            float envelope = sinf(M_PI * k / length);
+            float value = silence ? 0 : pause ? 1E-4f * noise(generator) : amplitude * envelope * (0.5f * voiced + 0.1f * noise(generator));
+            real[i] = value;
+            iq[i] = silence ? complex<float>(0, 0) : complex<float>(value, amplitude * 0.1f * noise(generator));
+            pcm[i] = (short) (value * 0.5f * SHRT_MAX);
+        }
+    }
+
+    // the profiles of pycsdr, the second one with the initial gain of the analog chains.
+    // with the fast profile, the gain at the end of a syllable depends on the exact number of samples that hit the
+    // attack, so small differences carry over into the following pause. rounding alone (the previous implementation
+    // with double instead of float state) already makes for a mean deviation of up to 0.25 dB and up to 2.5 dB in single
+    // windows, so the limits are wider than for the slow profile.
+    Profile profiles[] = {
+        {"fast", 0.1f, 0.001f, 200, 1.0f, 0.4, 3.0, 4.0},
+        {"slow", 0.01f, 0.0001f, 600, 200.0f, 0.1, 0.5, 1.0},
+    };
+    for (auto& profile: profiles) {
+        testAgc("float", real, profile);
+        testAgc("complex", iq, profile);
+        testAgc("short", pcm, profile);
+    }
+
+    free(real);
+    free(iq);
+    free(pcm);
+    return result();
+}
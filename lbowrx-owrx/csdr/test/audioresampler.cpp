@@ -0,0 +1,220 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "tone.hpp"
+#include "audioresampler.hpp"
+#include "window.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+#define LENGTH (1024 * 64)
+// the timing runs over more input, so the tables are warm and the figures are stable
+#define TIMING_LENGTH (1024 * 512)
+
+// the inner loop of libsamplerate's sinc converter (src_sinc.c, calc_output_single() and the mono process loop), so
+// the CPU time can be compared without libsamplerate being available. the coefficient table has the size of
+// libsamplerate's, the coefficients are interpolated linearly at a 12 bit fixed point index and accumulated in double,
+// like libsamplerate does. the only thing left out is the copying into libsamplerate's internal buffer.
+class SincReference {
+    public:
+        SincReference(int increment, int halfLength): increment(increment), halfLength(halfLength) {
+            KaiserWindow window(KaiserWindow::beta(97));
+            coeffs.resize(halfLength + 2);
+            for (int i = 0; i < halfLength + 2; i++) {
+                double t = (double) i / increment;
+                double sinc = i == 0 ? 1 : sin(M_PI * t) / (M_PI * t);
+                coeffs[i] = (float) (sinc * window.kernel(std::min(1.0, (double) i / halfLength)));
+            }
+        }
+
+        size_t process(float* input, size_t size, float* output, double ratio) {
+            double floatIncrement = increment * std::min(ratio, 1.0);
+            long fixedIncrement = lrint(floatIncrement * FP_ONE);
+            long maxFilterIndex = (long) halfLength * FP_ONE;
+            // input samples needed on either side of the current one
+            size_t history = (size_t) (halfLength / floatIncrement) + 2;
+            size_t current = history;
+            double inputIndex = 0;
+            size_t oi = 0;
+            while (current + history < size) {
+                long startFilterIndex = lrint(inputIndex * floatIncrement * FP_ONE);
+
+                long filterIndex = startFilterIndex;
+                long count = (maxFilterIndex - filterIndex) / fixedIncrement;
+                filterIndex += count * fixedIncrement;
+                size_t dataIndex = current - count;
+                double left = 0;
+                do {
+                    left += coefficient(filterIndex) * input[dataIndex++];
+                    filterIndex -= fixedIncrement;
+                } while (filterIndex >= 0);
+
+                filterIndex = fixedIncrement - startFilterIndex;
+                count = (maxFilterIndex - filterIndex) / fixedIncrement;
+                filterIndex += count * fixedIncrement;
+                dataIndex = current + 1 + count;
+                double right = 0;
+                do {
+                    right += coefficient(filterIndex) * input[dataIndex--];
+                    filterIndex -= fixedIncrement;
+                } while (filterIndex > 0);
+
+                output[oi++] = (float) ((floatIncrement / increment) * (left + right));
+
+                inputIndex += 1.0 / ratio;
+                double whole = floor(inputIndex);
+                current += (size_t) whole;
+                inputIndex -= whole;
+            }
+            return oi;
+        }
+
+    private:
+        static const int SHIFT_BITS = 12;
+        static const long FP_ONE = 1L << SHIFT_BITS;
+
+        double coefficient(long filterIndex) {
+            double fraction = (filterIndex & (FP_ONE - 1)) * (1.0 / FP_ONE);
+            long index = filterIndex >> SHIFT_BITS;
+            return coeffs[index] + fraction * (coeffs[index + 1] - coeffs[index]);
+        }
+
+        int increment;
+        int halfLength;
+        std::vector<float> coeffs;
+};
+
+static size_t resample(unsigned int inputRate, unsigned int outputRate, ResamplerQuality quality, float* input, size_t size, float* output) {
+    auto resampler = new AudioResampler(inputRate, outputRate, quality);
+    std::vector<float> result = runToCompletion(resampler, input, size, 4096);
+    delete resampler;
+    std::copy(result.begin(), result.end(), output);
+    return result.size();
+}
+
+// stopband attenuation of the resampler: the weakest suppression of images (passband tones) and aliases (tones above
+// the output nyquist frequency), in dB
+static double stopband(unsigned int inputRate, unsigned int outputRate, ResamplerQuality quality, double bandwidth) {
+    auto input = (float*) malloc(sizeof(float) * LENGTH);
+    auto output = (float*) malloc(sizeof(float) * LENGTH * 4);
+    double nyquist = std::min(inputRate, outputRate) / 2.0;
+    double worst = -INFINITY;
+    for (int k = 0; k < 8; k++) {
+        // passband tones: everything except the tone itself is counted as an error
+        double frequency = nyquist * bandwidth * (0.05 + 0.9 * k / 7);
+        for (int i = 0; i < LENGTH; i++) input[i] = 0.5 * cos(2 * M_PI * frequency / inputRate * i);
+        size_t length = resample(inputRate, outputRate, quality, input, LENGTH, output);
+        worst = std::max(worst, toneResidual(output, length, frequency / outputRate, true));
+        if (outputRate < inputRate) {
+            // tones above the output nyquist frequency must not show up at all
+            double alias = nyquist + (inputRate / 2.0 - nyquist) * (0.02 + 0.96 * k / 7);
+            for (int i = 0; i < LENGTH; i++) input[i] = 0.5 * cos(2 * M_PI * alias / inputRate * i);
+            length = resample(inputRate, outputRate, quality, input, LENGTH, output);
+            worst = std::max(worst, signalPower(output, length) - signalPower(input, LENGTH));
+        }
+    }
+    free(input);
+    free(output);
+    return -worst;
+}
+
+// nanoseconds per output sample, the best of a few runs
+template <typename F>
+static double timePerOutput(F&& run) {
+    struct ::timespec start_time, end_time;
+    double best = INFINITY;
+    for (int i = 0; i < 3; i++) {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        size_t outputs = run();
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        best = std::min(best, timeTaken(start_time, end_time) / outputs * 1E9);
+    }
+    return best;
+}
+
+struct Quality {
+    const char* name;
+    ResamplerQuality quality;
+    double attenuation;
+    double bandwidth;
+    // table of the libsamplerate converter with the same attenuation: increment and half length
+    const char* reference;
+    int increment;
+    int halfLength;
+};
+
+int main() {
+    // the client audio chain resamples the demodulator output (12k, 24k or 48k) to the rate of the client's sound card
+    std::vector<std::pair<unsigned int, unsigned int>> rates = {
+        {12000, 44100}, {12000, 48000}, {24000, 44100}, {48000, 44100}, {44100, 48000}
+    };
+    Quality qualities[] = {
+        {"low", RESAMPLER_LOW, 70, 0.8, "SRC_SINC_FASTEST", 128, 2464},
+        {"medium", RESAMPLER_MEDIUM, 97, 0.9, "SRC_SINC_MEDIUM_QUALITY", 491, 22438},
+        {"high", RESAMPLER_HIGH, 120, 0.95, "SRC_SINC_BEST_QUALITY", 2381, 340239},
+    };
+
+    auto input = (float*) malloc(sizeof(float) * TIMING_LENGTH);
+    auto output = (float*) malloc(sizeof(float) * TIMING_LENGTH * 4);
+    for (int i = 0; i < TIMING_LENGTH; i++) input[i] = 0.5 * sin(0.01 * i) + 0.25 * sin(0.2 * i);
+
+    for (auto& q: qualities) {
+        SincReference reference(q.increment, q.halfLength);
+        for (auto r: rates) {
+            std::string name = "audio resampler " + std::to_string(r.first) + " -> " + std::to_string(r.second) + ", " + q.name + " quality";
+            checkAbove(name + ", stopband attenuation in dB", stopband(r.first, r.second, q.quality, q.bandwidth), q.attenuation);
+
+            double ratio = (double) r.second / r.first;
+            double ours = timePerOutput([&] () { return resample(r.first, r.second, q.quality, input, TIMING_LENGTH, output); });
+            double theirs = timePerOutput([&] () { return reference.process(input, TIMING_LENGTH, output, ratio); });
+            report(name + ": " + std::to_string(ours) + " ns per output sample, " + q.reference + " " + std::to_string(theirs) + " ns");
+            // the same attenuation has to come cheaper than with libsamplerate's converter
+            if (q.quality == RESAMPLER_MEDIUM) {
+                checkBelow(name + ", CPU time relative to " + q.reference, ours / theirs, 1.0);
+            }
+        }
+    }
+
+    // resamplers with the same ratio and quality share their taps
+    size_t entries = TapCache::getEntries(), bytes = TapCache::getMemoryUsage();
+    auto first = new AudioResampler(12000, 44100);
+    size_t tableBytes = TapCache::getMemoryUsage() - bytes;
+    auto second = new AudioResampler(12000, 44100);
+    checkBelow("audio resampler, tap cache entries for two resamplers", TapCache::getEntries() - entries, 1);
+    checkBelow("audio resampler, tap cache memory for two resamplers", TapCache::getMemoryUsage() - bytes, tableBytes);
+    checkAbove("audio resampler, tap cache memory for one table", tableBytes, 147 * sizeof(float));
+    delete first;
+    delete second;
+    checkBelow("audio resampler, tap cache entries after deleting the resamplers", TapCache::getEntries() - entries, 0);
+
+    // the reference has to be a working resampler, or its timing says nothing
+    SincReference reference(491, 22438);
+    for (int i = 0; i < LENGTH; i++) input[i] = 0.5 * cos(2 * M_PI * 1000.0 / 12000 * i);
+    size_t length = reference.process(input, LENGTH, output, 48000.0 / 12000);
+    checkBelow("SRC_SINC_MEDIUM_QUALITY reference, residual of a 1 kHz tone in dB", toneResidual(output, length, 1000.0 / 48000, true), -80);
+
+    free(input);
+    free(output);
+    return result();
+}
@@ -0,0 +1,194 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "bandpowertap.hpp"
+#include "fft.hpp"
+#include "filter.hpp"
+#include "fir.hpp"
+#include "power.hpp"
+#include "window.hpp"
+
+#include <cmath>
+#include <random>
+#include <thread>
+#include <chrono>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+#define LENGTH (1024 * 256)
+
+// average of the tap readings for the band while an Fft processes the signal
+static double tapPower(complex<float>* signal, float lowCut, float highCut, Window* window) {
+    const unsigned int fftSize = 4096;
+    auto tap = new BandPowerTap(0);
+    auto readings = new CollectingWriter<float>(1024);
+    tap->setWriter(tap->addBand(lowCut, highCut), readings);
+    auto fft = new Fft<complex<float>>(fftSize, fftSize, window);
+    fft->setPowerTap(tap);
+    runToCompletion(fft, signal, LENGTH, fftSize * 2);
+    double power = 0;
+    for (float reading: readings->collected) power += reading;
+    power /= readings->collected.size();
+    delete fft;
+    delete readings;
+    delete tap;
+    return power;
+}
+
+// what the user chains do: shift the band to baseband, low pass, Power
+static double channelPower(complex<float>* signal, float lowCut, float highCut, Window* window) {
+    auto channel = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    double phase = -2 * M_PI * (lowCut + highCut) / 2;
+    for (int i = 0; i < LENGTH; i++) {
+        channel[i] = signal[i] * complex<float>(cos(phase * i), sin(phase * i));
+    }
+    auto filter = new FilterModule<complex<float>>(new LowPassFilter<complex<float>>((highCut - lowCut) / 2, 0.002f, window));
+    std::vector<complex<float>> filtered = runToCompletion(filter, channel, LENGTH, LENGTH);
+    delete filter;
+    free(channel);
+
+    double powerSum = 0;
+    unsigned int powerCount = 0;
+    auto power = new Power(1, [&powerSum, &powerCount] (float p) { powerSum += p; powerCount++; });
+    runToCompletion(power, filtered.data(), filtered.size(), filtered.size());
+    delete power;
+    return powerSum / powerCount;
+}
+
+// drives the gate of a band with frames of the given power (fftSize 64, the band is the first 4 bins), and reports
+// whether the gate passes data after every frame
+class GateDriver {
+    public:
+        GateDriver(float hysteresis, float holdTime) {
+            band = tap.addBand(0.0f, 4.0f / 64);
+            tap.setSquelch(band, 1.0f, &gate, hysteresis, holdTime);
+            gate.setReader(&reader);
+            gate.setWriter(&writer);
+        }
+        bool frame(float power) {
+            complex<float> spectrum[64] = {};
+            spectrum[0] = sqrtf(power);
+            tap.measure(spectrum, 64, 1.0f);
+            for (int i = 0; i < 16; i++) *(input.getWritePointer() + i) = 1.0f;
+            input.advance(16);
+            writer.collected.clear();
+            while (gate.canProcess()) gate.process();
+            return !writer.collected.empty();
+        }
+    private:
+        BandPowerTap tap{0};
+        unsigned int band;
+        // no flush, a closed gate doesn't produce anything
+        SquelchGate gate{0};
+        Ringbuffer<complex<float>> input{1024};
+        RingbufferReader<complex<float>> reader{&input};
+        CollectingWriter<complex<float>> writer{1024};
+};
+
+// the power around the squelch level varies from frame to frame. the gate must not follow every frame.
+static int gateChanges(float hysteresis) {
+    GateDriver driver(hysteresis, 0.0f);
+    std::minstd_rand generator;
+    std::uniform_real_distribution<float> level(-1.0f, 1.0f);
+    bool open = false;
+    int changes = 0;
+    for (int i = 0; i < 200; i++) {
+        // +-1 dB around the squelch level
+        bool passes = driver.frame(powf(10, 0.1f * level(generator)));
+        if (passes != open) changes++;
+        open = passes;
+    }
+    return changes;
+}
+
+static void testGateHold() {
+    // the gate closes 2 dB below the squelch level, after 200 ms. frames come every 10 ms.
+    GateDriver driver(powf(10, 0.2f), 0.2f);
+    check(driver.frame(2.0f), "squelch gate opens above the squelch level");
+    auto start = std::chrono::steady_clock::now();
+    bool open = true;
+    for (int i = 0; i < 5; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        open = driver.frame(0.1f) && open;
+    }
+    check(open, "squelch gate stays open during the hold time");
+    while (driver.frame(0.1f)) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    double closed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    checkAbove("squelch gate, time until it closes in s", closed, 0.2);
+    checkBelow("squelch gate, time until it closes in s", closed, 0.5);
+}
+
+static void testGateHoldRestart() {
+    // a dip for most of the hold time, a frame between the two thresholds, and another dip: the hold time starts over
+    GateDriver driver(powf(10, 0.2f), 0.2f);
+    driver.frame(2.0f);
+    for (int i = 0; i < 15; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        driver.frame(0.1f);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    check(driver.frame(0.8f), "squelch gate stays open between the thresholds");
+    auto start = std::chrono::steady_clock::now();
+    bool open = true;
+    for (int i = 0; i < 5; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        open = driver.frame(0.1f) && open;
+    }
+    check(open, "squelch gate stays open on the second dip");
+    while (driver.frame(0.1f)) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    double closed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    checkAbove("squelch gate, time until it closes after the second dip in s", closed, 0.2);
+}
+
+int main() {
+    // the band is 0.1 .. 0.15, the signal consists of white noise (0.01 total power), a strong carrier outside of the
+    // band and optionally a weaker carrier inside of it.
+    const float lowCut = 0.1f, highCut = 0.15f;
+    auto signal = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    auto window = new HammingWindow();
+
+    for (float inBand: { 0.3f, 0.0f }) {
+        std::minstd_rand generator;
+        std::normal_distribution<float> noise(0.0f, sqrtf(0.005f));
+        for (int i = 0; i < LENGTH; i++) {
+            signal[i] = { noise(generator), noise(generator) };
+            signal[i] += complex<float>(cos(2 * M_PI * 0.3 * i), sin(2 * M_PI * 0.3 * i));
+            signal[i] += complex<float>(cos(2 * M_PI * 0.121 * i), sin(2 * M_PI * 0.121 * i)) * inBand;
+        }
+        double expected = 10 * log10(inBand * inBand + 0.01 * (highCut - lowCut));
+        double tap = 10 * log10(tapPower(signal, lowCut, highCut, window));
+        double reference = 10 * log10(channelPower(signal, lowCut, highCut, window));
+
+        std::string name = inBand > 0 ? "with in-band carrier" : "noise only";
+        checkBelow("tap reading " + name + ", deviation from the expected power in dB", std::fabs(tap - expected), 0.2);
+        checkBelow("tap reading " + name + ", deviation from Power in dB", std::fabs(tap - reference), 0.2);
+    }
+
+    delete window;
+    free(signal);
+
+    // without hysteresis, the gate follows the noise of the readings (this is how it behaved before)
+    checkAbove("squelch gate without hysteresis, state changes in 200 frames around the squelch level", gateChanges(1.0f), 20);
+    checkBelow("squelch gate with 2 dB hysteresis, state changes in 200 frames around the squelch level", gateChanges(powf(10, 0.2f)), 1);
+    testGateHold();
+    testGateHoldRestart();
+    return result();
+}
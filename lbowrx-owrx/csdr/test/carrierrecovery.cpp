@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "carrierrecovery.hpp"
+
+#include <cmath>
+#include <random>
+#include <cstdint>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+#define LENGTH (1024 * 256)
+
+struct Signal {
+    const char* name;
+    // number of phases in the constellation, 1 for an unmodulated carrier
+    unsigned int phases;
+    float snr;
+};
+
+static CarrierRecovery* createLoop(const Signal& signal, float bandwidth) {
+    if (signal.phases == 1) return new Pll(bandwidth);
+    return new CostasLoop(signal.phases == 2 ? COSTAS_BPSK : COSTAS_QPSK, bandwidth);
+}
+
+int main() {
+    // a carrier with a frequency and phase offset and white noise: unmodulated for the PLL, random BPSK / QPSK
+    // symbols (16 samples each) for the costas loop. the NCO phase is compared with the carrier every 16 samples,
+    // modulo the phase ambiguity of the mode. the loop is locked once the phase error stays below 0.3 rad for 2048
+    // samples, jitter is the rms phase error over the second half.
+    const size_t step = 16;
+    const float offset = 0.001f;
+    std::minstd_rand generator;
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::uniform_int_distribution<int> symbol(0, 3);
+    auto input = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    auto output = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    auto chunked = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    struct ::timespec start_time, end_time;
+
+    Signal signals[] = {
+        {"pll, carrier", 1, 10.0f},
+        {"costas loop, bpsk", 2, 10.0f},
+        {"costas loop, qpsk", 4, 15.0f},
+    };
+    // limits for the lock time in samples and the jitter in rad, per bandwidth. a narrow loop takes longer to pull in
+    // the frequency offset, but jitters less.
+    struct {
+        float bandwidth;
+        size_t lockTime;
+        double jitter;
+    } loops[] = {
+        {0.01f, 1000, 0.1},
+        {0.002f, 1000, 0.05},
+        {0.0005f, 2000, 0.03},
+    };
+    for (auto& signal: signals) {
+        float sigma = sqrtf(powf(10.0f, -signal.snr / 10.0f) / 2);
+        int current = 0;
+        for (size_t i = 0; i < LENGTH; i++) {
+            if (i % 16 == 0) current = symbol(generator) % signal.phases;
+            float phase = 2.0f + 2 * M_PI * offset * i + 2 * M_PI * current / signal.phases + (signal.phases == 4 ? M_PI / 4 : 0);
+            input[i] = std::polar(1.0f, phase) + complex<float>(sigma * gauss(generator), sigma * gauss(generator));
+        }
+        float ambiguity = 2 * M_PI / signal.phases;
+
+        for (auto& l: loops) {
+            CarrierRecovery* loop = createLoop(signal, l.bandwidth);
+            size_t lock = SIZE_MAX;
+            size_t below = 0;
+            double jitter = 0, frequency = 0;
+            size_t count = 0;
+            for (size_t i = 0; i < LENGTH; i += step) {
+                loop->process(input + i, output + i, step);
+                double carrier = 2.0 + 2 * M_PI * offset * (i + step);
+                double error = std::remainder(carrier - loop->getPhase(), (double) ambiguity);
+                if (std::fabs(error) > 0.3) below = i + step;
+                if (lock == SIZE_MAX && i + step - below >= 2048) lock = below;
+                if (i >= LENGTH / 2) {
+                    jitter += error * error;
+                    frequency += loop->getFrequency();
+                    count++;
+                }
+            }
+            jitter = sqrt(jitter / count);
+            frequency /= count;
+            delete loop;
+
+            // the loop state carries over between calls, so the length of the calls must not change the output (apart from
+            // rounding in the NCO, when a block is split)
+            loop = createLoop(signal, l.bandwidth);
+            for (size_t i = 0; i < LENGTH; i += 13) loop->process(input + i, chunked + i, std::min((size_t) 13, LENGTH - i));
+            delete loop;
+
+            std::ostringstream s;
+            s << signal.name << " at " << signal.snr << " dB SNR, bandwidth " << l.bandwidth;
+            std::string description = s.str();
+            checkBelow(description + ", lock time in samples", lock, l.lockTime);
+            checkBelow(description + ", jitter in rad", jitter, l.jitter);
+            checkBelow(description + ", mean frequency error", std::fabs(frequency - offset), 2E-5);
+            double deviation = 0;
+            for (size_t i = 0; i < LENGTH; i++) deviation = std::max(deviation, (double) std::abs(output[i] - chunked[i]));
+            checkBelow(description + ", output deviation in calls of 13 samples", deviation, 1E-4);
+
+            loop = createLoop(signal, l.bandwidth);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+            loop->process(input, output, LENGTH);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            delete loop;
+            report(description + ": " + std::to_string(LENGTH / timeTaken(start_time, end_time) / 1E6) + " MS/s");
+        }
+    }
+
+    free(input);
+    free(output);
+    free(chunked);
+    return result();
+}
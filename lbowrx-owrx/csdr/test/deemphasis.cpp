@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "deemphasis.hpp"
+#include "fir.hpp"
+// the FIR filters NfmDeephasis used before, they are the reference
+#include "../src/lib/predefined.h"
+
+#include <cmath>
+#include <complex>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+struct Reference {
+    unsigned int rate;
+    float* taps;
+    size_t length;
+    // limits for the deviation from the design envelope and from the FIR filter in dB
+    double envelopeLimit;
+    double firLimit;
+};
+
+int main() {
+    // the rates the predefined FIR filters were available for, and a few that used to throw. the response is compared
+    // to the firls envelope they were designed for (1 at 400 Hz to 0.1 at 3700 Hz) and to the FIR filters themselves,
+    // everything normalized at 500 Hz. at 8000 S/s, the envelope ends right below nyquist, where the bilinear
+    // transform can't follow it. the FIR filters at 44100 and 48000 S/s are up to 2 dB off the envelope themselves.
+    std::vector<Reference> references = {
+        {8000, deemphasis_nfm_predefined_fir_8000, 79, 3.5, 3.5},
+        {11025, deemphasis_nfm_predefined_fir_11025, 79, 1.0, 1.0},
+        {12000, deemphasis_nfm_predefined_fir_12000, 79, 1.0, 1.0},
+        {16000, nullptr, 0, 1.0, 0},
+        {24000, nullptr, 0, 1.0, 0},
+        {44100, deemphasis_nfm_predefined_fir_44100, 199, 0.6, 2.0},
+        {48000, deemphasis_nfm_predefined_fir_48000, 199, 0.6, 2.0},
+    };
+    std::vector<double> frequencies = {400, 500, 700, 1000, 1500, 2000, 2500, 3000, 3300};
+    auto envelope = [] (double f) { return 20 * log10(1 - 0.9 * (f - 400) / 3300); };
+    struct ::timespec start_time, end_time;
+
+    for (auto& reference: references) {
+        // one second of input
+        size_t length = reference.rate;
+        auto input = (float*) malloc(sizeof(float) * length);
+
+        // measured gain of the IIR filter and designed gain of the FIR filter in dB
+        std::vector<double> iir, fir;
+        for (double f: frequencies) {
+            double w = 2 * M_PI * f / reference.rate;
+            for (size_t i = 0; i < length; i++) input[i] = (float) sin(w * i);
+            auto deemphasis = new NfmDeephasis(reference.rate);
+            std::vector<float> output = runToCompletion(deemphasis, input, length, length);
+            delete deemphasis;
+            // correlation over the second half, after the filter has settled
+            std::complex<double> acc = 0;
+            for (size_t i = output.size() / 2; i < output.size(); i++) acc += (double) output[i] * std::polar(1.0, -w * i);
+            iir.push_back(20 * log10(std::abs(acc) * 2 / (output.size() - output.size() / 2)));
+
+            std::complex<double> h = 0;
+            for (size_t i = 0; i < reference.length; i++) h += (double) reference.taps[i] * std::polar(1.0, -w * i);
+            fir.push_back(20 * log10(std::abs(h)));
+        }
+
+        double envelopeError = 0, firError = 0;
+        for (size_t i = 0; i < frequencies.size(); i++) {
+            double gain = iir[i] - iir[1];
+            envelopeError = std::max(envelopeError, std::fabs(gain - (envelope(frequencies[i]) - envelope(500))));
+            if (reference.taps != nullptr) firError = std::max(firError, std::fabs(gain - (fir[i] - fir[1])));
+        }
+
+        std::string description = "nfm deemphasis at " + std::to_string(reference.rate) + " S/s";
+        checkBelow(description + ", max deviation from the design envelope in dB", envelopeError, reference.envelopeLimit);
+        checkBelow(description + ", gain at 500 Hz in dB", std::fabs(iir[1]), 0.1);
+        if (reference.taps != nullptr) {
+            checkBelow(description + ", max deviation from the fir in dB", firError, reference.firLimit);
+        }
+
+        for (size_t i = 0; i < length; i++) input[i] = (float) sin(2 * M_PI * 1000 * i / reference.rate);
+        auto deemphasis = new NfmDeephasis(reference.rate);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+        runToCompletion(deemphasis, input, length, length);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+        delete deemphasis;
+        std::string timing = description + ": " + std::to_string(timeTaken(start_time, end_time) / length * 1E9) + " ns per sample";
+        if (reference.taps != nullptr) {
+            auto filter = new FirFilter<float, float>(reference.taps, reference.length);
+            auto output = (float*) malloc(sizeof(float) * length);
+            size_t filtered = length - reference.length;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+            filter->apply(input, output, filtered);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            delete filter;
+            free(output);
+            timing += ", fir with " + std::to_string(reference.length) + " taps " +
+                      std::to_string(timeTaken(start_time, end_time) / filtered * 1E9) + " ns per sample";
+        }
+        report(timing);
+
+        free(input);
+    }
+
+    return result();
+}
@@ -0,0 +1,291 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "dbpsk.hpp"
+#include "varicode.hpp"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <cstring>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+#define LENGTH (1024 * 256)
+
+// the varicode table, to encode the test text and for the previous decoder
+static const struct {
+    unsigned long long code;
+    int bitcount;
+    unsigned char ascii;
+} varicode[] = {
+    { 0b1010101011, 10, 0x00 }, //NUL, null
+    { 0b1011011011, 10, 0x01 }, //SOH, start of heading
+    { 0b1011101101, 10, 0x02 }, //STX, start of text
+    { 0b1101110111, 10, 0x03 }, //ETX, end of text
+    { 0b1011101011, 10, 0x04 }, //EOT, end of transmission
+    { 0b1101011111, 10, 0x05 }, //ENQ, enquiry
+    { 0b1011101111, 10, 0x06 }, //ACK, acknowledge
+    { 0b1011111101, 10, 0x07 }, //BEL, bell
+    { 0b1011111111, 10, 0x08 }, //BS, backspace
+    { 0b11101111,   8,  0x09 }, //TAB, horizontal tab
+    { 0b11101,      5,  0x0a }, //LF, NL line feed, new line
+    { 0b1101101111, 10, 0x0b }, //VT, vertical tab
+    { 0b1011011101, 10, 0x0c }, //FF, NP form feed, new page
+    { 0b11111,      5,  0x0d }, //CR, carriage return (overwrite)
+    { 0b1101110101, 10, 0x0e }, //SO, shift out
+    { 0b1110101011, 10, 0x0f }, //SI, shift in
+    { 0b1011110111, 10, 0x10 }, //DLE, data link escape
+    { 0b1011110101, 10, 0x11 }, //DC1, device control 1
+    { 0b1110101101, 10, 0x12 }, //DC2, device control 2
+    { 0b1110101111, 10, 0x13 }, //DC3, device control 3
+    { 0b1101011011, 10, 0x14 }, //DC4, device control 4
+    { 0b1101101011, 10, 0x15 }, //NAK, negative acknowledge
+    { 0b1101101101, 10, 0x16 }, //SYN, synchronous idle
+    { 0b1101010111, 10, 0x17 }, //ETB, end of trans. block
+    { 0b1101111011, 10, 0x18 }, //CAN, cancel
+    { 0b1101111101, 10, 0x19 }, //EM, end of medium
+    { 0b1110110111, 10, 0x1a }, //SUB, substitute
+    { 0b1101010101, 10, 0x1b }, //ESC, escape
+    { 0b1101011101, 10, 0x1c }, //FS, file separator
+    { 0b1110111011, 10, 0x1d }, //GS, group separator
+    { 0b1011111011, 10, 0x1e }, //RS, record separator
+    { 0b1101111111, 10, 0x1f }, //US, unit separator
+    { 0b1,          1,  0x20 }, //szóköz
+    { 0b111111111,  9,  0x21 }, //!
+    { 0b101011111,  9,  0x22 }, //"
+    { 0b111110101,  9,  0x23 }, //#
+    { 0b111011011,  9,  0x24 }, //$
+    { 0b1011010101, 10, 0x25 }, //%
+    { 0b1010111011, 10, 0x26 }, //&
+    { 0b101111111,  9,  0x27 }, //'
+    { 0b11111011,   8,  0x28 }, //(
+    { 0b11110111,   8,  0x29 }, //)
+    { 0b101101111,  9,  0x2a }, //*
+    { 0b111011111,  9,  0x2b }, //+
+    { 0b1110101,    7,  0x2c }, //,
+    { 0b110101,     6,  0x2d }, //-
+    { 0b1010111,    7,  0x2e }, //.
+    { 0b110101111,  9,  0x2f }, ///
+    { 0b10110111,   8,  0x30 }, //0
+    { 0b10111101,   8,  0x31 }, //1
+    { 0b11101101,   8,  0x32 }, //2
+    { 0b11111111,   8,  0x33 }, //3
+    { 0b101110111,  9,  0x34 }, //4
+    { 0b101011011,  9,  0x35 }, //5
+    { 0b101101011,  9,  0x36 }, //6
+    { 0b110101101,  9,  0x37 }, //7
+    { 0b110101011,  9,  0x38 }, //8
+    { 0b110110111,  9,  0x39 }, //9
+    { 0b11110101,   8,  0x3a }, //:
+    { 0b110111101,  9,  0x3b }, //;
+    { 0b111101101,  9,  0x3c }, //<
+    { 0b1010101,    7,  0x3d }, //=
+    { 0b111010111,  9,  0x3e }, //>
+    { 0b1010101111, 10, 0x3f }, //?
+    { 0b1010111101, 10, 0x40 }, //@
+    { 0b1111101,    7,  0x41 }, //A
+    { 0b11101011,   8,  0x42 }, //B
+    { 0b10101101,   8,  0x43 }, //C
+    { 0b10110101,   8,  0x44 }, //D
+    { 0b1110111,    7,  0x45 }, //E
+    { 0b11011011,   8,  0x46 }, //F
+    { 0b11111101,   8,  0x47 }, //G
+    { 0b101010101,  9,  0x48 }, //H
+    { 0b1111111,    7,  0x49 }, //I
+    { 0b111111101,  9,  0x4a }, //J
+    { 0b101111101,  9,  0x4b }, //K
+    { 0b11010111,   8,  0x4c }, //L
+    { 0b10111011,   8,  0x4d }, //M
+    { 0b11011101,   8,  0x4e }, //N
+    { 0b10101011,   8,  0x4f }, //O
+    { 0b11010101,   8,  0x50 }, //P
+    { 0b111011101,  9,  0x51 }, //Q
+    { 0b10101111,   8,  0x52 }, //R
+    { 0b1101111,    7,  0x53 }, //S
+    { 0b1101101,    7,  0x54 }, //T
+    { 0b101010111,  9,  0x55 }, //U
+    { 0b110110101,  9,  0x56 }, //V
+    { 0b101011101,  9,  0x57 }, //W
+    { 0b101110101,  9,  0x58 }, //X
+    { 0b101111011,  9,  0x59 }, //Y
+    { 0b1010101101, 10, 0x5a }, //Z
+    { 0b111110111,  9,  0x5b }, //[
+    { 0b111101111,  9,  0x5c }, //backslash
+    { 0b111111011,  9,  0x5d }, //]
+    { 0b1010111111, 10, 0x5e }, //^
+    { 0b101101101,  9,  0x5f }, //_
+    { 0b1011011111, 10, 0x60 }, //`
+    { 0b1011,       4,  0x61 }, //a
+    { 0b1011111,    7,  0x62 }, //b
+    { 0b101111,     6,  0x63 }, //c
+    { 0b101101,     6,  0x64 }, //d
+    { 0b11,         2,  0x65 }, //e
+    { 0b111101,     6,  0x66 }, //f
+    { 0b1011011,    7,  0x67 }, //g
+    { 0b101011,     6,  0x68 }, //h
+    { 0b1101,       4,  0x69 }, //i
+    { 0b111101011,  9,  0x6a }, //j
+    { 0b10111111,   8,  0x6b }, //k
+    { 0b11011,      5,  0x6c }, //l
+    { 0b111011,     6,  0x6d }, //m
+    { 0b1111,       4,  0x6e }, //n
+    { 0b111,        3,  0x6f }, //o
+    { 0b111111,     6,  0x70 }, //p
+    { 0b110111111,  9,  0x71 }, //q
+    { 0b10101,      5,  0x72 }, //r
+    { 0b10111,      5,  0x73 }, //s
+    { 0b101,        3,  0x74 }, //t
+    { 0b110111,     6,  0x75 }, //u
+    { 0b1111011,    7,  0x76 }, //v
+    { 0b1101011,    7,  0x77 }, //w
+    { 0b11011111,   8,  0x78 }, //x
+    { 0b1011101,    7,  0x79 }, //y
+    { 0b111010101,  9,  0x7a }, //z
+    { 0b1010110111, 10, 0x7b }, //{
+    { 0b110111011,  9,  0x7c }, //|
+    { 0b1010110101, 10, 0x7d }, //}
+    { 0b1011010111, 10, 0x7e }, //~
+    { 0b1110110101, 10, 0x7f }, //DEL
+};
+
+// the previous DBPskDecoder: phase difference via atan2
+static void dbpskAtan2(complex<float>* input, unsigned char* output, size_t size, float& last_phase) {
+    for (size_t i = 0; i < size; i++) {
+        float phase = std::arg(input[i]);
+        if (std::isnan(phase)) phase = 0.0f;
+        float dphase = phase - last_phase;
+        while (dphase < -M_PI) dphase += 2 * M_PI;
+        while (dphase >= M_PI) dphase -= 2 * M_PI;
+        output[i] = !(dphase > (M_PI / 2) || dphase < (-M_PI / 2));
+        last_phase = phase;
+    }
+}
+
+// the previous VaricodeDecoder: one bit per call, scanning the whole table whenever a code may have ended
+static size_t varicodeScan(unsigned char* input, size_t size, unsigned char* output, unsigned long long& status) {
+    size_t produced = 0;
+    for (size_t i = 0; i < size; i++) {
+        status = (status << 1) | (input[i] & 0b1);
+        if ((status & 0xFFF) == 0) continue;
+        for (auto item: varicode) {
+            unsigned long long mask = (1 << (item.bitcount + 4)) - 1;
+            if ((item.code << 2) == (status & mask)) {
+                output[produced++] = item.ascii;
+            }
+        }
+    }
+    return produced;
+}
+
+// feeds the input in chunks that don't line up with the symbols or characters, the module has to keep its state
+template <typename T, typename U>
+static std::vector<U> runInChunks(Module<T, U>* module, T* input, size_t size, size_t chunk) {
+    // setReader() unblocks the previous reader, so they are all kept until the end
+    std::vector<MemoryReader<T>*> readers;
+    auto writer = new CollectingWriter<U>(chunk);
+    module->setWriter(writer);
+    for (size_t k = 0; k < size; k += chunk) {
+        auto reader = new MemoryReader<T>(input + k, std::min(chunk, size - k));
+        readers.push_back(reader);
+        module->setReader(reader);
+        while (module->canProcess()) module->process();
+    }
+    std::vector<U> output = writer->collected;
+    delete writer;
+    for (auto reader: readers) delete reader;
+    return output;
+}
+
+int main() {
+    // PSK31 text at the symbol rate (as produced by the timing recovery), with a drifting carrier phase and enough
+    // noise for some bit errors, so that broken codes are part of the stream, too.
+    const char* text = "The quick brown fox jumps over the lazy dog 0123456789 CQ CQ de DL0ABC pse k\r\n";
+    std::vector<unsigned char> bits;
+    for (size_t i = 0; bits.size() < LENGTH; i = (i + 1) % strlen(text)) {
+        for (auto item: varicode) {
+            if (item.ascii != (unsigned char) text[i]) continue;
+            for (int b = item.bitcount - 1; b >= 0; b--) bits.push_back((item.code >> b) & 1);
+            bits.push_back(0);
+            bits.push_back(0);
+        }
+    }
+    size_t length = bits.size();
+    auto symbols = (complex<float>*) malloc(sizeof(complex<float>) * length);
+    std::minstd_rand generator;
+    std::normal_distribution<float> gauss(0.0f, 0.3f);
+    float level = 1.0f;
+    for (size_t i = 0; i < length; i++) {
+        if (bits[i] == 0) level = -level;
+        symbols[i] = std::polar(level, 0.001f * i) + complex<float>(gauss(generator), gauss(generator));
+    }
+
+    struct ::timespec start_time, end_time;
+    auto referenceBits = (unsigned char*) malloc(length);
+    auto referenceText = (unsigned char*) malloc(length);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    float last_phase = 0.0f;
+    dbpskAtan2(symbols, referenceBits, length, last_phase);
+    unsigned long long status = 0;
+    size_t referenceLength = varicodeScan(referenceBits, length, referenceText, status);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double previous = timeTaken(start_time, end_time);
+
+    size_t errors = 0;
+    for (size_t i = 1; i < length; i++) errors += referenceBits[i] != bits[i];
+    checkAbove("psk decoders, bit errors in the test signal", errors, 10);
+
+    auto dbpsk = new DBPskDecoder();
+    auto varicodeDecoder = new VaricodeDecoder();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+    std::vector<unsigned char> decodedBits = runToCompletion(dbpsk, symbols, length, length);
+    std::vector<unsigned char> decodedText = runToCompletion(varicodeDecoder, decodedBits.data(), decodedBits.size(), length);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    double current = timeTaken(start_time, end_time);
+    delete dbpsk;
+    delete varicodeDecoder;
+
+    check(decodedBits.size() == length && std::equal(decodedBits.begin(), decodedBits.end(), referenceBits),
+          "dbpsk decoder, output identical to the previous implementation");
+    check(decodedText.size() == referenceLength && std::equal(decodedText.begin(), decodedText.end(), referenceText),
+          "varicode decoder, output identical to the previous implementation");
+    checkAbove("varicode decoder, characters", decodedText.size(), length / 20);
+
+    // 1000 and 7 don't divide any code length
+    dbpsk = new DBPskDecoder();
+    varicodeDecoder = new VaricodeDecoder();
+    decodedBits = runInChunks(dbpsk, symbols, length, 1000);
+    decodedText = runInChunks(varicodeDecoder, decodedBits.data(), decodedBits.size(), 7);
+    delete dbpsk;
+    delete varicodeDecoder;
+    check(decodedBits.size() == length && std::equal(decodedBits.begin(), decodedBits.end(), referenceBits),
+          "dbpsk decoder in chunks, output identical to the previous implementation");
+    check(decodedText.size() == referenceLength && std::equal(decodedText.begin(), decodedText.end(), referenceText),
+          "varicode decoder in chunks, output identical to the previous implementation");
+
+    report("psk decoders: " + std::to_string(current * 1E9 / length) + " ns per symbol, previous implementation " +
+           "(without module overhead) " + std::to_string(previous * 1E9 / length) + " ns per symbol");
+
+    free(symbols);
+    free(referenceBits);
+    free(referenceText);
+    return result();
+}
@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "tone.hpp"
+#include "fir.hpp"
+#include "firdecimate.hpp"
+#include "fftfilter.hpp"
+#include "filter.hpp"
+#include "window.hpp"
+
+#include <cmath>
+#include <complex>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+#define LENGTH (1024 * 256)
+
+struct Response {
+    double ripple;
+    double attenuation;
+};
+
+// passband ripple and stopband attenuation in dB, on a denser grid than the generators use for their search
+static Response response(const float* taps, size_t length, float cutoff, float transition) {
+    double passband = cutoff - transition / 2, stopband = cutoff + transition / 2;
+    size_t points = length * 32;
+    auto magnitude = [taps, length] (double frequency) {
+        std::complex<double> sum = 0, rotation = std::polar(1.0, -2 * M_PI * frequency), phase = 1;
+        for (size_t i = 0; i < length; i++) {
+            sum += (double) taps[i] * phase;
+            phase *= rotation;
+        }
+        return std::abs(sum);
+    };
+    double gain = magnitude(0), minimum = gain, maximum = gain, stop = 0;
+    for (size_t i = 0; i <= points; i++) {
+        double r = magnitude(passband * i / points);
+        minimum = std::min(minimum, r);
+        maximum = std::max(maximum, r);
+        stop = std::max(stop, magnitude(stopband + (0.5 - stopband) * i / points));
+    }
+    return { 20 * log10(maximum / minimum), -20 * log10(stop / gain) };
+}
+
+// level of a tone after the module, relative to the input, in dB. the start of the output is skipped, it contains the
+// filter transient.
+static double toneLevel(Module<complex<float>, complex<float>>* module, double frequency) {
+    auto input = (complex<float>*) malloc(sizeof(complex<float>) * LENGTH);
+    for (int i = 0; i < LENGTH; i++) toneSample(input[i], 2 * M_PI * frequency * i);
+    std::vector<complex<float>> output = runToCompletion(module, input, LENGTH, LENGTH);
+    size_t skip = output.size() / 4;
+    double level = signalPower(output.data() + skip, output.size() - skip) - signalPower(input, LENGTH);
+    free(input);
+    return level;
+}
+
+int main() {
+    // lowpass specifications as they are used by the selector: decimation, the channel bandpass, and the long filter of
+    // a 2.4 MS/s -> 48 kS/s decimation. all designs have to reach 0.1 dB ripple and 60 dB attenuation.
+    struct { std::string name; float cutoff; float transition; } specs[] = {
+        {"firdecimate by 10", 0.5f / 10, 0.05f / 10},
+        {"bandpass 8 kHz at 48 kS/s", 4000.0f / 48000, 320.0f / 48000},
+        {"firdecimate by 50", 0.5f / 50, 0.15f / 50},
+    };
+    const float ripple = 0.1f, attenuation = 60.0f;
+
+    for (auto& spec: specs) {
+        // the current generators: windowed sinc with 4 / transition taps
+        size_t windowedLength = (size_t) (4.0 / spec.transition) | 1;
+        auto hamming = new HammingWindow();
+        auto generator = new LowPassTapGenerator(spec.cutoff, hamming);
+        float* taps = generator->generateTaps(windowedLength);
+        Response r = response(taps, windowedLength, spec.cutoff, spec.transition);
+        report(spec.name + ", hamming: " + std::to_string(windowedLength) + " taps, " + std::to_string(r.ripple) +
+               " dB ripple, " + std::to_string(r.attenuation) + " dB attenuation");
+        free(taps);
+        delete generator;
+        delete hamming;
+
+        for (auto g: std::vector<std::pair<std::string, MinimumLengthTapGenerator*>> {
+            {"kaiser", new KaiserTapGenerator(spec.cutoff, spec.transition, ripple, attenuation)},
+            {"remez", new RemezTapGenerator(spec.cutoff, spec.transition, ripple, attenuation)},
+        }) {
+            struct ::timespec start_time, end_time;
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+            size_t length = g.second->getLength();
+            taps = g.second->generateTaps(length);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            r = response(taps, length, spec.cutoff, spec.transition);
+            std::string description = spec.name + ", " + g.first;
+            report(description + ": designed in " + std::to_string(timeTaken(start_time, end_time) * 1E3) + " ms");
+            checkBelow(description + ", passband ripple in dB", r.ripple, ripple);
+            checkAbove(description + ", stopband attenuation in dB", r.attenuation, attenuation);
+            checkBelow(description + ", taps", length, windowedLength);
+            free(taps);
+            delete g.second;
+        }
+    }
+
+    // the designs through the modules: a tone in the passband passes, a tone in the stopband is attenuated
+    auto design = new RemezTapGenerator(0.05f, 0.005f, ripple, attenuation);
+    for (auto f: std::vector<std::pair<double, bool>> {{0.02, true}, {0.06, false}}) {
+        auto decimator = new FirDecimate<complex<float>>(10, design);
+        double level = toneLevel(decimator, f.first);
+        delete decimator;
+        std::string description = "firdecimate with remez design, tone at " + std::to_string(f.first);
+        if (f.second) {
+            checkBelow(description + ", level in dB", std::fabs(level), ripple);
+        } else {
+            checkBelow(description + ", level in dB", level, -attenuation);
+        }
+    }
+    delete design;
+
+    auto kaiser = new KaiserTapGenerator(0.1f, 0.01f, ripple, attenuation);
+    for (auto f: std::vector<std::pair<double, bool>> {{0.1, true}, {0.0, false}, {0.2, false}}) {
+        auto bandpass = new FilterModule<complex<float>>(new FftBandPassFilter(0.05f, 0.15f, kaiser));
+        double level = toneLevel(bandpass, f.first);
+        delete bandpass;
+        std::string description = "fft bandpass with kaiser design, tone at " + std::to_string(f.first);
+        if (f.second) {
+            checkBelow(description + ", level in dB", std::fabs(level), ripple);
+        } else {
+            checkBelow(description + ", level in dB", level, -attenuation);
+        }
+    }
+    delete kaiser;
+
+    return result();
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "module.hpp"
+#include "reader.hpp"
+#include "writer.hpp"
+#include "ringbuffer.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <ctime>
+
+// every test is an executable of its own: checks print their result, and main() returns the number of failed checks
+// through Csdr::Test::result(), which is what ctest looks at.
+namespace Csdr {
+    namespace Test {
+
+        inline int& failures() {
+            static int count = 0;
+            return count;
+        }
+
+        inline void check(bool passed, const std::string& description) {
+            std::cerr << (passed ? "PASS " : "FAIL ") << description << "\n";
+            if (!passed) failures()++;
+        }
+
+        inline void checkBelow(const std::string& description, double value, double limit) {
+            std::ostringstream s;
+            s << description << ": " << value << " (limit " << limit << ")";
+            check(value <= limit, s.str());
+        }
+
+        inline void checkAbove(const std::string& description, double value, double limit) {
+            std::ostringstream s;
+            s << description << ": " << value << " (limit " << limit << ")";
+            check(value >= limit, s.str());
+        }
+
+        // informational output, e.g. timings against a reference. never fails, timing is too noisy for that.
+        inline void report(const std::string& description) {
+            std::cerr << "INFO " << description << "\n";
+        }
+
+        inline int result() {
+            if (failures() > 0) std::cerr << failures() << " checks failed\n";
+            return failures() > 0 ? 1 : 0;
+        }
+
+        inline double timeTaken(struct ::timespec start, struct ::timespec end) {
+            return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        }
+
+        // keeps everything that has been written
+        template <typename T>
+        class CollectingWriter: public VoidWriter<T> {
+            public:
+                explicit CollectingWriter(size_t buffer_size): VoidWriter<T>(buffer_size) {}
+                void advance(size_t how_much) override {
+                    T* data = this->getWritePointer();
+                    collected.insert(collected.end(), data, data + how_much);
+                }
+                std::vector<T> collected;
+        };
+
+        // feeds all of the input through the module at once, and returns everything it produced
+        template <typename T, typename U>
+        std::vector<U> runToCompletion(Module<T, U>* module, T* input, size_t size, size_t outputSize) {
+            auto reader = new MemoryReader<T>(input, size);
+            auto writer = new CollectingWriter<U>(outputSize);
+            module->setReader(reader);
+            module->setWriter(writer);
+            while (module->canProcess()) module->process();
+            std::vector<U> result = writer->collected;
+            delete writer;
+            delete reader;
+            return result;
+        }
+
+    }
+}
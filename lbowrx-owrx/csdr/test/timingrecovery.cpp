@@ -0,0 +1,174 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "timingrecovery.hpp"
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <cstdint>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+// the previous TimingRecovery (gardner, using Q): integer sample positions, one symbol per call. the Q error replaced
+// the I error instead of being added to it. returns the number of symbols produced.
+static size_t timingRecoveryInteger(complex<float>* input, size_t length, unsigned int decimation, complex<float>* output) {
+    int num_samples_halfbit = decimation / 2;
+    int num_samples_quarterbit = decimation / 4;
+    int correction_offset = 0;
+    size_t position = 0;
+    size_t count = 0;
+    while (position + num_samples_halfbit * 3 < length) {
+        if (correction_offset <= 0.9 * -num_samples_quarterbit || correction_offset >= 0.9 * num_samples_quarterbit) {
+            correction_offset = 0;
+        }
+        complex<float>* in = input + position;
+        output[count++] = in[num_samples_halfbit];
+        float error = (in[num_samples_halfbit * 3].q() - in[num_samples_halfbit].q()) * in[num_samples_halfbit * 2].q() / 2;
+        if (error > 2.0f) error = 2.0f;
+        if (error < -2.0f) error = -2.0f;
+        correction_offset = (int) (num_samples_halfbit * -1 * error * 0.5f);
+        position += decimation + correction_offset;
+    }
+    return count;
+}
+
+// bit errors of the differentially decoded symbols (1 = no phase reversal), against the best alignment with the
+// transmitted bits. the first symbols are skipped while the loop locks.
+static double pskBitErrorRate(const complex<float>* symbols, size_t count, const std::vector<unsigned char>& bits) {
+    const size_t skip = 50;
+    std::vector<unsigned char> decoded;
+    for (size_t i = 1; i < count; i++) {
+        decoded.push_back(std::real(symbols[i] * std::conj(symbols[i - 1])) > 0 ? 1 : 0);
+    }
+    if (decoded.size() < skip * 2) return 1.0;
+    size_t bestErrors = SIZE_MAX, bestCompared = 1;
+    for (size_t lag = 0; lag < skip; lag++) {
+        size_t errors = 0, compared = 0;
+        for (size_t i = skip; i < decoded.size() && i + lag < bits.size(); i++) {
+            if (decoded[i] != bits[i + lag]) errors++;
+            compared++;
+        }
+        if (compared > 0 && errors * bestCompared < bestErrors * compared) {
+            bestErrors = errors;
+            bestCompared = compared;
+        }
+    }
+    return (double) bestErrors / bestCompared;
+}
+
+int main() {
+    // BPSK31 and BPSK63 like the PSK demodulator sees them, at 12 kS/s (integer samples per symbol) and at 11025 S/s
+    // (fractional). the previous implementation had to round to a multiple of 4 samples per symbol.
+    // the signal is a PSK31 style cosine shaped phase reversal per 0 bit, with an arbitrary carrier phase. the noise is
+    // reduced by a moving average of one symbol length, roughly what the selector bandpass does.
+    const size_t symbols = 5000;
+    std::minstd_rand generator;
+    std::uniform_int_distribution<int> bit(0, 1);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::vector<unsigned char> bits(symbols);
+    for (size_t i = 0; i < symbols; i++) bits[i] = bit(generator);
+    complex<float> carrier = std::polar(1.0f, 0.6f);
+    // what the PSK demodulator uses
+    const float loopGain = 0.1f;
+    struct ::timespec start_time, end_time;
+
+    for (float baud: {31.25f, 62.5f}) {
+        for (unsigned int rate: {12000, 11025}) {
+            float sps = rate / baud;
+            auto length = (size_t) (symbols * sps);
+            auto clean = (complex<float>*) malloc(sizeof(complex<float>) * length);
+            auto noisy = (complex<float>*) malloc(sizeof(complex<float>) * length);
+            auto output = (complex<float>*) malloc(sizeof(complex<float>) * (symbols + 1));
+            float level = 1.0f;
+            std::vector<float> levels = {level};
+            for (size_t k = 0; k < symbols; k++) {
+                if (bits[k] == 0) level = -level;
+                levels.push_back(level);
+            }
+            for (size_t i = 0; i < length; i++) {
+                float t = i / sps;
+                auto k = (size_t) t;
+                float shape = (1.0f + cosf(M_PI * (t - k))) / 2;
+                clean[i] = carrier * (levels[k] * shape + levels[k + 1] * (1.0f - shape));
+            }
+            std::string name = "timing recovery BPSK" + std::to_string((int) (baud + 0.5f)) + " at " + std::to_string(rate) + " S/s";
+
+            for (float ebn0: {6.0f, 10.0f}) {
+                float sigma = sqrtf(sps / powf(10.0f, ebn0 / 10.0f) / 2);
+                auto window = (size_t) roundf(sps);
+                complex<float> sum = 0;
+                std::vector<complex<float>> raw(length);
+                for (size_t i = 0; i < length; i++) {
+                    raw[i] = clean[i] + complex<float>(sigma * gauss(generator), sigma * gauss(generator));
+                    sum += raw[i];
+                    if (i >= window) sum -= raw[i - window];
+                    noisy[i] = sum / (float) window;
+                }
+
+                // sampled at the symbol centers (the moving average delays by half its length)
+                size_t count = 0;
+                for (size_t k = 0; k < symbols && (size_t) (k * sps + (window - 1) / 2.0f) < length; k++) {
+                    output[count++] = noisy[(size_t) (k * sps + (window - 1) / 2.0f)];
+                }
+                double idealBer = pskBitErrorRate(output, count, bits);
+
+                count = timingRecoveryInteger(noisy, length, (unsigned int) roundf(sps) & ~3, output);
+                double integerBer = pskBitErrorRate(output, count, bits);
+
+                auto recovery = new GardnerTimingRecovery(sps, loopGain, 2.0f, true);
+                std::vector<complex<float>> recovered = runToCompletion(recovery, noisy, length, 1);
+                delete recovery;
+                double ber = pskBitErrorRate(recovered.data(), recovered.size(), bits);
+
+                std::string description = name + ", Eb/N0 " + std::to_string((int) ebn0) + " dB";
+                // at most a quarter more bit errors than with ideal timing. at 10 dB, that's only a few bit errors, so
+                // there is some headroom on top.
+                checkBelow(description + ", BER", ber, idealBer * 1.25 + 0.002);
+                checkAbove(description + ", symbols", recovered.size(), symbols - 2);
+                report(description + ": BER with ideal timing " + std::to_string(idealBer) + ", previous implementation " +
+                       std::to_string(integerBer));
+            }
+
+            // throughput on the clean signal
+            auto recovery = new GardnerTimingRecovery(sps, loopGain, 2.0f, true);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+            runToCompletion(recovery, clean, length, 1);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            double batched = timeTaken(start_time, end_time);
+            delete recovery;
+
+            clock_gettime(CLOCK_MONOTONIC_RAW, &start_time);
+            timingRecoveryInteger(clean, length, (unsigned int) roundf(sps) & ~3, output);
+            clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+            double integer = timeTaken(start_time, end_time);
+
+            report(name + ": " + std::to_string(length / batched / 1E6) + " MS/s, previous implementation (without " +
+                   "module overhead) " + std::to_string(length / integer / 1E6) + " MS/s");
+
+            free(clean);
+            free(noisy);
+            free(output);
+        }
+    }
+
+    return result();
+}
@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "complex.hpp"
+
+#include <cmath>
+#include <complex>
+
+// test tones, and how much of a signal is not the tone
+namespace Csdr {
+    namespace Test {
+
+        inline void toneSample(float& sample, double phase) {
+            sample = cos(phase);
+        }
+
+        inline void toneSample(complex<float>& sample, double phase) {
+            sample = { (float) cos(phase), (float) sin(phase) };
+        }
+
+        inline std::complex<double> toneSample(float sample) {
+            return sample;
+        }
+
+        inline std::complex<double> toneSample(complex<float> sample) {
+            return { sample.i(), sample.q() };
+        }
+
+        // power of the signal remaining after removing the component at the given frequency (relative to the sample
+        // rate), relative to the power of that component, in dB. real signals are fitted with a cosine and a sine
+        // (least squares).
+        template <typename T>
+        double toneResidual(T* signal, size_t size, double frequency, bool real) {
+            std::complex<double> amplitude = 0;
+            double cc = 0, ss = 0, cs = 0, xc = 0, xs = 0;
+            for (size_t i = 0; i < size; i++) {
+                std::complex<double> basis = std::polar(1.0, 2 * M_PI * frequency * i);
+                std::complex<double> x = toneSample(signal[i]);
+                amplitude += x * std::conj(basis);
+                cc += basis.real() * basis.real();
+                ss += basis.imag() * basis.imag();
+                cs += basis.real() * basis.imag();
+                xc += x.real() * basis.real();
+                xs += x.real() * basis.imag();
+            }
+            amplitude /= (double) size;
+            double det = cc * ss - cs * cs;
+            double a = (xc * ss - xs * cs) / det;
+            double b = (xs * cc - xc * cs) / det;
+            double tone = 0, residual = 0;
+            for (size_t i = 0; i < size; i++) {
+                std::complex<double> basis = std::polar(1.0, 2 * M_PI * frequency * i);
+                std::complex<double> fit = real ? std::complex<double>(a * basis.real() + b * basis.imag()) : amplitude * basis;
+                tone += std::norm(fit);
+                residual += std::norm(toneSample(signal[i]) - fit);
+            }
+            return 10 * log10(residual / tone);
+        }
+
+        // mean power in dB
+        template <typename T>
+        double signalPower(T* signal, size_t size) {
+            double power = 0;
+            for (size_t i = 0; i < size; i++) power += std::norm(toneSample(signal[i]));
+            return 10 * log10(power / size);
+        }
+
+    }
+}
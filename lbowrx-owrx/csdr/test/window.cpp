@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2021 Jakob Ketterl <jakob.ketterl@gmx.de>
+
+This file is part of libcsdr.
+
+libcsdr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+libcsdr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with libcsdr.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "test.hpp"
+#include "window.hpp"
+
+#include <cmath>
+
+using namespace Csdr;
+using namespace Csdr::Test;
+
+// the filter designs evaluate windows on [-1, 1], apply() and precalculate() on [1, 3]. both have to give the same window.
+static void testWindow(const std::string& name, Window* window, float edge) {
+    const size_t size = 255;
+    auto precalculated = window->precalculate(size);
+    auto ones = (float*) malloc(sizeof(float) * size);
+    auto applied = (float*) malloc(sizeof(float) * size);
+    auto fromTable = (float*) malloc(sizeof(float) * size);
+    for (size_t i = 0; i < size; i++) ones[i] = 1.0f;
+    window->apply(ones, applied, size);
+    precalculated->apply(ones, fromTable, size);
+
+    double deviation = 0;
+    for (size_t i = 0; i < size; i++) {
+        float expected = window->kernel(2.0f * i / (size - 1) - 1.0f);
+        deviation = std::max(deviation, (double) std::fabs(applied[i] - expected));
+        deviation = std::max(deviation, (double) std::fabs(fromTable[i] - expected));
+    }
+    checkBelow(name + " window, deviation between the conventions", deviation, 1E-5);
+    checkBelow(name + " window, deviation from 1 at the center", std::fabs(fromTable[size / 2] - 1.0f), 1E-5);
+    checkBelow(name + " window, value at the edges", std::max(fromTable[0], fromTable[size - 1]), edge);
+
+    delete precalculated;
+    free(ones);
+    free(applied);
+    free(fromTable);
+}
+
+int main() {
+    auto hamming = new HammingWindow();
+    testWindow("hamming", hamming, 0.081f);
+    delete hamming;
+    auto blackman = new BlackmanWindow();
+    testWindow("blackman", blackman, 1E-5f);
+    delete blackman;
+    // kaiser's edge value is 1 / I0(beta)
+    auto kaiser = new KaiserWindow(KaiserWindow::beta(97));
+    testWindow("kaiser", kaiser, 1E-3f);
+    delete kaiser;
+    return result();
+}
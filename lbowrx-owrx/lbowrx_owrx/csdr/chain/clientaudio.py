@@ -4,23 +4,24 @@ from pycsdr.types import Format
 
 
 class Converter(Chain):
-    def __init__(self, format: Format, inputRate: int, clientRate: int):
+    def __init__(self, format: Format, inputRate: int, clientRate: int, resamplerQuality: str = "medium"):
         workers = []
         if inputRate != clientRate:
             # we only have an audio resampler for float ATM so if we need to resample, we need to convert
             if format != Format.FLOAT:
                 workers += [Convert(format, Format.FLOAT)]
-            workers += [AudioResampler(inputRate, clientRate), Limit(), Convert(Format.FLOAT, Format.SHORT)]
+            workers += [AudioResampler(inputRate, clientRate, resamplerQuality), Limit(), Convert(Format.FLOAT, Format.SHORT)]
         elif format != Format.SHORT:
             workers += [Convert(format, Format.SHORT)]
         super().__init__(workers)
 
 
 class ClientAudioChain(Chain):
-    def __init__(self, format: Format, inputRate: int, clientRate: int, compression: str):
+    def __init__(self, format: Format, inputRate: int, clientRate: int, compression: str, resamplerQuality: str = "medium"):
         self.format = format
         self.inputRate = inputRate
         self.clientRate = clientRate
+        self.resamplerQuality = resamplerQuality
         workers = []
         converter = self._buildConverter()
         if not converter.empty():
@@ -30,7 +31,7 @@ class ClientAudioChain(Chain):
         super().__init__(workers)
 
     def _buildConverter(self):
-        return Converter(self.format, self.inputRate, self.clientRate)
+        return Converter(self.format, self.inputRate, self.clientRate, self.resamplerQuality)
 
     def _updateConverter(self):
         converter = self._buildConverter()
@@ -62,6 +63,12 @@ class ClientAudioChain(Chain):
         self.clientRate = clientRate
         self._updateConverter()
 
+    def setResamplerQuality(self, resamplerQuality: str) -> None:
+        if resamplerQuality == self.resamplerQuality:
+            return
+        self.resamplerQuality = resamplerQuality
+        self._updateConverter()
+
     def setAudioCompression(self, compression: str) -> None:
         index = self.indexOf(lambda x: isinstance(x, AdpcmEncoder))
         if compression == "adpcm":
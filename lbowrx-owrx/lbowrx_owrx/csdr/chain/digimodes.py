@@ -71,10 +71,11 @@ class PskDemodulator(SecondaryDemodulator, SecondarySelectorChain):
         self.baudRate = baudRate
         # this is an assumption, we will adjust in setSampleRate
         self.sampleRate = 12000
-        secondary_samples_per_bits = int(round(self.sampleRate / self.baudRate)) & ~3
+        # timing recovery interpolates between samples, so this doesn't have to be an integer
+        secondary_samples_per_bits = self.sampleRate / self.baudRate
         workers = [
             Agc(Format.COMPLEX_FLOAT),
-            TimingRecovery(secondary_samples_per_bits, 0.5, 2, useQ=True),
+            TimingRecovery(secondary_samples_per_bits, 0.1, 2, useQ=True),
             DBPskDecoder(),
             VaricodeDecoder(),
         ]
@@ -87,5 +88,5 @@ class PskDemodulator(SecondaryDemodulator, SecondarySelectorChain):
         if sampleRate == self.sampleRate:
             return
         self.sampleRate = sampleRate
-        secondary_samples_per_bits = int(round(self.sampleRate / self.baudRate)) & ~3
-        self.replace(1, TimingRecovery(secondary_samples_per_bits, 0.5, 2, useQ=True))
+        secondary_samples_per_bits = self.sampleRate / self.baudRate
+        self.replace(1, TimingRecovery(secondary_samples_per_bits, 0.1, 2, useQ=True))
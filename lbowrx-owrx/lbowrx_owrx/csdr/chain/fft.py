@@ -1,5 +1,9 @@
 from csdr.chain import Chain
-from pycsdr.modules import Fft, LogPower, LogAveragePower, FftSwap, FftAdpcm
+from pycsdr.modules import Fft, PolyphaseFft, LogPower, LogAveragePower, FftSwap, FftAdpcm, FftDelta, WaterfallEngine
+
+
+# needs to match COMPRESS_FFT_PAD_N in csdr
+FFT_ADPCM_PADDING = 10
 
 
 class FftAverager(Chain):
@@ -23,36 +27,117 @@ class FftAverager(Chain):
 
 
 class FftChain(Chain):
-    def __init__(self, samp_rate, fft_size, fft_v_overlap_factor, fft_fps, fft_compression):
+    def __init__(self, samp_rate, fft_size, fft_v_overlap_factor, fft_fps, fft_compression, fft_engine="chain", fft_levels=1, fft_threads=1, fft_taps=1, power_tap=None, occupancy_index=None):
         self.sampleRate = samp_rate
         self.vOverlapFactor = fft_v_overlap_factor
         self.fps = fft_fps
         self.size = fft_size
+        self.compression = fft_compression
+        self.levels = fft_levels
+        self.threads = fft_threads
+        # taps per bin of the polyphase (WOLA) estimator, 1 for a plain windowed FFT
+        self.taps = fft_taps
+        # BandPowerTap measuring the user passbands on every frame
+        self.powerTap = power_tap
+        # OccupancyIndex fed with every (uncompressed) line
+        self.occupancyIndex = occupancy_index
 
         self.blockSize = 0
-
-        self.fft = Fft(size=self.size, every_n_samples=self.blockSize)
-        self.averager = FftAverager(fft_size=self.size, fft_averages=10)
-        self.fftExchangeSides = FftSwap(fft_size=self.size)
-        workers = [
-            self.fft,
-            self.averager,
-            self.fftExchangeSides,
-        ]
-        self.compressFftAdpcm = None
-        if fft_compression == "adpcm":
-            self.compressFftAdpcm = FftAdpcm(fft_size=self.size)
-            workers += [self.compressFftAdpcm]
+        self.fftAverages = 0
+
+        self.fft = None
+        self.averager = None
+        self.engine = None
+        self.compressor = None
+        # multiple resolution levels are only available from the fused engine
+        if fft_engine == "fused" or self.levels > 1:
+            # fft, averaging, side swap and compression in a single module
+            self.engine = self._getEngine()
+            workers = [self.engine]
+        else:
+            if self.taps > 1:
+                self.fft = PolyphaseFft(size=self.size, taps=self.taps, every_n_samples=self.blockSize, threads=self.threads)
+            else:
+                self.fft = Fft(size=self.size, every_n_samples=self.blockSize, threads=self.threads)
+            if self.powerTap is not None:
+                self.fft.setPowerTap(self.powerTap)
+            self.averager = FftAverager(fft_size=self.size, fft_averages=10)
+            self.fftExchangeSides = FftSwap(fft_size=self.size)
+            workers = [
+                self.fft,
+                self.averager,
+                self.fftExchangeSides,
+            ]
+            if self.occupancyIndex is not None:
+                workers += [self.occupancyIndex]
+        self.compressor = self._getCompressor()
+        if self.compressor is not None:
+            workers += [self.compressor]
 
         self._updateParameters()
 
         super().__init__(workers)
 
+    def _getCompressor(self):
+        if self.compression == "delta":
+            return FftDelta(fft_size=self.size)
+        # the fused engine does adpcm by itself
+        if self.compression == "adpcm" and self.engine is None:
+            return FftAdpcm(fft_size=self.size)
+        return None
+
+    def _getEngine(self):
+        # delta coded lines have variable length, so they cannot carry multiple levels
+        delta = self.compression == "delta"
+        engine = WaterfallEngine(
+            size=self.size,
+            every_n_samples=self.blockSize,
+            avg_number=self.fftAverages,
+            add_db=-70,
+            compression="none" if delta else self.compression,
+            levels=1 if delta else self.levels,
+            threads=self.threads,
+            taps=self.taps,
+        )
+        if self.powerTap is not None:
+            engine.setPowerTap(self.powerTap)
+        if self.occupancyIndex is not None:
+            engine.setOccupancyIndex(self.occupancyIndex)
+        return engine
+
+    def getLevelSizes(self):
+        """
+        size in bytes of the individual resolution levels that make up one line of output
+        """
+        if self.compression == "delta":
+            # variable length, always a single level
+            return [None]
+        sizes = []
+        for level in range(self.levels):
+            bins = self.size >> level
+            if self.compression == "adpcm":
+                sizes.append((FFT_ADPCM_PADDING + bins) // 2)
+            else:
+                sizes.append(bins * 4)
+        return sizes
+
     def _setBlockSize(self, fft_block_size):
         if self.blockSize == int(fft_block_size):
             return
         self.blockSize = int(fft_block_size)
-        self.fft.setEveryNSamples(self.blockSize)
+        if self.engine is not None:
+            self.engine.setEveryNSamples(self.blockSize)
+        else:
+            self.fft.setEveryNSamples(self.blockSize)
+
+    def setThreads(self, fft_threads):
+        if self.threads == fft_threads:
+            return
+        self.threads = fft_threads
+        if self.engine is not None:
+            self.engine.setThreads(self.threads)
+        else:
+            self.fft.setThreads(self.threads)
 
     def setVOverlapFactor(self, fft_v_overlap_factor):
         if self.vOverlapFactor == fft_v_overlap_factor:
@@ -77,7 +162,11 @@ class FftChain(Chain):
 
         if self.vOverlapFactor > 0:
             fftAverages = int(round(1.0 * self.sampleRate / self.size / self.fps / (1.0 - self.vOverlapFactor)))
-        self.averager.setFftAverages(fftAverages)
+        self.fftAverages = fftAverages
+        if self.engine is not None:
+            self.engine.setAvgNumber(fftAverages)
+        else:
+            self.averager.setFftAverages(fftAverages)
 
         if fftAverages == 0:
             self._setBlockSize(self.sampleRate / self.fps)
@@ -85,12 +174,30 @@ class FftChain(Chain):
             self._setBlockSize(self.sampleRate / self.fps / fftAverages)
 
     def setCompression(self, compression: str) -> None:
-        if compression == "adpcm" and not self.compressFftAdpcm:
-            self.compressFftAdpcm = FftAdpcm(self.size)
-            # should always be at the end
-            self.append(self.compressFftAdpcm)
-        elif compression == "none" and self.compressFftAdpcm:
-            self.compressFftAdpcm.stop()
-            self.compressFftAdpcm = None
-            # should always be at that position (right?)
-            self.remove(3)
+        if compression == self.compression:
+            return
+        self.compression = compression
+        # the intermediate steps may connect incompatible formats to the writer. store the error for later raising,
+        # but still complete the chain
+        error = None
+        # the compressor, if any, is always at the end of the chain
+        if self.compressor is not None:
+            try:
+                self.remove(len(self.workers) - 1)
+            except ValueError as e:
+                error = e
+        if self.engine is not None:
+            self.engine = self._getEngine()
+            try:
+                self.replace(0, self.engine)
+            except ValueError as e:
+                error = e
+        self.compressor = self._getCompressor()
+        if self.compressor is not None:
+            try:
+                self.append(self.compressor)
+            except ValueError as e:
+                error = e
+        if error is not None:
+            raise error
+
@@ -1,5 +1,6 @@
 from csdr.chain import Chain
-from pycsdr.modules import Shift, FirDecimate, Bandpass, Squelch, FractionalDecimator, Writer
+from pycsdr.modules import Shift, FirDecimate, Bandpass, Squelch, SquelchGate, BandPowerTap, FractionalDecimator, Writer
+from typing import Optional
 from pycsdr.types import Format
 import math
 
@@ -62,10 +63,17 @@ class Decimator(Chain):
 
 
 class Selector(Chain):
-    def __init__(self, inputRate: int, outputRate: int, withSquelch: bool = True):
+    # the squelch closes 2 dB below the opening level, and only after a short hold time (in seconds)
+    squelchHysteresis = 2
+    squelchHoldTime = 0.25
+
+    def __init__(self, inputRate: int, outputRate: int, withSquelch: bool = True, powerTap: Optional[BandPowerTap] = None):
         self.inputRate = inputRate
         self.outputRate = outputRate
         self.frequencyOffset = 0
+        # with a power tap, s-meter and squelch are driven from the shared spectrum FFT instead of a Squelch module
+        self.powerTap = powerTap if withSquelch else None
+        self.powerTapBand = None
 
         self.shift = Shift(0.0)
 
@@ -77,11 +85,16 @@ class Selector(Chain):
 
         workers = [self.shift, self.decimation, self.bandpass]
 
-        if withSquelch:
+        if self.powerTap is not None:
+            # the squelch decision doesn't depend on the channel data, so the gate goes in front of the selector.
+            # while it's closed, nothing behind it (selector and demodulator) has anything to do.
+            self.squelch = SquelchGate(self._getGateFlush())
+            self.powerTapBand = self.powerTap.addBand(*self._getTapBand())
+            workers = [self.squelch] + workers
+        elif withSquelch:
             self.readings_per_second = 4
-            # s-meter readings are available every 1024 samples
-            # the reporting interval is measured in those 1024-sample blocks
-            self.squelch = Squelch(5, int(outputRate / (self.readings_per_second * 1024)))
+            # readings are averaged over the report interval, so every sample is measured.
+            self.squelch = Squelch(1, self._getReportInterval(), self._convertToLinear(self.squelchHysteresis), self._getHoldTime())
             workers += [self.squelch]
 
         super().__init__(workers)
@@ -99,17 +112,50 @@ class Selector(Chain):
     def _updateShift(self):
         shift = -self.frequencyOffset / self.inputRate
         self.shift.setRate(shift)
+        self._updateTapBand()
+
+    def _getGateFlush(self) -> int:
+        # the same amount of zeros at the output as the squelch would produce (5 blocks of 1024 samples)
+        return 5120 * math.ceil(self.inputRate / self.outputRate)
+
+    def _getReportInterval(self) -> int:
+        # s-meter readings are available every 1024 samples
+        # the reporting interval is measured in those 1024-sample blocks
+        return max(1, int(self.outputRate / (self.readings_per_second * 1024)))
+
+    def _getHoldTime(self) -> int:
+        # in 1024-sample blocks
+        return int(self.outputRate * self.squelchHoldTime / 1024)
+
+    def _getTapBand(self):
+        # passband relative to the spectrum FFT input
+        return [(self.frequencyOffset + x) / self.inputRate for x in self.bandpassCutoffs]
+
+    def _updateTapBand(self):
+        if self.powerTapBand is None:
+            return
+        self.powerTap.setBand(self.powerTapBand, *self._getTapBand())
 
     def _convertToLinear(self, db: float) -> float:
         return float(math.pow(10, db / 10))
 
     def setSquelchLevel(self, level: float) -> None:
-        self.squelch.setSquelchLevel(self._convertToLinear(level))
+        if self.powerTapBand is not None:
+            self.powerTap.setSquelch(
+                self.powerTapBand,
+                self._convertToLinear(level),
+                self.squelch,
+                self._convertToLinear(self.squelchHysteresis),
+                self.squelchHoldTime,
+            )
+        else:
+            self.squelch.setSquelchLevel(self._convertToLinear(level))
 
     def setBandpass(self, lowCut: float, highCut: float) -> None:
         self.bandpassCutoffs = [lowCut, highCut]
         scaled = [x / self.outputRate for x in self.bandpassCutoffs]
         self.bandpass.setBandpass(*scaled)
+        self._updateTapBand()
 
     def setLowCut(self, lowCut: float) -> None:
         self.bandpassCutoffs[0] = lowCut
@@ -120,7 +166,10 @@ class Selector(Chain):
         self.setBandpass(*self.bandpassCutoffs)
 
     def setPowerWriter(self, writer: Writer) -> None:
-        self.squelch.setPowerWriter(writer)
+        if self.powerTapBand is not None:
+            self.powerTap.setWriter(self.powerTapBand, writer)
+        else:
+            self.squelch.setPowerWriter(writer)
 
     def setOutputRate(self, outputRate: int) -> None:
         if outputRate == self.outputRate:
@@ -128,18 +177,31 @@ class Selector(Chain):
         self.outputRate = outputRate
 
         self.decimation.setOutputRate(outputRate)
-        self.squelch.setReportInterval(int(outputRate / (self.readings_per_second * 1024)))
+        if self.powerTapBand is None:
+            self.squelch.setReportInterval(self._getReportInterval())
+            self.squelch.setHoldTime(self._getHoldTime())
+        else:
+            self.squelch.setFlush(self._getGateFlush())
+        index = self.indexOf(self.bandpass)
         self.bandpass = self._buildBandpass()
         self.setBandpass(*self.bandpassCutoffs)
-        self.replace(2, self.bandpass)
+        self.replace(index, self.bandpass)
 
     def setInputRate(self, inputRate: int) -> None:
         if inputRate == self.inputRate:
             return
         self.inputRate = inputRate
         self.decimation.setInputRate(inputRate)
+        if self.powerTapBand is not None:
+            self.squelch.setFlush(self._getGateFlush())
         self._updateShift()
 
+    def stop(self):
+        if self.powerTapBand is not None:
+            self.powerTap.removeBand(self.powerTapBand)
+            self.powerTapBand = None
+        super().stop()
+
 
 class SecondarySelector(Chain):
     def __init__(self, sampleRate: int, bandwidth: float):
@@ -14,7 +14,13 @@ defaultConfig = PropertyLayer(
     fft_fps=9,
     fft_size=4096,
     fft_voverlap_factor=0.3,
+    fft_engine="chain",
+    fft_pyramid_levels=1,
+    fft_threads=1,
+    fft_polyphase_taps=1,
+    fft_power_tap=False,
     audio_compression="adpcm",
+    audio_resampler_quality="medium",
     fft_compression="adpcm",
     wfm_deemphasis_tau=50e-6,
     digimodes_fft_size=2048,
@@ -118,6 +118,7 @@ class OpenWebRxReceiverClient(OpenWebRxClient, SdrSourceEventClient):
         "fft_size",
         "audio_compression",
         "fft_compression",
+        "fft_pyramid_levels",
         "max_clients",
         "tuning_precision",
     ]
@@ -131,6 +132,7 @@ class OpenWebRxReceiverClient(OpenWebRxClient, SdrSourceEventClient):
         self.configSubs = []
         self.bookmarkSub = None
         self.connectionProperties = {}
+        self.fftLevel = 0
 
         try:
             ClientRegistry.getSharedInstance().addClient(self)
@@ -262,6 +264,13 @@ class OpenWebRxReceiverClient(OpenWebRxClient, SdrSourceEventClient):
                         if self.dsp:
                             self.getDsp().setProperties(self.connectionProperties)
 
+                elif message["type"] == "fftlevel":
+                    if "params" in message and "level" in message["params"]:
+                        try:
+                            self.fftLevel = max(0, int(message["params"]["level"]))
+                        except (TypeError, ValueError):
+                            logger.warning("invalid fft level: %s", message["params"]["level"])
+
                 elif message["type"] == "sdrselection":
                     if "params" in message:
                         if "sdrid" in message["params"]:
@@ -332,8 +341,9 @@ class OpenWebRxReceiverClient(OpenWebRxClient, SdrSourceEventClient):
                 self.dsp = DspManager(self, self.sdr)
         return self.dsp
 
-    def write_spectrum_data(self, data):
-        self.mp_send(bytes([0x01]) + data)
+    def write_spectrum_data(self, levels):
+        # levels are ordered from full resolution down, clients may request more levels than there are
+        self.mp_send(bytes([0x01]) + levels[max(0, min(self.fftLevel, len(levels) - 1))])
 
     def write_dsp_data(self, data):
         self.send(bytes([0x02]) + data)
@@ -5,6 +5,7 @@ from owrx.form.input import (
     TextInput,
     NumberInput,
     FloatInput,
+    CheckboxInput,
     TextAreaInput,
     DropdownInput,
     Option,
@@ -110,6 +111,42 @@ class GeneralSettingsController(SettingsFormController):
                     infotext="If fft_voverlap_factor is above 0, multiple FFTs will be used for creating a line on the "
                     + "diagram.",
                 ),
+                DropdownInput(
+                    "fft_engine",
+                    "FFT engine",
+                    infotext="The fused engine computes FFT, averaging and compression in a single pass and uses "
+                    + "less CPU. Changing this setting restarts the spectrum.",
+                    options=[
+                        Option("chain", "Separate modules"),
+                        Option("fused", "Fused waterfall engine"),
+                    ],
+                ),
+                NumberInput(
+                    "fft_pyramid_levels",
+                    "Waterfall resolution levels",
+                    infotext="Number of resolutions (FFT size, 1/2, 1/4, ...) computed from each FFT. Clients receive "
+                    + "the smallest one that still fits their screen. Values above 1 always use the fused engine.",
+                ),
+                NumberInput(
+                    "fft_polyphase_taps",
+                    "FFT polyphase taps",
+                    infotext="Number of FFT frames per bin that are combined by the polyphase (WOLA) spectrum "
+                    + "estimator. Values of 4 to 8 greatly reduce the leakage of strong signals into neighbouring bins "
+                    + "at a small CPU cost. Set to 1 for a plain windowed FFT.",
+                ),
+                NumberInput(
+                    "fft_threads",
+                    "FFT threads",
+                    infotext="Number of CPU threads used for each FFT. This only pays off for very large FFT sizes "
+                    + "(above 65536 bins) at high frame rates.",
+                ),
+                CheckboxInput(
+                    "fft_power_tap",
+                    "Measure S-meter and squelch on the waterfall FFT",
+                    infotext="Instead of a separate power measurement on every user channel, the signal levels of "
+                    + "all users are taken from the waterfall FFT. This saves CPU with many users. Squelch reacts "
+                    + "with the FFT frame rate. Applies to new connections.",
+                ),
                 WaterfallLevelsInput("waterfall_levels", "Waterfall levels"),
                 WaterfallAutoLevelsInput(
                     "waterfall_auto_levels",
@@ -138,12 +175,30 @@ class GeneralSettingsController(SettingsFormController):
                 DropdownInput(
                     "fft_compression",
                     "Waterfall compression",
+                    infotext="Delta compression sends 8-bit levels coded against the previous line and needs the "
+                    + "least bandwidth. It does not support multiple waterfall resolution levels.",
                     options=[
                         Option("adpcm", "ADPCM"),
+                        Option("delta", "Delta"),
                         Option("none", "None"),
                     ],
                 ),
             ),
+            Section(
+                "Audio",
+                DropdownInput(
+                    "audio_resampler_quality",
+                    "Audio resampler quality",
+                    infotext="Quality of the resampler that converts the demodulator output to the sample rate of "
+                    + "the client's sound card. Higher quality means better suppression of aliasing at the cost of "
+                    + "CPU time for every client.",
+                    options=[
+                        Option("low", "Low"),
+                        Option("medium", "Medium"),
+                        Option("high", "High"),
+                    ],
+                ),
+            ),
             Section(
                 "Display settings",
                 DropdownInput(
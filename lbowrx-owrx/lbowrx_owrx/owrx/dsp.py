@@ -8,7 +8,7 @@ from csdr.chain.selector import Selector, SecondarySelector
 from csdr.chain.clientaudio import ClientAudioChain
 from csdr.chain.fft import FftChain
 from csdr.chain.dummy import DummyDemodulator
-from pycsdr.modules import Buffer, Writer
+from pycsdr.modules import Buffer, Writer, BandPowerTap
 from pycsdr.types import Format
 from typing import Union, Optional
 from io import BytesIO
@@ -34,12 +34,12 @@ class ClientDemodulatorSecondaryDspEventClient(ABC):
 
 
 class ClientDemodulatorChain(Chain):
-    def __init__(self, demod: BaseDemodulatorChain, sampleRate: int, outputRate: int, hdOutputRate: int, audioCompression: str, secondaryDspEventReceiver: ClientDemodulatorSecondaryDspEventClient):
+    def __init__(self, demod: BaseDemodulatorChain, sampleRate: int, outputRate: int, hdOutputRate: int, audioCompression: str, secondaryDspEventReceiver: ClientDemodulatorSecondaryDspEventClient, powerTap: Optional[BandPowerTap] = None, resamplerQuality: str = "medium"):
         self.sampleRate = sampleRate
         self.outputRate = outputRate
         self.hdOutputRate = hdOutputRate
         self.secondaryDspEventReceiver = secondaryDspEventReceiver
-        self.selector = Selector(sampleRate, outputRate)
+        self.selector = Selector(sampleRate, outputRate, powerTap=powerTap)
         self.selector.setBandpass(-4000, 4000)
         self.selectorBuffer = Buffer(Format.COMPLEX_FLOAT)
         self.audioBuffer = None
@@ -50,7 +50,7 @@ class ClientDemodulatorChain(Chain):
         self.wfmDeemphasisTau = 50e-6
         inputRate = demod.getFixedAudioRate() if isinstance(demod, FixedAudioRateChain) else outputRate
         oRate = hdOutputRate if isinstance(demod, HdAudio) else outputRate
-        self.clientAudioChain = ClientAudioChain(demod.getOutputFormat(), inputRate, oRate, audioCompression)
+        self.clientAudioChain = ClientAudioChain(demod.getOutputFormat(), inputRate, oRate, audioCompression, resamplerQuality)
         self.secondaryFftSize = 2048
         self.secondaryFftOverlapFactor = 0.3
         self.secondaryFftFps = 9
@@ -251,6 +251,9 @@ class ClientDemodulatorChain(Chain):
     def setAudioCompression(self, compression: str) -> None:
         self.clientAudioChain.setAudioCompression(compression)
 
+    def setResamplerQuality(self, resamplerQuality: str) -> None:
+        self.clientAudioChain.setResamplerQuality(resamplerQuality)
+
     def setSquelchLevel(self, level: float) -> None:
         if level == self.squelchLevel:
             return
@@ -364,7 +367,7 @@ class ClientDemodulatorChain(Chain):
         self.secondaryFftChain.setFps(self.secondaryFftFps)
 
     def getSecondaryFftOutputFormat(self) -> Format:
-        if self.secondaryFftCompression == "adpcm":
+        if self.secondaryFftCompression in ["adpcm", "delta"]:
             return Format.CHAR
         return Format.SHORT
 
@@ -426,6 +429,8 @@ class DspManager(SdrSourceEventClient, ClientDemodulatorSecondaryDspEventClient)
                 "start_freq",
                 "wfm_deemphasis_tau",
                 "digital_voice_codecserver",
+                "fft_power_tap",
+                "audio_resampler_quality",
             ),
         )
 
@@ -436,6 +441,8 @@ class DspManager(SdrSourceEventClient, ClientDemodulatorSecondaryDspEventClient)
                 output_rate=12000,
                 hd_output_rate=48000,
                 digital_voice_codecserver="",
+                fft_power_tap=False,
+                audio_resampler_quality="medium",
             ).readonly()
         )
 
@@ -445,7 +452,9 @@ class DspManager(SdrSourceEventClient, ClientDemodulatorSecondaryDspEventClient)
             self.props["output_rate"],
             self.props["hd_output_rate"],
             self.props["audio_compression"],
-            self
+            self,
+            self.sdrSource.getPowerTap() if self.props["fft_power_tap"] else None,
+            self.props["audio_resampler_quality"],
         )
 
         self.readers = {}
@@ -470,6 +479,7 @@ class DspManager(SdrSourceEventClient, ClientDemodulatorSecondaryDspEventClient)
 
         self.subscriptions = [
             self.props.wireProperty("audio_compression", self.setAudioCompression),
+            self.props.wireProperty("audio_resampler_quality", self.chain.setResamplerQuality),
             self.props.wireProperty("fft_compression", self.chain.setSecondaryFftCompression),
             self.props.wireProperty("fft_voverlap_factor", self.chain.setSecondaryFftOverlapFactor),
             self.props.wireProperty("fft_fps", self.chain.setSecondaryFftFps),
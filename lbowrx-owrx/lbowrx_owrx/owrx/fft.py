@@ -24,10 +24,17 @@ class SpectrumThread(SdrSourceEventClient):
             "fft_fps",
             "fft_voverlap_factor",
             "fft_compression",
+            "fft_engine",
+            "fft_pyramid_levels",
+            "fft_threads",
+            "fft_polyphase_taps",
+            "fft_power_tap",
         )
 
         self.dsp = None
         self.reader = None
+        self.levelSizes = []
+        self.pending = b""
 
         self.subscriptions = []
 
@@ -42,16 +49,23 @@ class SpectrumThread(SdrSourceEventClient):
             self.props['fft_size'],
             self.props['fft_voverlap_factor'],
             self.props['fft_fps'],
-            self.props['fft_compression']
+            self.props['fft_compression'],
+            self.props['fft_engine'],
+            self.props['fft_pyramid_levels'],
+            self.props['fft_threads'],
+            self.props['fft_polyphase_taps'],
+            # the tap measures every frame, so it is only attached when the demodulators make use of it
+            self.sdrSource.getPowerTap() if self.props['fft_power_tap'] else None,
         )
         self.sdrSource.addClient(self)
 
         self.subscriptions += [
-            self.props.filter("fft_size").wire(self.restart),
+            self.props.filter("fft_size", "fft_engine", "fft_pyramid_levels", "fft_polyphase_taps", "fft_power_tap").wire(self.restart),
             # these props can be set on the fly
             self.props.wireProperty("samp_rate", self.dsp.setSampleRate),
             self.props.wireProperty("fft_fps", self.dsp.setFps),
             self.props.wireProperty("fft_voverlap_factor", self.dsp.setVOverlapFactor),
+            self.props.wireProperty("fft_threads", self.dsp.setThreads),
             self.props.wireProperty("fft_compression", self._setCompression),
         ]
 
@@ -70,7 +84,26 @@ class SpectrumThread(SdrSourceEventClient):
         buffer = Buffer(self.dsp.getOutputFormat())
         self.dsp.setWriter(buffer)
         self.reader = buffer.getReader()
-        threading.Thread(target=self.dsp.pump(self.reader.read, self.sdrSource.writeSpectrumData)).start()
+        self.levelSizes = self.dsp.getLevelSizes()
+        self.pending = b""
+        threading.Thread(target=self.dsp.pump(self.reader.read, self._writeSpectrumData)).start()
+
+    def _writeSpectrumData(self, data):
+        if len(self.levelSizes) == 1:
+            self.sdrSource.writeSpectrumData([data])
+            return
+
+        # multiple resolution levels are concatenated in every line, so we need to split them up
+        self.pending += bytes(data)
+        lineSize = sum(self.levelSizes)
+        while len(self.pending) >= lineSize:
+            levels = []
+            offset = 0
+            for size in self.levelSizes:
+                levels.append(self.pending[offset:offset + size])
+                offset += size
+            self.pending = self.pending[lineSize:]
+            self.sdrSource.writeSpectrumData(levels)
 
     def stop(self):
         if self.dsp is None:
@@ -22,7 +22,7 @@ from owrx.feature import FeatureDetector
 from typing import List
 from enum import Enum
 
-from pycsdr.modules import TcpSource, Buffer
+from pycsdr.modules import TcpSource, Buffer, BandPowerTap
 from pycsdr.types import Format
 
 import logging
@@ -142,6 +142,9 @@ class SdrSource(ABC):
         self.clients = []
         self.spectrumClients = []
         self.spectrumThread = None
+        self.powerTap = None
+        # separate from the spectrumLock, the spectrum thread asks for the tap while that is held
+        self.powerTapLock = threading.Lock()
         self.spectrumLock = threading.Lock()
         self.process = None
         self.modificationLock = threading.Lock()
@@ -458,9 +461,18 @@ class SdrSource(ABC):
                 self.spectrumThread.stop()
                 self.spectrumThread = None
 
-    def writeSpectrumData(self, data):
+    def getPowerTap(self) -> BandPowerTap:
+        """
+        channel power measurement on the spectrum FFT, shared by all clients of this source
+        """
+        with self.powerTapLock:
+            if self.powerTap is None:
+                self.powerTap = BandPowerTap(report_interval=0.25)
+            return self.powerTap
+
+    def writeSpectrumData(self, levels):
         for c in self.spectrumClients:
-            c.write_spectrum_data(data)
+            c.write_spectrum_data(levels)
 
     def getState(self) -> SdrSourceState:
         return self.state
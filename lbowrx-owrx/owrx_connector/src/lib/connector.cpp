@@ -4,6 +4,7 @@
 #include "rtl_tcp_connection.hpp"
 #include "control_connection.hpp"
 #include "fmv.h"
+#include <csdr/converter.hpp>
 #include <stdlib.h>
 #include <algorithm>
 #include <numeric>
@@ -358,20 +359,12 @@ template void Connector::processSamples<int16_t>(int16_t*, uint32_t);
 template void Connector::processSamples<int32_t>(int32_t*, uint32_t);
 template void Connector::processSamples<uint8_t>(uint8_t*, uint32_t);
 
-OWRX_CONNECTOR_TARGET_CLONES
-void Connector::convert(uint8_t* __restrict__ input, float* __restrict__ output, uint32_t len) {
-    uint32_t i;
-    for (i = 0; i < len; i++) {
-        output[i] = ((float) (input[i])) / (UINT8_MAX / 2.0f) - 1.0f;
-    }
+void Connector::convert(uint8_t* input, float* output, uint32_t len) {
+    Csdr::Converter<uint8_t, float>::convert(input, output, len);
 }
 
-OWRX_CONNECTOR_TARGET_CLONES
-void Connector::convert(int16_t* __restrict__ input, float* __restrict__ output, uint32_t len) {
-    uint32_t i;
-    for (i = 0; i < len; i++) {
-        output[i] = (float)input[i] / INT16_MAX;
-    }
+void Connector::convert(int16_t* input, float* output, uint32_t len) {
+    Csdr::Converter<int16_t, float>::convert(input, output, len);
 }
 
 OWRX_CONNECTOR_TARGET_CLONES
@@ -390,12 +383,8 @@ void Connector::convert(uint8_t* input, uint8_t* output, uint32_t len) {
     std::memcpy(output, input, len * sizeof(uint8_t));
 }
 
-OWRX_CONNECTOR_TARGET_CLONES
-void Connector::convert(int16_t* __restrict__ input, uint8_t* __restrict__ output, uint32_t len) {
-    uint32_t i;
-    for (i = 0; i < len; i++) {
-        output[i] = input[i] / 32767.0f * 128.0f + 127.4f;
-    }
+void Connector::convert(int16_t* input, uint8_t* output, uint32_t len) {
+    Csdr::Converter<int16_t, uint8_t>::convert(input, output, len);
 }
 
 OWRX_CONNECTOR_TARGET_CLONES
@@ -406,12 +395,8 @@ void Connector::convert(int32_t* __restrict__ input, uint8_t* __restrict__ outpu
     }
 }
 
-OWRX_CONNECTOR_TARGET_CLONES
-void Connector::convert(float* __restrict__ input, uint8_t* __restrict__ output, uint32_t len) {
-    uint32_t i;
-    for (i = 0; i < len; i++) {
-        output[i] = input[i] * UCHAR_MAX * 0.5f + 128;
-    }
+void Connector::convert(float* input, uint8_t* output, uint32_t len) {
+    Csdr::Converter<float, uint8_t>::convert(input, output, len);
 }
 
 static std::string trim(const std::string &s) {
@@ -1,9 +1,17 @@
+from typing import Optional, List, Tuple
 from pycsdr.types import Format, AgcProfile
 
 version: str = ...
 csdr_version: str = ...
 
 
+def getTapCacheUsage() -> Tuple[int, int]:
+    """
+    number of filter taps and windows currently shared between modules, and the memory they use (in bytes)
+    """
+    ...
+
+
 class Writer:
     ...
 
@@ -71,12 +79,32 @@ class TcpSource(Source):
 
 
 class Fft(Module):
-    def __init__(self, size: int, every_n_samples: int):
+    def __init__(self, size: int, every_n_samples: int, threads: int = 1, format: Format = Format.COMPLEX_FLOAT):
+        ...
+
+    def setEveryNSamples(self, every_n_samples: int) -> None:
+        ...
+
+    def setThreads(self, threads: int) -> None:
+        ...
+
+    def setPowerTap(self, tap: Optional[BandPowerTap]) -> None:
+        ...
+
+
+class PolyphaseFft(Module):
+    def __init__(self, size: int, taps: int, every_n_samples: int, threads: int = 1):
         ...
 
     def setEveryNSamples(self, every_n_samples: int) -> None:
         ...
 
+    def setThreads(self, threads: int) -> None:
+        ...
+
+    def setPowerTap(self, tap: Optional[BandPowerTap]) -> None:
+        ...
+
 
 class LogPower(Module):
     def __init__(self, add_db: float = 0.0):
@@ -101,13 +129,49 @@ class FftAdpcm(Module):
         ...
 
 
+class FftDelta(Module):
+    def __init__(self, fft_size: int, floor: int = -140, range: int = 120, keyframe_interval: int = 16):
+        ...
+
+
+class WaterfallEngine(Module):
+    def __init__(self, size: int, every_n_samples: int, avg_number: int = 0, add_db: float = 0.0, compression: str = "adpcm", levels: int = 1, pyramid_mode: str = "max", threads: int = 1, taps: int = 1):
+        ...
+
+    def setEveryNSamples(self, every_n_samples: int) -> None:
+        ...
+
+    def setAvgNumber(self, avg_number: int) -> None:
+        ...
+
+    def setThreads(self, threads: int) -> None:
+        ...
+
+    def setPowerTap(self, tap: Optional[BandPowerTap]) -> None:
+        ...
+
+    def setOccupancyIndex(self, index: Optional[OccupancyIndex]) -> None:
+        ...
+
+
+class ZoomFft(Module):
+    def __init__(self, center: float, decimation: int, size: int, every_n_samples: int):
+        ...
+
+    def setCenter(self, center: float) -> None:
+        ...
+
+    def setEveryNSamples(self, every_n_samples: int) -> None:
+        ...
+
+
 class FirDecimate(Module):
-    def __init__(self, decimation: int, transition: float = 0.05, cutoff: float = 0.5):
+    def __init__(self, decimation: int, transition: float = 0.05, cutoff: float = 0.5, format: Format = Format.COMPLEX_FLOAT, design: str = "window", ripple: float = 0.1, attenuation: float = 60.0):
         ...
 
 
 class Bandpass(Module):
-    def __init__(self, low_cut: float = 0.0, high_cut: float = 0.0, transition: float = 0.0, use_fft: bool = True):
+    def __init__(self, low_cut: float = 0.0, high_cut: float = 0.0, transition: float = 0.0, use_fft: bool = True, design: str = "window", ripple: float = 0.1, attenuation: float = 60.0):
         ...
 
     def setBandpass(self, low_cut: float, high_cut: float) -> None:
@@ -115,7 +179,7 @@ class Bandpass(Module):
 
 
 class Shift(Module):
-    def __init__(self, rate: float = 0.0):
+    def __init__(self, rate: float = 0.0, format: Format = Format.COMPLEX_FLOAT):
         ...
 
     def setRate(self, rate: float):
@@ -128,7 +192,7 @@ class Convert(Module):
 
 
 class Squelch(Module):
-    def __init__(self, decimation: int, reportInterval: int):
+    def __init__(self, decimation: int, reportInterval: int, hysteresis: float = 1.0, holdTime: int = 0):
         ...
 
     def setSquelchLevel(self, level: float) -> None:
@@ -140,6 +204,67 @@ class Squelch(Module):
     def setReportInterval(self, reportInterval: int) -> None:
         ...
 
+    def setHysteresis(self, hysteresis: float) -> None:
+        ...
+
+    def setHoldTime(self, holdTime: int) -> None:
+        ...
+
+
+class SquelchGate(Module):
+    def __init__(self, flush: int = 5120):
+        ...
+
+    def setOpen(self, open: bool) -> None:
+        ...
+
+    def setFlush(self, flush: int) -> None:
+        ...
+
+
+class BandPowerTap(object):
+    def __init__(self, report_interval: float = 0.25):
+        ...
+
+    def addBand(self, low_cut: float, high_cut: float) -> int:
+        ...
+
+    def setBand(self, id: int, low_cut: float, high_cut: float) -> None:
+        ...
+
+    def removeBand(self, id: int) -> None:
+        ...
+
+    def setWriter(self, id: int, writer: Optional[Writer]) -> None:
+        ...
+
+    def setSquelch(self, id: int, level: float, gate: Optional[SquelchGate] = None, hysteresis: float = 1.0, hold_time: float = 0.0) -> None:
+        ...
+
+
+class OccupancySnapshot(object):
+    """
+    supports the buffer protocol: memoryview(snapshot) is the averaged spectrum (float32, dB) without copying
+    """
+    sequence: int
+    noise_floor: float
+    # (start, end, peak, level) per carrier, in bins
+    carriers: List[Tuple[int, int, int, float]]
+
+
+class OccupancyIndex(Module):
+    def __init__(self, fft_size: int, averaging: float = 0.1, threshold: float = 10.0):
+        ...
+
+    def getSnapshot(self) -> Optional[OccupancySnapshot]:
+        ...
+
+    def setAveraging(self, averaging: float) -> None:
+        ...
+
+    def setThreshold(self, threshold: float) -> None:
+        ...
+
 
 class FractionalDecimator(Module):
     def __init__(self, format: Format, decimation: float, numPolyPoints: int = 12, prefilter: bool = False):
@@ -199,7 +324,7 @@ class RealPart(Module):
 
 
 class AudioResampler(Module):
-    def __init__(self, inputRate: int, outputRate: int):
+    def __init__(self, inputRate: int, outputRate: int, quality: str = "medium"):
         ...
 
 
@@ -219,7 +344,7 @@ class Gain(Module):
 
 
 class TimingRecovery(Module):
-    def __init__(self, decimation: int, loopGain: float, maxError: float, useQ: bool):
+    def __init__(self, decimation: float, loopGain: float, maxError: float, useQ: bool):
         ...
 
 
@@ -231,3 +356,33 @@ class DBPskDecoder(Module):
 class VaricodeDecoder(Module):
     def __init__(self):
         ...
+
+
+class Pll(Module):
+    def __init__(self, bandwidth: float = 0.01, damping: float = 0.707):
+        ...
+
+    def setLoopParameters(self, bandwidth: float, damping: float = 0.707) -> None:
+        ...
+
+    def getFrequency(self) -> float:
+        ...
+
+
+class CostasLoop(Module):
+    def __init__(self, mode: str = "bpsk", bandwidth: float = 0.01, damping: float = 0.707):
+        ...
+
+    def setLoopParameters(self, bandwidth: float, damping: float = 0.707) -> None:
+        ...
+
+    def getFrequency(self) -> float:
+        ...
+
+
+class GoertzelBank(Module):
+    """
+    power at the given frequencies (relative to the sample rate), one frame of len(frequencies) values per block
+    """
+    def __init__(self, frequencies: List[float], blockLength: int):
+        ...
@@ -7,6 +7,8 @@ class Format(Enum):
     FLOAT = 3
     COMPLEX_FLOAT = 4
     COMPLEX_SHORT = 5
+    COMPLEX_CHAR = 6
+    COMPLEX_HALF = 7
 
 
 class AgcProfile(Enum):
@@ -3,7 +3,7 @@
 from setuptools import setup, Extension
 
 
-version = "0.18.2"
+version = "0.19.0"
 
 setup(
     name="pycsdr",
@@ -40,15 +40,21 @@ setup(
                 "src/types.cpp",
                 "src/module.cpp",
                 "src/fft.cpp",
+                "src/polyphasefft.cpp",
                 "src/logpower.cpp",
                 "src/logaveragepower.cpp",
                 "src/fftswap.cpp",
                 "src/fftadpcm.cpp",
+                "src/fftdelta.cpp",
+                "src/waterfallengine.cpp",
+                "src/zoomfft.cpp",
                 "src/firdecimate.cpp",
                 "src/bandpass.cpp",
                 "src/shift.cpp",
                 "src/convert.cpp",
                 "src/squelch.cpp",
+                "src/bandpowertap.cpp",
+                "src/occupancyindex.cpp",
                 "src/fractionaldecimator.cpp",
                 "src/fmdemod.cpp",
                 "src/limit.cpp",
@@ -65,6 +71,9 @@ setup(
                 "src/timingrecovery.cpp",
                 "src/dbpskdecoder.cpp",
                 "src/varicodedecoder.cpp",
+                "src/pll.cpp",
+                "src/costasloop.cpp",
+                "src/goertzelbank.cpp",
             ],
             language="c++",
             include_dirs=["src"],
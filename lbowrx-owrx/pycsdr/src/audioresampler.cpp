@@ -2,18 +2,33 @@
 #include "types.hpp"
 #include <csdr/audioresampler.hpp>
 
+#include <cstring>
+
 static int AudioResampler_init(AudioResampler* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = {(char*) "inputRate", (char*) "outputRate", NULL};
+    static char* kwlist[] = {(char*) "inputRate", (char*) "outputRate", (char*) "quality", NULL};
 
     unsigned int inputRate = 0;
     unsigned int outputRate = 0;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "II", kwlist, &inputRate, &outputRate)) {
+    const char* quality = "medium";
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "II|s", kwlist, &inputRate, &outputRate, &quality)) {
+        return -1;
+    }
+
+    Csdr::ResamplerQuality q;
+    if (strcmp(quality, "low") == 0) {
+        q = Csdr::RESAMPLER_LOW;
+    } else if (strcmp(quality, "medium") == 0) {
+        q = Csdr::RESAMPLER_MEDIUM;
+    } else if (strcmp(quality, "high") == 0) {
+        q = Csdr::RESAMPLER_HIGH;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "unsupported resampler quality");
         return -1;
     }
 
     self->inputFormat = FORMAT_FLOAT;
     self->outputFormat = FORMAT_FLOAT;
-    self->setModule(new Csdr::AudioResampler(inputRate, outputRate));
+    self->setModule(new Csdr::AudioResampler(inputRate, outputRate, q));
 
     return 0;
 }
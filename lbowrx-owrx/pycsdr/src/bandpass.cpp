@@ -6,24 +6,59 @@
 #include <csdr/fftfilter.hpp>
 #include <csdr/window.hpp>
 
-static int Bandpass_init(Bandpass* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = {(char*) "low_cut", (char*) "high_cut", (char*) "transition", (char*) "use_fft", NULL};
+#include <cstring>
 
-    int use_fft = true;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|fffp", kwlist, &self->low_cut, &self->high_cut, &self->transition, &use_fft)) {
-        return -1;
+static Csdr::Filter<Csdr::complex<float>>* createFilter(Bandpass* self) {
+    Csdr::Filter<Csdr::complex<float>>* filter;
+    if (self->design != 0) {
+        // only the transition is used from the design, the cutoff is replaced by the bandwidth of the filter
+        Csdr::MinimumLengthTapGenerator* design;
+        if (self->design == 1) {
+            design = new Csdr::KaiserTapGenerator(0.25f, self->transition, self->ripple, self->attenuation);
+        } else {
+            design = new Csdr::RemezTapGenerator(0.25f, self->transition, self->ripple, self->attenuation);
+        }
+        if (self->use_fft) {
+            filter = new Csdr::FftBandPassFilter(self->low_cut, self->high_cut, design);
+        } else {
+            filter = new Csdr::BandPassFilter<Csdr::complex<float>>(self->low_cut, self->high_cut, design);
+        }
+        delete design;
+        return filter;
     }
-    self->use_fft = use_fft;
 
-    Csdr::Filter<Csdr::complex<float>>* filter;
     auto window = new Csdr::HammingWindow();
     if (self->use_fft) {
         filter = new Csdr::FftBandPassFilter(self->low_cut, self->high_cut, self->transition, window);
     } else {
         filter = new Csdr::BandPassFilter<Csdr::complex<float>>(self->low_cut, self->high_cut, self->transition, window);
     }
-    self->setModule(new Csdr::FilterModule<Csdr::complex<float>>(filter));
     delete window;
+    return filter;
+}
+
+static int Bandpass_init(Bandpass* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "low_cut", (char*) "high_cut", (char*) "transition", (char*) "use_fft", (char*) "design", (char*) "ripple", (char*) "attenuation", NULL};
+
+    int use_fft = true;
+    const char* design = "window";
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|fffpsff", kwlist, &self->low_cut, &self->high_cut, &self->transition, &use_fft, &design, &self->ripple, &self->attenuation)) {
+        return -1;
+    }
+    self->use_fft = use_fft;
+
+    if (strcmp(design, "window") == 0) {
+        self->design = 0;
+    } else if (strcmp(design, "kaiser") == 0) {
+        self->design = 1;
+    } else if (strcmp(design, "remez") == 0) {
+        self->design = 2;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "unsupported filter design");
+        return -1;
+    }
+
+    self->setModule(new Csdr::FilterModule<Csdr::complex<float>>(createFilter(self)));
 
     Py_INCREF(FORMAT_COMPLEX_FLOAT);
     self->inputFormat = FORMAT_COMPLEX_FLOAT;
@@ -39,16 +74,7 @@ static PyObject* Bandpass_setBandpass(Bandpass* self, PyObject* args, PyObject*
         return NULL;
     }
 
-    Csdr::Filter<Csdr::complex<float>>* filter;
-    auto window = new Csdr::HammingWindow();
-    if (self->use_fft) {
-        filter = new Csdr::FftBandPassFilter(self->low_cut, self->high_cut, self->transition, window);
-    } else {
-        filter = new Csdr::BandPassFilter<Csdr::complex<float>>(self->low_cut, self->high_cut, self->transition, window);
-    }
-
-    dynamic_cast<Csdr::FilterModule<Csdr::complex<float>>*>(self->module)->setFilter(filter);
-    delete window;
+    dynamic_cast<Csdr::FilterModule<Csdr::complex<float>>*>(self->module)->setFilter(createFilter(self));
 
     Py_RETURN_NONE;
 }
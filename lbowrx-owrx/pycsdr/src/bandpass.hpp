@@ -11,6 +11,10 @@ struct Bandpass: Module {
     float high_cut = 0.0f;
     float transition = 0.0f;
     bool use_fft = true;
+    // filter design: 0 = windowed sinc, 1 = kaiser, 2 = remez (see Bandpass_init)
+    int design = 0;
+    float ripple = 0.1f;
+    float attenuation = 60.0f;
 };
 
 extern PyType_Spec BandpassSpec;
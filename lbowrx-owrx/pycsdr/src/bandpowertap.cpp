@@ -0,0 +1,250 @@
+#include "bandpowertap.hpp"
+#include "types.hpp"
+#include "pycsdr.hpp"
+
+static int BandPowerTap_init(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "report_interval", NULL};
+
+    float reportInterval = 0.25f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|f", kwlist, &reportInterval)) {
+        return -1;
+    }
+
+    self->writers = PyDict_New();
+    if (self->writers == NULL) return -1;
+    self->gates = PyDict_New();
+    if (self->gates == NULL) return -1;
+
+    self->tap = new Csdr::BandPowerTap(reportInterval);
+
+    return 0;
+}
+
+static int BandPowerTap_finalize(BandPowerTap* self) {
+    delete self->tap;
+    self->tap = nullptr;
+    Py_XDECREF(self->writers);
+    Py_XDECREF(self->gates);
+    return 0;
+}
+
+// stores (or with Py_None: removes) a reference for the band id
+static int BandPowerTap_keepReference(PyObject* dict, unsigned int id, PyObject* object) {
+    PyObject* key = PyLong_FromUnsignedLong(id);
+    if (key == NULL) return -1;
+    int r = 0;
+    if (object == Py_None) {
+        if (PyDict_Contains(dict, key) == 1) r = PyDict_DelItem(dict, key);
+    } else {
+        r = PyDict_SetItem(dict, key, object);
+    }
+    Py_DECREF(key);
+    return r;
+}
+
+static PyObject* BandPowerTap_addBand(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "low_cut", (char*) "high_cut", NULL};
+
+    float lowCut = 0.0f;
+    float highCut = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "ff", kwlist, &lowCut, &highCut)) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(self->tap->addBand(lowCut, highCut));
+}
+
+static PyObject* BandPowerTap_setBand(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "id", (char*) "low_cut", (char*) "high_cut", NULL};
+
+    unsigned int id = 0;
+    float lowCut = 0.0f;
+    float highCut = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Iff", kwlist, &id, &lowCut, &highCut)) {
+        return NULL;
+    }
+
+    self->tap->setBand(id, lowCut, highCut);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* BandPowerTap_removeBand(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "id", NULL};
+
+    unsigned int id = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &id)) {
+        return NULL;
+    }
+
+    // the band must be gone before the references are released
+    self->tap->removeBand(id);
+    if (BandPowerTap_keepReference(self->writers, id, Py_None) == -1) return NULL;
+    if (BandPowerTap_keepReference(self->gates, id, Py_None) == -1) return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* BandPowerTap_setWriter(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "id", (char*) "writer", NULL};
+
+    unsigned int id = 0;
+    PyObject* writer;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "IO", kwlist, &id, &writer)) {
+        return NULL;
+    }
+
+    if (writer != Py_None) {
+        if (!PyObject_TypeCheck(writer, WriterType)) {
+            PyErr_SetString(PyExc_TypeError, "writer must be a Writer");
+            return NULL;
+        }
+        if (((Writer*) writer)->writerFormat != FORMAT_FLOAT) {
+            PyErr_SetString(PyExc_ValueError, "invalid writer format");
+            return NULL;
+        }
+    }
+
+    if (writer == Py_None) {
+        self->tap->setWriter(id, nullptr);
+        if (BandPowerTap_keepReference(self->writers, id, Py_None) == -1) return NULL;
+    } else {
+        if (BandPowerTap_keepReference(self->writers, id, writer) == -1) return NULL;
+        self->tap->setWriter(id, dynamic_cast<Csdr::Writer<float>*>(((Writer*) writer)->writer));
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* BandPowerTap_setSquelch(BandPowerTap* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "id", (char*) "level", (char*) "gate", (char*) "hysteresis", (char*) "hold_time", NULL};
+
+    unsigned int id = 0;
+    float level = 0.0f;
+    PyObject* gate = Py_None;
+    float hysteresis = 1.0f;
+    float holdTime = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "If|Off", kwlist, &id, &level, &gate, &hysteresis, &holdTime)) {
+        return NULL;
+    }
+
+    Csdr::SquelchGate* squelchGate = nullptr;
+    if (gate != Py_None) {
+        if (PyObject_TypeCheck(gate, ModuleType)) {
+            squelchGate = dynamic_cast<Csdr::SquelchGate*>(((Module*) gate)->module);
+        }
+        if (squelchGate == nullptr) {
+            PyErr_SetString(PyExc_TypeError, "gate must be a SquelchGate");
+            return NULL;
+        }
+    }
+
+    if (squelchGate == nullptr) {
+        self->tap->setSquelch(id, level, nullptr);
+        if (BandPowerTap_keepReference(self->gates, id, Py_None) == -1) return NULL;
+    } else {
+        if (BandPowerTap_keepReference(self->gates, id, gate) == -1) return NULL;
+        self->tap->setSquelch(id, level, squelchGate, hysteresis, holdTime);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef BandPowerTap_methods[] = {
+    {"addBand", (PyCFunction) BandPowerTap_addBand, METH_VARARGS | METH_KEYWORDS,
+     "register a band (relative to the FFT sample rate), returns the band id"
+    },
+    {"setBand", (PyCFunction) BandPowerTap_setBand, METH_VARARGS | METH_KEYWORDS,
+     "change the edges of a band"
+    },
+    {"removeBand", (PyCFunction) BandPowerTap_removeBand, METH_VARARGS | METH_KEYWORDS,
+     "unregister a band"
+    },
+    {"setWriter", (PyCFunction) BandPowerTap_setWriter, METH_VARARGS | METH_KEYWORDS,
+     "set a writer that will receive power level readouts for a band"
+    },
+    {"setSquelch", (PyCFunction) BandPowerTap_setSquelch, METH_VARARGS | METH_KEYWORDS,
+     "set squelch level, hysteresis (linear power ratio), hold time (seconds) and the gate it controls for a band"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot BandPowerTapSlots[] = {
+    {Py_tp_init, (void*) BandPowerTap_init},
+    {Py_tp_finalize, (void*) BandPowerTap_finalize},
+    {Py_tp_methods, BandPowerTap_methods},
+    {0, 0}
+};
+
+PyType_Spec BandPowerTapSpec = {
+    "pycsdr.modules.BandPowerTap",
+    sizeof(BandPowerTap),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    BandPowerTapSlots
+};
+
+static int SquelchGate_init(SquelchGate* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "flush", NULL};
+
+    unsigned int flush = 5120;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|I", kwlist, &flush)) {
+        return -1;
+    }
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->outputFormat = FORMAT_COMPLEX_FLOAT;
+    self->setModule(new Csdr::SquelchGate(flush));
+
+    return 0;
+}
+
+static PyObject* SquelchGate_setOpen(SquelchGate* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "open", NULL};
+
+    int open = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "p", kwlist, &open)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::SquelchGate*>(self->module)->setOpen(open);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* SquelchGate_setFlush(SquelchGate* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "flush", NULL};
+
+    unsigned int flush = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &flush)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::SquelchGate*>(self->module)->setFlush(flush);
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef SquelchGate_methods[] = {
+    {"setOpen", (PyCFunction) SquelchGate_setOpen, METH_VARARGS | METH_KEYWORDS,
+     "open or close the gate"
+    },
+    {"setFlush", (PyCFunction) SquelchGate_setFlush, METH_VARARGS | METH_KEYWORDS,
+     "set the number of zero samples produced when the gate closes"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot SquelchGateSlots[] = {
+    {Py_tp_init, (void*) SquelchGate_init},
+    {Py_tp_methods, SquelchGate_methods},
+    {0, 0}
+};
+
+PyType_Spec SquelchGateSpec = {
+    "pycsdr.modules.SquelchGate",
+    sizeof(SquelchGate),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    SquelchGateSlots
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <csdr/bandpowertap.hpp>
+
+#include "module.hpp"
+
+struct BandPowerTap {
+    PyObject_HEAD
+    Csdr::BandPowerTap* tap;
+    // python references to the writers and gates per band id, keeping them alive while the tap uses them
+    PyObject* writers;
+    PyObject* gates;
+};
+
+struct SquelchGate: Module {};
+
+extern PyType_Spec BandPowerTapSpec;
+
+extern PyType_Spec SquelchGateSpec;
@@ -1,4 +1,5 @@
 #include <csdr/ringbuffer.hpp>
+#include <csdr/half.hpp>
 #include <cstring>
 
 #include "pycsdr.hpp"
@@ -33,8 +34,12 @@ static int Buffer_init(Buffer* self, PyObject* args, PyObject* kwds) {
             createBuffer<short>(self, size);
         } else if (self->writerFormat == FORMAT_FLOAT) {
             createBuffer<float>(self, size);
+        } else if (self->writerFormat == FORMAT_COMPLEX_CHAR) {
+            createBuffer<Csdr::complex<unsigned char>>(self, size);
         } else if (self->writerFormat == FORMAT_COMPLEX_SHORT) {
             createBuffer<Csdr::complex<short>>(self, size);
+        } else if (self->writerFormat == FORMAT_COMPLEX_HALF) {
+            createBuffer<Csdr::complex<Csdr::half>>(self, size);
         } else if (self->writerFormat == FORMAT_COMPLEX_FLOAT) {
             createBuffer<Csdr::complex<float>>(self, size);
         } else {
@@ -109,8 +114,12 @@ static PyObject* Buffer_write(Buffer* self, PyObject* args, PyObject* kwds) {
         r = writeToBuffer<short>(self, data, len);
     } else if (self->writerFormat == FORMAT_FLOAT) {
         r = writeToBuffer<float>(self, data, len);
+    } else if (self->writerFormat == FORMAT_COMPLEX_CHAR) {
+        r = writeToBuffer<Csdr::complex<unsigned char>>(self, data, len);
     } else if (self->writerFormat == FORMAT_COMPLEX_SHORT) {
         r = writeToBuffer<Csdr::complex<short>>(self, data, len);
+    } else if (self->writerFormat == FORMAT_COMPLEX_HALF) {
+        r = writeToBuffer<Csdr::complex<Csdr::half>>(self, data, len);
     } else if (self->writerFormat == FORMAT_COMPLEX_FLOAT) {
         r = writeToBuffer<Csdr::complex<float>>(self, data, len);
     } else {
@@ -3,6 +3,7 @@
 #include "pycsdr.hpp"
 
 #include <csdr/ringbuffer.hpp>
+#include <csdr/half.hpp>
 
 template <typename T>
 static Csdr::UntypedReader* createReader(BufferReader* self) {
@@ -27,8 +28,12 @@ static int BufferReader_init(BufferReader* self, PyObject* args, PyObject* kwds)
         self->reader = createReader<short>(self);
     } else if (self->readerFormat == FORMAT_FLOAT) {
         self->reader = createReader<float>(self);
+    } else if (self->readerFormat == FORMAT_COMPLEX_CHAR) {
+        self->reader = createReader<Csdr::complex<unsigned char>>(self);
     } else if (self->readerFormat == FORMAT_COMPLEX_SHORT) {
         self->reader = createReader<Csdr::complex<short>>(self);
+    } else if (self->readerFormat == FORMAT_COMPLEX_HALF) {
+        self->reader = createReader<Csdr::complex<Csdr::half>>(self);
     } else if (self->readerFormat == FORMAT_COMPLEX_FLOAT) {
         self->reader = createReader<Csdr::complex<float>>(self);
     } else {
@@ -81,8 +86,12 @@ static PyObject* BufferReader_read(BufferReader* self) {
             return getBytes<short>(self->reader);
         } else if (self->readerFormat == FORMAT_FLOAT) {
             return getBytes<float>(self->reader);
+        } else if (self->readerFormat == FORMAT_COMPLEX_CHAR) {
+            return getBytes<Csdr::complex<unsigned char>>(self->reader);
         } else if (self->readerFormat == FORMAT_COMPLEX_SHORT) {
             return getBytes<Csdr::complex<short>>(self->reader);
+        } else if (self->readerFormat == FORMAT_COMPLEX_HALF) {
+            return getBytes<Csdr::complex<Csdr::half>>(self->reader);
         } else if (self->readerFormat == FORMAT_COMPLEX_FLOAT) {
             return getBytes<Csdr::complex<float>>(self->reader);
         } else {
@@ -2,6 +2,7 @@
 #include "types.hpp"
 
 #include <csdr/converter.hpp>
+#include <csdr/half.hpp>
 
 static int Convert_init(Convert* self, PyObject* args, PyObject* kwds) {
     static char* kwlist[] = {(char*) "inFormat", (char*) "outFormat", NULL};
@@ -11,34 +12,77 @@ static int Convert_init(Convert* self, PyObject* args, PyObject* kwds) {
     }
 
     // this matrix should be extended in sync with what's available in csdr
-    if (self->inputFormat == FORMAT_FLOAT) {
+    if (self->inputFormat == FORMAT_CHAR) {
         if (self->outputFormat == FORMAT_SHORT) {
-            self->setModule(new Csdr::Converter<float, short>());
+            self->setModule(new Csdr::Converter<unsigned char, short>());
+        } else if (self->outputFormat == FORMAT_FLOAT) {
+            self->setModule(new Csdr::Converter<unsigned char, float>());
         } else {
             PyErr_SetString(PyExc_ValueError, "unsupported conversion");
             return -1;
         }
     } else if (self->inputFormat == FORMAT_SHORT) {
-        if (self->outputFormat == FORMAT_FLOAT) {
+        if (self->outputFormat == FORMAT_CHAR) {
+            self->setModule(new Csdr::Converter<short, unsigned char>());
+        } else if (self->outputFormat == FORMAT_FLOAT) {
             self->setModule(new Csdr::Converter<short, float>());
         } else {
             PyErr_SetString(PyExc_ValueError, "unsupported conversion");
             return -1;
         }
-    } else if (self->inputFormat == FORMAT_COMPLEX_FLOAT) {
+    } else if (self->inputFormat == FORMAT_FLOAT) {
+        if (self->outputFormat == FORMAT_CHAR) {
+            self->setModule(new Csdr::Converter<float, unsigned char>());
+        } else if (self->outputFormat == FORMAT_SHORT) {
+            self->setModule(new Csdr::Converter<float, short>());
+        } else {
+            PyErr_SetString(PyExc_ValueError, "unsupported conversion");
+            return -1;
+        }
+    } else if (self->inputFormat == FORMAT_COMPLEX_CHAR) {
         if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
-            self->setModule(new Csdr::Converter<Csdr::complex<float>, Csdr::complex<short>>());
+            self->setModule(new Csdr::Converter<Csdr::complex<unsigned char>, Csdr::complex<short>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+            self->setModule(new Csdr::Converter<Csdr::complex<unsigned char>, Csdr::complex<Csdr::half>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
+            self->setModule(new Csdr::Converter<Csdr::complex<unsigned char>, Csdr::complex<float>>());
         } else {
             PyErr_SetString(PyExc_ValueError, "unsupported conversion");
             return -1;
         }
     } else if (self->inputFormat == FORMAT_COMPLEX_SHORT) {
-        if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
+        if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+            self->setModule(new Csdr::Converter<Csdr::complex<short>, Csdr::complex<unsigned char>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+            self->setModule(new Csdr::Converter<Csdr::complex<short>, Csdr::complex<Csdr::half>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
             self->setModule(new Csdr::Converter<Csdr::complex<short>, Csdr::complex<float>>());
         } else {
             PyErr_SetString(PyExc_ValueError, "unsupported conversion");
             return -1;
         }
+    } else if (self->inputFormat == FORMAT_COMPLEX_HALF) {
+        if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+            self->setModule(new Csdr::Converter<Csdr::complex<Csdr::half>, Csdr::complex<unsigned char>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
+            self->setModule(new Csdr::Converter<Csdr::complex<Csdr::half>, Csdr::complex<short>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
+            self->setModule(new Csdr::Converter<Csdr::complex<Csdr::half>, Csdr::complex<float>>());
+        } else {
+            PyErr_SetString(PyExc_ValueError, "unsupported conversion");
+            return -1;
+        }
+    } else if (self->inputFormat == FORMAT_COMPLEX_FLOAT) {
+        if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+            self->setModule(new Csdr::Converter<Csdr::complex<float>, Csdr::complex<unsigned char>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
+            self->setModule(new Csdr::Converter<Csdr::complex<float>, Csdr::complex<short>>());
+        } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+            self->setModule(new Csdr::Converter<Csdr::complex<float>, Csdr::complex<Csdr::half>>());
+        } else {
+            PyErr_SetString(PyExc_ValueError, "unsupported conversion");
+            return -1;
+        }
     } else {
         PyErr_SetString(PyExc_ValueError, "unsupported conversion");
         return -1;
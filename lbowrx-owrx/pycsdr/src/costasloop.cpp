@@ -0,0 +1,75 @@
+#include "costasloop.hpp"
+#include "types.hpp"
+
+#include <csdr/carrierrecovery.hpp>
+
+#include <cstring>
+
+static int CostasLoop_init(CostasLoop* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "mode", (char*) "bandwidth", (char*) "damping", NULL};
+
+    const char* mode = "bpsk";
+    float bandwidth = 0.01f;
+    float damping = 0.707f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sff", kwlist, &mode, &bandwidth, &damping)) {
+        return -1;
+    }
+
+    Csdr::CostasMode costasMode;
+    if (strcmp(mode, "bpsk") == 0) {
+        costasMode = Csdr::COSTAS_BPSK;
+    } else if (strcmp(mode, "qpsk") == 0) {
+        costasMode = Csdr::COSTAS_QPSK;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "unsupported costas loop mode");
+        return -1;
+    }
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->outputFormat = FORMAT_COMPLEX_FLOAT;
+    self->setModule(new Csdr::CostasLoop(costasMode, bandwidth, damping));
+
+    return 0;
+}
+
+static PyObject* CostasLoop_setLoopParameters(CostasLoop* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "bandwidth", (char*) "damping", NULL};
+
+    float bandwidth = 0.01f;
+    float damping = 0.707f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f|f", kwlist, &bandwidth, &damping)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::CarrierRecovery*>(self->module)->setLoopParameters(bandwidth, damping);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* CostasLoop_getFrequency(CostasLoop* self) {
+    return PyFloat_FromDouble(dynamic_cast<Csdr::CarrierRecovery*>(self->module)->getFrequency());
+}
+
+static PyMethodDef CostasLoop_methods[] = {
+    {"setLoopParameters", (PyCFunction) CostasLoop_setLoopParameters, METH_VARARGS | METH_KEYWORDS,
+     "set loop bandwidth (relative to the sample rate) and damping"
+    },
+    {"getFrequency", (PyCFunction) CostasLoop_getFrequency, METH_NOARGS,
+     "get the current frequency offset (relative to the sample rate)"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot CostasLoopSlots[] = {
+    {Py_tp_init, (void*) CostasLoop_init},
+    {Py_tp_methods, CostasLoop_methods},
+    {0, 0}
+};
+
+PyType_Spec CostasLoopSpec = {
+    "pycsdr.modules.CostasLoop",
+    sizeof(CostasLoop),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    CostasLoopSlots
+};
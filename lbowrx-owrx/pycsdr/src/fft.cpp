@@ -1,24 +1,39 @@
 #include "fft.hpp"
 #include "types.hpp"
+#include "pycsdr.hpp"
+#include "bandpowertap.hpp"
 
 #include <csdr/fft.hpp>
 #include <csdr/window.hpp>
+#include <csdr/half.hpp>
 
 static int Fft_init(Fft* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = {(char*) "size", (char*) "every_n_samples", NULL};
+    static char* kwlist[] = {(char*) "size", (char*) "every_n_samples", (char*) "threads", (char*) "format", NULL};
 
     uint32_t fftSize = 0;
     uint16_t everyNSamples = 0;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "IH", kwlist, &fftSize, &everyNSamples)) {
+    unsigned int threads = 1;
+    PyObject* format = FORMAT_COMPLEX_FLOAT;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "IH|IO!", kwlist, &fftSize, &everyNSamples, &threads, FORMAT_TYPE, &format)) {
         return -1;
     }
 
     // TODO make window available as an argument
     auto window = new Csdr::HammingWindow();
-    self->setModule(new Csdr::Fft(fftSize, everyNSamples, window));
+    if (format == FORMAT_COMPLEX_FLOAT) {
+        self->setModule(new Csdr::Fft<Csdr::complex<float>>(fftSize, everyNSamples, window, threads));
+    } else if (format == FORMAT_COMPLEX_SHORT) {
+        self->setModule(new Csdr::Fft<Csdr::complex<short>>(fftSize, everyNSamples, window, threads));
+    } else if (format == FORMAT_COMPLEX_HALF) {
+        self->setModule(new Csdr::Fft<Csdr::complex<Csdr::half>>(fftSize, everyNSamples, window, threads));
+    } else {
+        delete window;
+        PyErr_SetString(PyExc_ValueError, "unsupported fft format");
+        return -1;
+    }
     delete window;
 
-    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->inputFormat = format;
     self->outputFormat = FORMAT_COMPLEX_FLOAT;
 
     return 0;
@@ -32,20 +47,76 @@ static PyObject* Fft_setEveryNSamples(Fft* self, PyObject* args, PyObject* kwds)
         return NULL;
     }
 
-    dynamic_cast<Csdr::Fft*>(self->module)->setEveryNSamples(everyNSamples);
+    dynamic_cast<Csdr::UntypedFft*>(self->module)->setEveryNSamples(everyNSamples);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* Fft_setThreads(Fft* self, PyObject* args, PyObject* kwds){
+    static char* kwlist[] = {(char*) "threads", NULL};
+
+    unsigned int threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &threads)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedFft*>(self->module)->setThreads(threads);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* Fft_setPowerTap(Fft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "tap", NULL};
+
+    PyObject* tap;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &tap)) {
+        return NULL;
+    }
+
+    if (tap != Py_None && !PyObject_TypeCheck(tap, BandPowerTapType)) {
+        PyErr_SetString(PyExc_TypeError, "tap must be a BandPowerTap");
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedFft*>(self->module)->setPowerTap(tap == Py_None ? nullptr : ((BandPowerTap*) tap)->tap);
+
+    // the tap must outlive the module, so a reference is held
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    if (tap != Py_None) {
+        self->powerTap = tap;
+        Py_INCREF(self->powerTap);
+    }
 
     Py_RETURN_NONE;
 }
 
+// the tap may only be released once the module no longer uses it
+static int Fft_finalize(Fft* self) {
+    if (Module_finalize(self) != 0) {
+        return -1;
+    }
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    return 0;
+}
+
 static PyMethodDef Fft_methods[] = {
     {"setEveryNSamples", (PyCFunction) Fft_setEveryNSamples, METH_VARARGS | METH_KEYWORDS,
      "set repetition interval in samples"
     },
+    {"setThreads", (PyCFunction) Fft_setThreads, METH_VARARGS | METH_KEYWORDS,
+     "set number of threads per FFT"
+    },
+    {"setPowerTap", (PyCFunction) Fft_setPowerTap, METH_VARARGS | METH_KEYWORDS,
+     "hand every frame to a BandPowerTap for channel power measurement"
+    },
     {NULL}  /* Sentinel */
 };
 
 static PyType_Slot FftSlots[] = {
     {Py_tp_init, (void*) Fft_init},
+    {Py_tp_finalize, (void*) Fft_finalize},
     {Py_tp_methods, Fft_methods},
     {0, 0}
 };
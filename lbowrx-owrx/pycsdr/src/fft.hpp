@@ -6,6 +6,8 @@
 
 #include "module.hpp"
 
-struct Fft: Module {};
+struct Fft: Module {
+    PyObject* powerTap;
+};
 
 extern PyType_Spec FftSpec;
@@ -0,0 +1,36 @@
+#include "fftdelta.hpp"
+#include "types.hpp"
+
+#include <csdr/fftdelta.hpp>
+
+static int FftDelta_init(FftDelta* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "fft_size", (char*) "floor", (char*) "range", (char*) "keyframe_interval", NULL};
+
+    uint32_t fftSize = 0;
+    int floor = -140;
+    uint32_t range = 120;
+    uint32_t keyframeInterval = 16;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|iII", kwlist, &fftSize, &floor, &range, &keyframeInterval)) {
+        return -1;
+    }
+
+    self->inputFormat = FORMAT_FLOAT;
+    self->outputFormat = FORMAT_CHAR;
+
+    self->setModule(new Csdr::FftDeltaEncoder(fftSize, floor, range, keyframeInterval));
+
+    return 0;
+}
+
+static PyType_Slot FftDeltaSlots[] = {
+    {Py_tp_init, (void*) FftDelta_init},
+    {0, 0}
+};
+
+PyType_Spec FftDeltaSpec = {
+    "pycsdr.modules.FftDelta",
+    sizeof(FftDelta),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    FftDeltaSlots
+};
@@ -3,6 +3,9 @@
 
 #include <csdr/firdecimate.hpp>
 #include <csdr/window.hpp>
+#include <csdr/half.hpp>
+
+#include <cstring>
 
 static int FirDecimate_init(FirDecimate* self, PyObject* args, PyObject* kwds) {
 
@@ -10,18 +13,55 @@ static int FirDecimate_init(FirDecimate* self, PyObject* args, PyObject* kwds) {
     unsigned int decimation = 0;
     float cutoff = 0.5f;
 
+    PyObject* format = FORMAT_COMPLEX_FLOAT;
+    const char* design = "window";
+    float ripple = 0.1f;
+    float attenuation = 60.0f;
+
     // TODO restore window argument
-    static char* kwlist[] = {(char*) "decimation", (char*) "transition", (char*) "cutoff", NULL};
+    static char* kwlist[] = {(char*) "decimation", (char*) "transition", (char*) "cutoff", (char*) "format", (char*) "design", (char*) "ripple", (char*) "attenuation", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "H|ffO!sff", kwlist, &decimation, &transition, &cutoff, FORMAT_TYPE, &format, &design, &ripple, &attenuation)) {
+        return -1;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "H|ff", kwlist, &decimation, &transition, &cutoff)) {
+    if (format != FORMAT_COMPLEX_FLOAT && format != FORMAT_COMPLEX_SHORT && format != FORMAT_COMPLEX_HALF) {
+        PyErr_SetString(PyExc_ValueError, "unsupported decimation format");
         return -1;
     }
 
-    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    Csdr::MinimumLengthTapGenerator* generator = nullptr;
+    if (strcmp(design, "kaiser") == 0) {
+        generator = new Csdr::KaiserTapGenerator(cutoff / decimation, transition, ripple, attenuation);
+    } else if (strcmp(design, "remez") == 0) {
+        generator = new Csdr::RemezTapGenerator(cutoff / decimation, transition, ripple, attenuation);
+    } else if (strcmp(design, "window") != 0) {
+        PyErr_SetString(PyExc_ValueError, "unsupported filter design");
+        return -1;
+    }
+
+    if (generator != nullptr) {
+        if (format == FORMAT_COMPLEX_FLOAT) {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<float>>(decimation, generator));
+        } else if (format == FORMAT_COMPLEX_SHORT) {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<short>>(decimation, generator));
+        } else {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<Csdr::half>>(decimation, generator));
+        }
+        delete generator;
+    } else {
+        auto window = new Csdr::HammingWindow();
+        if (format == FORMAT_COMPLEX_FLOAT) {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<float>>(decimation, transition, window, cutoff));
+        } else if (format == FORMAT_COMPLEX_SHORT) {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<short>>(decimation, transition, window, cutoff));
+        } else {
+            self->setModule(new Csdr::FirDecimate<Csdr::complex<Csdr::half>>(decimation, transition, window, cutoff));
+        }
+        delete window;
+    }
+    self->inputFormat = format;
     self->outputFormat = FORMAT_COMPLEX_FLOAT;
-    auto window = new Csdr::HammingWindow();
-    self->setModule(new Csdr::FirDecimate(decimation, transition, window, cutoff));
-    delete window;
 
     return 0;
 }
@@ -2,17 +2,12 @@
 #include "types.hpp"
 
 #include <csdr/fractionaldecimator.hpp>
-#include <csdr/window.hpp>
 
 template <typename T>
 static void setupDecimator(FractionalDecimator* self, float decimation, unsigned int numPolyPoints, bool prefilter) {
-    Csdr::LowPassFilter<T>* filter = nullptr;
-    if (prefilter) {
-        auto w = new Csdr::HammingWindow();
-        float transition = 0.03f;
-        filter = new Csdr::LowPassFilter<T>(0.5 / (decimation - transition), transition, w);
-    }
-    self->setModule(new Csdr::FractionalDecimator<T>(decimation, numPolyPoints, filter));
+    // with prefilter, the interpolation kernel also suppresses aliasing (hamming window, default transition)
+    float transition = prefilter ? 0.03f : 0.0f;
+    self->setModule(new Csdr::FractionalDecimator<T>(decimation, numPolyPoints, transition));
 }
 
 static int FractionalDecimator_init(FractionalDecimator* self, PyObject* args, PyObject* kwds) {
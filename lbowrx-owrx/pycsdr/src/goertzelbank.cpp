@@ -0,0 +1,55 @@
+#include "goertzelbank.hpp"
+#include "types.hpp"
+
+#include <csdr/goertzel.hpp>
+
+#include <stdexcept>
+
+static int GoertzelBank_init(GoertzelBank* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "frequencies", (char*) "blockLength", NULL};
+
+    PyObject* frequencies;
+    unsigned int blockLength = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OI", kwlist, &frequencies, &blockLength)) {
+        return -1;
+    }
+
+    PyObject* sequence = PySequence_Fast(frequencies, "frequencies must be a sequence");
+    if (sequence == NULL) {
+        return -1;
+    }
+    std::vector<float> tones;
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(sequence); i++) {
+        double frequency = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(sequence, i));
+        if (PyErr_Occurred()) {
+            Py_DECREF(sequence);
+            return -1;
+        }
+        tones.push_back((float) frequency);
+    }
+    Py_DECREF(sequence);
+
+    try {
+        self->setModule(new Csdr::GoertzelBank(tones, blockLength));
+    } catch (const std::runtime_error& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return -1;
+    }
+    self->inputFormat = FORMAT_FLOAT;
+    self->outputFormat = FORMAT_FLOAT;
+
+    return 0;
+}
+
+static PyType_Slot GoertzelBankSlots[] = {
+    {Py_tp_init, (void*) GoertzelBank_init},
+    {0, 0}
+};
+
+PyType_Spec GoertzelBankSpec = {
+    "pycsdr.modules.GoertzelBank",
+    sizeof(GoertzelBank),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    GoertzelBankSlots
+};
@@ -55,7 +55,7 @@ static PyObject* Module_stop(Module* self) {
     Py_RETURN_NONE;
 }
 
-static int Module_finalize(Module* self) {
+int Module_finalize(Module* self) {
     stopRunner(self);
 
     auto old = self->module;
@@ -22,4 +22,7 @@ struct Module: Sink, Source {
     }
 };
 
+// stops processing and deletes the module. subtypes that hold additional references release them afterwards.
+int Module_finalize(Module* self);
+
 extern PyType_Spec ModuleSpec;
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "occupancyindex.hpp"
+#include "types.hpp"
+#include "pycsdr.hpp"
+
+static int OccupancyIndex_init(OccupancyIndex* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "fft_size", (char*) "averaging", (char*) "threshold", NULL};
+
+    unsigned int fftSize = 0;
+    float averaging = 0.1f;
+    float threshold = 10.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|ff", kwlist, &fftSize, &averaging, &threshold)) {
+        return -1;
+    }
+
+    self->inputFormat = FORMAT_FLOAT;
+    self->outputFormat = FORMAT_FLOAT;
+    self->setModule(new Csdr::OccupancyIndex(fftSize, averaging, threshold));
+
+    return 0;
+}
+
+static PyObject* OccupancyIndex_getSnapshot(OccupancyIndex* self) {
+    auto index = dynamic_cast<Csdr::OccupancyIndex*>(self->module);
+    const Csdr::OccupancySnapshot* snapshot = index->acquire();
+    if (snapshot == nullptr) {
+        Py_RETURN_NONE;
+    }
+
+    auto result = (OccupancySnapshot*) PyType_GenericNew(OccupancySnapshotType, NULL, NULL);
+    if (result == NULL) {
+        index->release(snapshot);
+        return NULL;
+    }
+    result->snapshot = snapshot;
+    result->length = (Py_ssize_t) snapshot->spectrum.size();
+    result->index = self;
+    Py_INCREF(self);
+
+    return (PyObject*) result;
+}
+
+static PyObject* OccupancyIndex_setAveraging(OccupancyIndex* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "averaging", NULL};
+
+    float averaging = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f", kwlist, &averaging)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::OccupancyIndex*>(self->module)->setAveraging(averaging);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* OccupancyIndex_setThreshold(OccupancyIndex* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "threshold", NULL};
+
+    float threshold = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f", kwlist, &threshold)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::OccupancyIndex*>(self->module)->setThreshold(threshold);
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef OccupancyIndex_methods[] = {
+    {"getSnapshot", (PyCFunction) OccupancyIndex_getSnapshot, METH_NOARGS,
+     "get the current snapshot, or None if no data has been processed yet"
+    },
+    {"setAveraging", (PyCFunction) OccupancyIndex_setAveraging, METH_VARARGS | METH_KEYWORDS,
+     "set the weight of a new line in the exponential average"
+    },
+    {"setThreshold", (PyCFunction) OccupancyIndex_setThreshold, METH_VARARGS | METH_KEYWORDS,
+     "set the carrier detection threshold in dB above the noise floor"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot OccupancyIndexSlots[] = {
+    {Py_tp_init, (void*) OccupancyIndex_init},
+    {Py_tp_methods, OccupancyIndex_methods},
+    {0, 0}
+};
+
+PyType_Spec OccupancyIndexSpec = {
+    "pycsdr.modules.OccupancyIndex",
+    sizeof(OccupancyIndex),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    OccupancyIndexSlots
+};
+
+static int OccupancySnapshot_finalize(OccupancySnapshot* self) {
+    if (self->index != nullptr) {
+        dynamic_cast<Csdr::OccupancyIndex*>(self->index->module)->release(self->snapshot);
+        Py_DECREF(self->index);
+        self->index = nullptr;
+    }
+    return 0;
+}
+
+// exposes the averaged spectrum as float32 without copying
+static int OccupancySnapshot_getbuffer(OccupancySnapshot* self, Py_buffer* view, int flags) {
+    if (self->snapshot == nullptr) {
+        PyErr_SetString(PyExc_BufferError, "invalid snapshot");
+        view->obj = NULL;
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject*) self, (void*) self->snapshot->spectrum.data(), sizeof(float) * self->length, 1, flags) == -1) {
+        return -1;
+    }
+    if (flags & PyBUF_FORMAT) {
+        view->format = (char*) "f";
+    }
+    view->itemsize = sizeof(float);
+    if (flags & PyBUF_ND) {
+        view->ndim = 1;
+        view->shape = &self->length;
+    }
+    return 0;
+}
+
+// snapshots can only be obtained from OccupancyIndex.getSnapshot(), but python could still instantiate the type
+static bool OccupancySnapshot_check(OccupancySnapshot* self) {
+    if (self->snapshot == nullptr) {
+        PyErr_SetString(PyExc_ValueError, "invalid snapshot");
+        return false;
+    }
+    return true;
+}
+
+static PyObject* OccupancySnapshot_getSequence(OccupancySnapshot* self, void* closure) {
+    if (!OccupancySnapshot_check(self)) return NULL;
+    return PyLong_FromUnsignedLongLong(self->snapshot->sequence);
+}
+
+static PyObject* OccupancySnapshot_getNoiseFloor(OccupancySnapshot* self, void* closure) {
+    if (!OccupancySnapshot_check(self)) return NULL;
+    return PyFloat_FromDouble(self->snapshot->noiseFloor);
+}
+
+static PyObject* OccupancySnapshot_getCarriers(OccupancySnapshot* self, void* closure) {
+    if (!OccupancySnapshot_check(self)) return NULL;
+    auto& carriers = self->snapshot->carriers;
+    PyObject* list = PyList_New(carriers.size());
+    if (list == NULL) return NULL;
+    for (size_t i = 0; i < carriers.size(); i++) {
+        auto& carrier = carriers[i];
+        PyObject* item = Py_BuildValue("(IIIf)", carrier.start, carrier.end, carrier.peak, carrier.level);
+        if (item == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+static PyGetSetDef OccupancySnapshot_getset[] = {
+    {"sequence", (getter) OccupancySnapshot_getSequence, NULL, "number of lines processed", NULL},
+    {"noise_floor", (getter) OccupancySnapshot_getNoiseFloor, NULL, "noise floor estimate (dB)", NULL},
+    {"carriers", (getter) OccupancySnapshot_getCarriers, NULL, "detected carriers as (start, end, peak, level) tuples", NULL},
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot OccupancySnapshotSlots[] = {
+    {Py_tp_finalize, (void*) OccupancySnapshot_finalize},
+    {Py_tp_getset, OccupancySnapshot_getset},
+    {Py_bf_getbuffer, (void*) OccupancySnapshot_getbuffer},
+    {0, 0}
+};
+
+PyType_Spec OccupancySnapshotSpec = {
+    "pycsdr.modules.OccupancySnapshot",
+    sizeof(OccupancySnapshot),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    OccupancySnapshotSlots
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <csdr/occupancyindex.hpp>
+
+#include "module.hpp"
+
+struct OccupancyIndex: Module {};
+
+// a snapshot holds on to its slot (and the index) until it is garbage collected
+struct OccupancySnapshot {
+    PyObject_HEAD
+    OccupancyIndex* index;
+    const Csdr::OccupancySnapshot* snapshot;
+    Py_ssize_t length;
+};
+
+extern PyType_Spec OccupancyIndexSpec;
+
+extern PyType_Spec OccupancySnapshotSpec;
@@ -0,0 +1,62 @@
+#include "pll.hpp"
+#include "types.hpp"
+
+#include <csdr/carrierrecovery.hpp>
+
+static int Pll_init(Pll* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "bandwidth", (char*) "damping", NULL};
+
+    float bandwidth = 0.01f;
+    float damping = 0.707f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ff", kwlist, &bandwidth, &damping)) {
+        return -1;
+    }
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->outputFormat = FORMAT_COMPLEX_FLOAT;
+    self->setModule(new Csdr::Pll(bandwidth, damping));
+
+    return 0;
+}
+
+static PyObject* Pll_setLoopParameters(Pll* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "bandwidth", (char*) "damping", NULL};
+
+    float bandwidth = 0.01f;
+    float damping = 0.707f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f|f", kwlist, &bandwidth, &damping)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::CarrierRecovery*>(self->module)->setLoopParameters(bandwidth, damping);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* Pll_getFrequency(Pll* self) {
+    return PyFloat_FromDouble(dynamic_cast<Csdr::CarrierRecovery*>(self->module)->getFrequency());
+}
+
+static PyMethodDef Pll_methods[] = {
+    {"setLoopParameters", (PyCFunction) Pll_setLoopParameters, METH_VARARGS | METH_KEYWORDS,
+     "set loop bandwidth (relative to the sample rate) and damping"
+    },
+    {"getFrequency", (PyCFunction) Pll_getFrequency, METH_NOARGS,
+     "get the current frequency offset (relative to the sample rate)"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot PllSlots[] = {
+    {Py_tp_init, (void*) Pll_init},
+    {Py_tp_methods, Pll_methods},
+    {0, 0}
+};
+
+PyType_Spec PllSpec = {
+    "pycsdr.modules.Pll",
+    sizeof(Pll),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    PllSlots
+};
@@ -0,0 +1,125 @@
+#include "polyphasefft.hpp"
+#include "types.hpp"
+#include "pycsdr.hpp"
+#include "bandpowertap.hpp"
+
+#include <csdr/polyphasefft.hpp>
+#include <csdr/window.hpp>
+
+static int PolyphaseFft_init(PolyphaseFft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "size", (char*) "taps", (char*) "every_n_samples", (char*) "threads", NULL};
+
+    uint32_t fftSize = 0;
+    uint32_t taps = 0;
+    uint32_t everyNSamples = 0;
+    unsigned int threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "III|I", kwlist, &fftSize, &taps, &everyNSamples, &threads)) {
+        return -1;
+    }
+
+    // the prototype filter needs the stopband of the blackman window to make use of the additional taps
+    auto window = new Csdr::BlackmanWindow();
+    try {
+        self->setModule(new Csdr::PolyphaseFft(fftSize, taps, everyNSamples, window, threads));
+    } catch (const std::runtime_error& e) {
+        delete window;
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return -1;
+    }
+    delete window;
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->outputFormat = FORMAT_COMPLEX_FLOAT;
+
+    return 0;
+}
+
+static PyObject* PolyphaseFft_setEveryNSamples(PolyphaseFft* self, PyObject* args, PyObject* kwds){
+    static char* kwlist[] = {(char*) "every_n_samples", NULL};
+
+    unsigned int everyNSamples = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &everyNSamples)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::PolyphaseFft*>(self->module)->setEveryNSamples(everyNSamples);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PolyphaseFft_setThreads(PolyphaseFft* self, PyObject* args, PyObject* kwds){
+    static char* kwlist[] = {(char*) "threads", NULL};
+
+    unsigned int threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &threads)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::PolyphaseFft*>(self->module)->setThreads(threads);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PolyphaseFft_setPowerTap(PolyphaseFft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "tap", NULL};
+
+    PyObject* tap;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &tap)) {
+        return NULL;
+    }
+
+    if (tap != Py_None && !PyObject_TypeCheck(tap, BandPowerTapType)) {
+        PyErr_SetString(PyExc_TypeError, "tap must be a BandPowerTap");
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::PolyphaseFft*>(self->module)->setPowerTap(tap == Py_None ? nullptr : ((BandPowerTap*) tap)->tap);
+
+    // the tap must outlive the module, so a reference is held
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    if (tap != Py_None) {
+        self->powerTap = tap;
+        Py_INCREF(self->powerTap);
+    }
+
+    Py_RETURN_NONE;
+}
+
+// the tap may only be released once the module no longer uses it
+static int PolyphaseFft_finalize(PolyphaseFft* self) {
+    if (Module_finalize(self) != 0) {
+        return -1;
+    }
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    return 0;
+}
+
+static PyMethodDef PolyphaseFft_methods[] = {
+    {"setEveryNSamples", (PyCFunction) PolyphaseFft_setEveryNSamples, METH_VARARGS | METH_KEYWORDS,
+     "set repetition interval in samples"
+    },
+    {"setThreads", (PyCFunction) PolyphaseFft_setThreads, METH_VARARGS | METH_KEYWORDS,
+     "set number of threads per FFT"
+    },
+    {"setPowerTap", (PyCFunction) PolyphaseFft_setPowerTap, METH_VARARGS | METH_KEYWORDS,
+     "hand every frame to a BandPowerTap for channel power measurement"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot PolyphaseFftSlots[] = {
+    {Py_tp_init, (void*) PolyphaseFft_init},
+    {Py_tp_finalize, (void*) PolyphaseFft_finalize},
+    {Py_tp_methods, PolyphaseFft_methods},
+    {0, 0}
+};
+
+PyType_Spec PolyphaseFftSpec = {
+    "pycsdr.modules.PolyphaseFft",
+    sizeof(PolyphaseFft),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    PolyphaseFftSlots
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "module.hpp"
+
+struct PolyphaseFft: Module {
+    PyObject* powerTap;
+};
+
+extern PyType_Spec PolyphaseFftSpec;
@@ -2,14 +2,20 @@
 #include "buffer.hpp"
 #include "tcpsource.hpp"
 #include "fft.hpp"
+#include "polyphasefft.hpp"
 #include "logpower.hpp"
 #include "logaveragepower.hpp"
 #include "fftswap.hpp"
 #include "fftadpcm.hpp"
+#include "fftdelta.hpp"
+#include "waterfallengine.hpp"
+#include "zoomfft.hpp"
 #include "firdecimate.hpp"
 #include "bandpass.hpp"
 #include "shift.hpp"
 #include "squelch.hpp"
+#include "bandpowertap.hpp"
+#include "occupancyindex.hpp"
 #include "fractionaldecimator.hpp"
 #include "fmdemod.hpp"
 #include "limit.hpp"
@@ -33,14 +39,30 @@
 #include "timingrecovery.hpp"
 #include "dbpskdecoder.hpp"
 #include "varicodedecoder.hpp"
+#include "pll.hpp"
+#include "costasloop.hpp"
+#include "goertzelbank.hpp"
 
 #include <csdr/version.hpp>
+#include <csdr/tapcache.hpp>
+
+static PyObject* pycsdr_getTapCacheUsage(PyObject* self, PyObject* args) {
+    return Py_BuildValue("(nn)", (Py_ssize_t) Csdr::TapCache::getEntries(), (Py_ssize_t) Csdr::TapCache::getMemoryUsage());
+}
+
+static PyMethodDef pycsdr_methods[] = {
+    {"getTapCacheUsage", (PyCFunction) pycsdr_getTapCacheUsage, METH_NOARGS,
+     "get the number of filter taps and windows shared between modules, and the memory they use (in bytes)"
+    },
+    {NULL}  /* Sentinel */
+};
 
 static PyModuleDef pycsdrmodule = {
         PyModuleDef_HEAD_INIT,
         .m_name = "pycsdr.modules",
         .m_doc = "Python bindings for the csdr library",
         .m_size = -1,
+        .m_methods = pycsdr_methods,
 };
 
 PyTypeObject* WriterType;
@@ -57,6 +79,10 @@ PyTypeObject* BufferType;
 
 PyTypeObject* BufferReaderType;
 
+PyTypeObject* BandPowerTapType;
+
+PyTypeObject* OccupancySnapshotType;
+
 PyMODINIT_FUNC
 PyInit_modules(void) {
     WriterType = (PyTypeObject*) PyType_FromSpec(&WriterSpec);
@@ -104,6 +130,12 @@ PyInit_modules(void) {
     PyObject* FftType = PyType_FromSpecWithBases(&FftSpec, bases);
     if (FftType == NULL) return NULL;
 
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* PolyphaseFftType = PyType_FromSpecWithBases(&PolyphaseFftSpec, bases);
+    if (PolyphaseFftType == NULL) return NULL;
+
     Py_INCREF(ModuleType);
     bases = PyTuple_Pack(1, ModuleType);
     if (bases == NULL) return NULL;
@@ -128,6 +160,24 @@ PyInit_modules(void) {
     PyObject* FftAdpcmType = PyType_FromSpecWithBases(&FftAdpcmSpec, bases);
     if (FftAdpcmType == NULL) return NULL;
 
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* FftDeltaType = PyType_FromSpecWithBases(&FftDeltaSpec, bases);
+    if (FftDeltaType == NULL) return NULL;
+
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* WaterfallEngineType = PyType_FromSpecWithBases(&WaterfallEngineSpec, bases);
+    if (WaterfallEngineType == NULL) return NULL;
+
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* ZoomFftType = PyType_FromSpecWithBases(&ZoomFftSpec, bases);
+    if (ZoomFftType == NULL) return NULL;
+
     Py_INCREF(ModuleType);
     bases = PyTuple_Pack(1, ModuleType);
     if (bases == NULL) return NULL;
@@ -152,6 +202,24 @@ PyInit_modules(void) {
     PyObject* SquelchType = PyType_FromSpecWithBases(&SquelchSpec, bases);
     if (SquelchType == NULL) return NULL;
 
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* SquelchGateType = PyType_FromSpecWithBases(&SquelchGateSpec, bases);
+    if (SquelchGateType == NULL) return NULL;
+
+    BandPowerTapType = (PyTypeObject*) PyType_FromSpec(&BandPowerTapSpec);
+    if (BandPowerTapType == NULL) return NULL;
+
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* OccupancyIndexType = PyType_FromSpecWithBases(&OccupancyIndexSpec, bases);
+    if (OccupancyIndexType == NULL) return NULL;
+
+    OccupancySnapshotType = (PyTypeObject*) PyType_FromSpec(&OccupancySnapshotSpec);
+    if (OccupancySnapshotType == NULL) return NULL;
+
     Py_INCREF(ModuleType);
     bases = PyTuple_Pack(1, ModuleType);
     if (bases == NULL) return NULL;
@@ -254,6 +322,24 @@ PyInit_modules(void) {
     PyObject* VaricodeDecoderType = PyType_FromSpecWithBases(&VaricodeDecoderSpec, bases);
     if (VaricodeDecoderType == NULL) return NULL;
 
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* PllType = PyType_FromSpecWithBases(&PllSpec, bases);
+    if (PllType == NULL) return NULL;
+
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* CostasLoopType = PyType_FromSpecWithBases(&CostasLoopSpec, bases);
+    if (CostasLoopType == NULL) return NULL;
+
+    Py_INCREF(ModuleType);
+    bases = PyTuple_Pack(1, ModuleType);
+    if (bases == NULL) return NULL;
+    PyObject* GoertzelBankType = PyType_FromSpecWithBases(&GoertzelBankSpec, bases);
+    if (GoertzelBankType == NULL) return NULL;
+
     PyObject *m = PyModule_Create(&pycsdrmodule);
     if (m == NULL) {
         return NULL;
@@ -277,6 +363,8 @@ PyInit_modules(void) {
 
     PyModule_AddObject(m, "Fft", FftType);
 
+    PyModule_AddObject(m, "PolyphaseFft", PolyphaseFftType);
+
     PyModule_AddObject(m, "LogPower", LogPowerType);
 
     PyModule_AddObject(m, "LogAveragePower", LogAveragePowerType);
@@ -285,6 +373,12 @@ PyInit_modules(void) {
 
     PyModule_AddObject(m, "FftAdpcm", FftAdpcmType);
 
+    PyModule_AddObject(m, "FftDelta", FftDeltaType);
+
+    PyModule_AddObject(m, "WaterfallEngine", WaterfallEngineType);
+
+    PyModule_AddObject(m, "ZoomFft", ZoomFftType);
+
     PyModule_AddObject(m, "FirDecimate", FirDecimateType);
 
     PyModule_AddObject(m, "Bandpass", BandpassType);
@@ -293,6 +387,14 @@ PyInit_modules(void) {
 
     PyModule_AddObject(m, "Squelch", SquelchType);
 
+    PyModule_AddObject(m, "SquelchGate", SquelchGateType);
+
+    PyModule_AddObject(m, "BandPowerTap", (PyObject*) BandPowerTapType);
+
+    PyModule_AddObject(m, "OccupancyIndex", OccupancyIndexType);
+
+    PyModule_AddObject(m, "OccupancySnapshot", (PyObject*) OccupancySnapshotType);
+
     PyModule_AddObject(m, "FractionalDecimator", FractionalDecimatorType);
 
     PyModule_AddObject(m, "FmDemod", FmDemodType);
@@ -327,6 +429,12 @@ PyInit_modules(void) {
 
     PyModule_AddObject(m, "VaricodeDecoder", VaricodeDecoderType);
 
+    PyModule_AddObject(m, "Pll", PllType);
+
+    PyModule_AddObject(m, "CostasLoop", CostasLoopType);
+
+    PyModule_AddObject(m, "GoertzelBank", GoertzelBankType);
+
     PyObject* csdrVersion = PyUnicode_FromStringAndSize(Csdr::version.c_str(), Csdr::version.length());
     if (csdrVersion == NULL) return NULL;
     PyModule_AddObject(m, "csdr_version", csdrVersion);
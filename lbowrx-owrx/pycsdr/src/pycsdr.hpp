@@ -15,4 +15,8 @@ extern PyTypeObject* ModuleType;
 
 extern PyTypeObject* BufferType;
 
-extern PyTypeObject* BufferReaderType;
\ No newline at end of file
+extern PyTypeObject* BufferReaderType;
+
+extern PyTypeObject* BandPowerTapType;
+
+extern PyTypeObject* OccupancySnapshotType;
\ No newline at end of file
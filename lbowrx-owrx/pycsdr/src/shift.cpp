@@ -2,18 +2,29 @@
 #include "types.hpp"
 
 #include <csdr/shift.hpp>
+#include <csdr/half.hpp>
 
 static int Shift_init(Shift* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = {(char*) "rate", NULL};
+    static char* kwlist[] = {(char*) "rate", (char*) "format", NULL};
 
     float rate = 0.0f;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|f", kwlist, &rate)) {
+    PyObject* format = FORMAT_COMPLEX_FLOAT;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|fO!", kwlist, &rate, FORMAT_TYPE, &format)) {
         return -1;
     }
 
-    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    if (format == FORMAT_COMPLEX_FLOAT) {
+        self->setModule(new Csdr::ShiftAddfast<Csdr::complex<float>>(rate));
+    } else if (format == FORMAT_COMPLEX_SHORT) {
+        self->setModule(new Csdr::ShiftAddfast<Csdr::complex<short>>(rate));
+    } else if (format == FORMAT_COMPLEX_HALF) {
+        self->setModule(new Csdr::ShiftAddfast<Csdr::complex<Csdr::half>>(rate));
+    } else {
+        PyErr_SetString(PyExc_ValueError, "unsupported shift format");
+        return -1;
+    }
+    self->inputFormat = format;
     self->outputFormat = FORMAT_COMPLEX_FLOAT;
-    self->setModule(new Csdr::ShiftAddfast(rate));
 
     return 0;
 }
@@ -26,7 +37,7 @@ static PyObject* Shift_setRate(Shift* self, PyObject* args, PyObject* kwds){
         return NULL;
     }
 
-    dynamic_cast<Csdr::ShiftAddfast*>(self->module)->setRate(rate);
+    dynamic_cast<Csdr::Shift*>(self->module)->setRate(rate);
 
     Py_RETURN_NONE;
 }
@@ -3,6 +3,7 @@
 #include "types.hpp"
 
 #include <csdr/complex.hpp>
+#include <csdr/half.hpp>
 
 int Sink_finalize(Sink* self) {
     if (self->reader != nullptr) {
@@ -51,8 +52,12 @@ PyObject* Sink_setReader(Sink* self, PyObject* args, PyObject* kwds) {
         setReader<short>(self);
     } else if (self->inputFormat == FORMAT_FLOAT) {
         setReader<float>(self);
+    } else if (self->inputFormat == FORMAT_COMPLEX_CHAR) {
+        setReader<Csdr::complex<unsigned char>>(self);
     } else if (self->inputFormat == FORMAT_COMPLEX_SHORT) {
         setReader<Csdr::complex<short>>(self);
+    } else if (self->inputFormat == FORMAT_COMPLEX_HALF) {
+        setReader<Csdr::complex<Csdr::half>>(self);
     } else if (self->inputFormat == FORMAT_COMPLEX_FLOAT) {
         setReader<Csdr::complex<float>>(self);
     } else {
@@ -3,6 +3,7 @@
 #include "types.hpp"
 
 #include <csdr/complex.hpp>
+#include <csdr/half.hpp>
 
 int Source_finalize(Source* self) {
     if (self->writer != nullptr) {
@@ -52,8 +53,12 @@ PyObject* Source_setWriter(Source* self, PyObject* args, PyObject* kwds) {
         setWriter<short>(self);
     } else if (self->outputFormat == FORMAT_FLOAT) {
         setWriter<float>(self);
+    } else if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+        setWriter<Csdr::complex<unsigned char>>(self);
     } else if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
         setWriter<Csdr::complex<short>>(self);
+    } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+        setWriter<Csdr::complex<Csdr::half>>(self);
     } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
         setWriter<Csdr::complex<float>>(self);
     } else {
@@ -5,27 +5,31 @@
 #include <csdr/power.hpp>
 
 static int Squelch_init(Squelch* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = {(char*) "decimation", (char*) "reportInterval", NULL};
+    static char* kwlist[] = {(char*) "decimation", (char*) "reportInterval", (char*) "hysteresis", (char*) "holdTime", NULL};
 
     unsigned int decimation = 0;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "II", kwlist, &decimation, &self->reportInterval)) {
+    unsigned int reportInterval = 1;
+    float hysteresis = 1.0f;
+    unsigned int holdTime = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "II|fI", kwlist, &decimation, &reportInterval, &hysteresis, &holdTime)) {
         return -1;
     }
 
     self->inputFormat = FORMAT_COMPLEX_FLOAT;
     self->outputFormat = FORMAT_COMPLEX_FLOAT;
-    self->reportCounter = self->reportInterval;
-    self->setModule(new Csdr::Squelch(decimation, [self] (float level) {
-        if (self->reportCounter-- > 0) return;
-        self->reportCounter = self->reportInterval;
-
+    // readings are averaged and rate limited by the module, so this only runs once per report interval
+    auto squelch = new Csdr::Squelch(decimation, [self] (float level) {
         if (self->powerWriter == nullptr) return;
 
         auto writer = dynamic_cast<Csdr::Writer<float>*>(self->powerWriter->writer);
         if (!writer->writeable()) return;
         *(writer->getWritePointer()) = level;
         writer->advance(1);
-    }));
+    });
+    squelch->setReportInterval(reportInterval);
+    squelch->setHysteresis(hysteresis);
+    squelch->setHoldTime(holdTime);
+    self->setModule(squelch);
 
     return 0;
 }
@@ -72,11 +76,38 @@ static PyObject* Squelch_setPowerWriter(Squelch* self, PyObject* args, PyObject*
 static PyObject* Squelch_setReportInterval(Squelch* self, PyObject* args, PyObject* kwds) {
     static char* kwlist[] = {(char*) "reportInterval", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &self->reportInterval)) {
+    unsigned int reportInterval = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &reportInterval)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::Squelch*>(self->module)->setReportInterval(reportInterval);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* Squelch_setHysteresis(Squelch* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "hysteresis", NULL};
+
+    float hysteresis = 1.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f", kwlist, &hysteresis)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::Squelch*>(self->module)->setHysteresis(hysteresis);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* Squelch_setHoldTime(Squelch* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "holdTime", NULL};
+
+    unsigned int holdTime = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &holdTime)) {
         return NULL;
     }
-    // reset since this may contain excessively high values
-    self->reportCounter = self->reportInterval;
+
+    dynamic_cast<Csdr::Squelch*>(self->module)->setHoldTime(holdTime);
 
     Py_RETURN_NONE;
 }
@@ -89,7 +120,13 @@ static PyMethodDef Squelch_methods[] = {
      "set a writer that will receive power level readouts"
     },
     {"setReportInterval", (PyCFunction) Squelch_setReportInterval, METH_VARARGS | METH_KEYWORDS,
-     "set the report interval"
+     "set the report interval (in blocks of 1024 samples)"
+    },
+    {"setHysteresis", (PyCFunction) Squelch_setHysteresis, METH_VARARGS | METH_KEYWORDS,
+     "set the ratio between the opening and the closing level"
+    },
+    {"setHoldTime", (PyCFunction) Squelch_setHoldTime, METH_VARARGS | METH_KEYWORDS,
+     "set the number of blocks the squelch stays open after the level has dropped"
     },
     {NULL}  /* Sentinel */
 };
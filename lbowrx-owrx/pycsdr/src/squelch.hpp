@@ -7,8 +7,6 @@
 
 struct Squelch: Module {
     Writer* powerWriter;
-    unsigned int reportInterval;
-    int reportCounter;
 };
 
 extern PyType_Spec SquelchSpec;
\ No newline at end of file
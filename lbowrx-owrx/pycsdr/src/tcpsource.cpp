@@ -1,6 +1,8 @@
 #include "tcpsource.hpp"
 #include "types.hpp"
 
+#include <csdr/half.hpp>
+
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -20,8 +22,12 @@ static int TcpSource_init(TcpSource* self, PyObject* args, PyObject* kwds) {
             self->source = new Csdr::TcpSource<short>(inet_addr("127.0.0.1"), port);
         } else if (self->outputFormat == FORMAT_FLOAT) {
             self->source = new Csdr::TcpSource<float>(inet_addr("127.0.0.1"), port);
+        } else if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+            self->source = new Csdr::TcpSource<Csdr::complex<unsigned char>>(inet_addr("127.0.0.1"), port);
         } else if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
             self->source = new Csdr::TcpSource<Csdr::complex<short>>(inet_addr("127.0.0.1"), port);
+        } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+            self->source = new Csdr::TcpSource<Csdr::complex<Csdr::half>>(inet_addr("127.0.0.1"), port);
         } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
             self->source = new Csdr::TcpSource<Csdr::complex<float>>(inet_addr("127.0.0.1"), port);
         } else {
@@ -43,8 +49,12 @@ static PyObject* TcpSource_stop(TcpSource* self) {
         dynamic_cast<Csdr::TcpSource<short>*>(self->source)->stop();
     } else if (self->outputFormat == FORMAT_FLOAT) {
         dynamic_cast<Csdr::TcpSource<float>*>(self->source)->stop();
+    } else if (self->outputFormat == FORMAT_COMPLEX_CHAR) {
+        dynamic_cast<Csdr::TcpSource<Csdr::complex<unsigned char>>*>(self->source)->stop();
     } else if (self->outputFormat == FORMAT_COMPLEX_SHORT) {
         dynamic_cast<Csdr::TcpSource<Csdr::complex<short>>*>(self->source)->stop();
+    } else if (self->outputFormat == FORMAT_COMPLEX_HALF) {
+        dynamic_cast<Csdr::TcpSource<Csdr::complex<Csdr::half>>*>(self->source)->stop();
     } else if (self->outputFormat == FORMAT_COMPLEX_FLOAT) {
         dynamic_cast<Csdr::TcpSource<Csdr::complex<float>>*>(self->source)->stop();
     } else {
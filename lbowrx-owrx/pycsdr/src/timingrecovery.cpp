@@ -6,11 +6,11 @@
 static int TimingRecovery_init(TimingRecovery* self, PyObject* args, PyObject* kwds) {
     static char* kwlist[] = {(char*) "decimation", (char*) "loopGain", (char*) "maxError", (char*) "useQ", NULL};
 
-    unsigned int decimation = 0;
+    float decimation = 0.0f;
     float loopGain = 0.0f;
     float maxError = 0.0f;
     int useQ = 0;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Iffp", kwlist, &decimation, &loopGain, &maxError, &useQ)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "fffp", kwlist, &decimation, &loopGain, &maxError, &useQ)) {
         return -1;
     }
 
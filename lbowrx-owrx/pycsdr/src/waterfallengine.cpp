@@ -0,0 +1,221 @@
+#include "waterfallengine.hpp"
+#include "types.hpp"
+#include "pycsdr.hpp"
+#include "bandpowertap.hpp"
+#include "occupancyindex.hpp"
+
+#include <csdr/waterfallengine.hpp>
+#include <csdr/window.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+static int WaterfallEngine_init(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "size", (char*) "every_n_samples", (char*) "avg_number", (char*) "add_db", (char*) "compression", (char*) "levels", (char*) "pyramid_mode", (char*) "threads", (char*) "taps", NULL};
+
+    uint32_t fftSize = 0;
+    uint32_t everyNSamples = 0;
+    uint16_t avgNumber = 0;
+    float add_db = 0.0f;
+    const char* compression = "adpcm";
+    unsigned int levels = 1;
+    const char* pyramidMode = "max";
+    unsigned int threads = 1;
+    unsigned int taps = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "II|HfsIsII", kwlist, &fftSize, &everyNSamples, &avgNumber, &add_db, &compression, &levels, &pyramidMode, &threads, &taps)) {
+        return -1;
+    }
+
+    Csdr::PyramidMode mode;
+    if (strcmp(pyramidMode, "max") == 0) {
+        mode = Csdr::PYRAMID_MAX;
+    } else if (strcmp(pyramidMode, "mean") == 0) {
+        mode = Csdr::PYRAMID_MEAN;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "unsupported pyramid mode");
+        return -1;
+    }
+
+    // the polyphase prototype filter needs the stopband of the blackman window to make use of the additional taps,
+    // the plain FFT uses the same hamming window as Fft
+    Csdr::Window* window;
+    if (taps > 1) {
+        window = new Csdr::BlackmanWindow();
+    } else {
+        window = new Csdr::HammingWindow();
+    }
+    try {
+        if (strcmp(compression, "adpcm") == 0) {
+            self->setModule(new Csdr::WaterfallEngine<unsigned char>(fftSize, everyNSamples, avgNumber, add_db, window, levels, mode, taps));
+            self->outputFormat = FORMAT_CHAR;
+        } else if (strcmp(compression, "none") == 0) {
+            self->setModule(new Csdr::WaterfallEngine<float>(fftSize, everyNSamples, avgNumber, add_db, window, levels, mode, taps));
+            self->outputFormat = FORMAT_FLOAT;
+        } else {
+            delete window;
+            PyErr_SetString(PyExc_ValueError, "unsupported waterfall compression");
+            return -1;
+        }
+    } catch (const std::runtime_error& e) {
+        delete window;
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return -1;
+    }
+    delete window;
+
+    if (threads > 1) {
+        dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setThreads(threads);
+    }
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+
+    return 0;
+}
+
+static PyObject* WaterfallEngine_setEveryNSamples(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "every_n_samples", NULL};
+
+    unsigned int everyNSamples = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &everyNSamples)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setEveryNSamples(everyNSamples);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* WaterfallEngine_setAvgNumber(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "avg_number", NULL};
+
+    uint16_t avgNumber = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "H", kwlist, &avgNumber)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setAvgNumber(avgNumber);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* WaterfallEngine_setThreads(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "threads", NULL};
+
+    unsigned int threads = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &threads)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setThreads(threads);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* WaterfallEngine_setPowerTap(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "tap", NULL};
+
+    PyObject* tap;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &tap)) {
+        return NULL;
+    }
+
+    if (tap != Py_None && !PyObject_TypeCheck(tap, BandPowerTapType)) {
+        PyErr_SetString(PyExc_TypeError, "tap must be a BandPowerTap");
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setPowerTap(tap == Py_None ? nullptr : ((BandPowerTap*) tap)->tap);
+
+    // the tap must outlive the module, so a reference is held
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    if (tap != Py_None) {
+        self->powerTap = tap;
+        Py_INCREF(self->powerTap);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* WaterfallEngine_setOccupancyIndex(WaterfallEngine* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "index", NULL};
+
+    PyObject* index;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &index)) {
+        return NULL;
+    }
+
+    Csdr::OccupancyIndex* occupancyIndex = nullptr;
+    if (index != Py_None) {
+        if (PyObject_TypeCheck(index, ModuleType)) {
+            occupancyIndex = dynamic_cast<Csdr::OccupancyIndex*>(((Module*) index)->module);
+        }
+        if (occupancyIndex == nullptr) {
+            PyErr_SetString(PyExc_TypeError, "index must be an OccupancyIndex");
+            return NULL;
+        }
+    }
+
+    try {
+        dynamic_cast<Csdr::UntypedWaterfallEngine*>(self->module)->setOccupancyIndex(occupancyIndex);
+    } catch (const std::runtime_error& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return NULL;
+    }
+
+    // the index must outlive the engine, so a reference is held
+    Py_XDECREF(self->occupancyIndex);
+    self->occupancyIndex = nullptr;
+    if (index != Py_None) {
+        self->occupancyIndex = index;
+        Py_INCREF(self->occupancyIndex);
+    }
+
+    Py_RETURN_NONE;
+}
+
+// the tap and the index may only be released once the module no longer uses it
+static int WaterfallEngine_finalize(WaterfallEngine* self) {
+    if (Module_finalize(self) != 0) {
+        return -1;
+    }
+    Py_XDECREF(self->powerTap);
+    self->powerTap = nullptr;
+    Py_XDECREF(self->occupancyIndex);
+    self->occupancyIndex = nullptr;
+    return 0;
+}
+
+static PyMethodDef WaterfallEngine_methods[] = {
+    {"setEveryNSamples", (PyCFunction) WaterfallEngine_setEveryNSamples, METH_VARARGS | METH_KEYWORDS,
+     "set repetition interval in samples"
+    },
+    {"setAvgNumber", (PyCFunction) WaterfallEngine_setAvgNumber, METH_VARARGS | METH_KEYWORDS,
+     "set fft averaging factor (0 disables averaging)"
+    },
+    {"setThreads", (PyCFunction) WaterfallEngine_setThreads, METH_VARARGS | METH_KEYWORDS,
+     "set number of threads per FFT"
+    },
+    {"setPowerTap", (PyCFunction) WaterfallEngine_setPowerTap, METH_VARARGS | METH_KEYWORDS,
+     "hand every frame to a BandPowerTap for channel power measurement"
+    },
+    {"setOccupancyIndex", (PyCFunction) WaterfallEngine_setOccupancyIndex, METH_VARARGS | METH_KEYWORDS,
+     "hand every line to an OccupancyIndex"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot WaterfallEngineSlots[] = {
+    {Py_tp_init, (void*) WaterfallEngine_init},
+    {Py_tp_finalize, (void*) WaterfallEngine_finalize},
+    {Py_tp_methods, WaterfallEngine_methods},
+    {0, 0}
+};
+
+PyType_Spec WaterfallEngineSpec = {
+    "pycsdr.modules.WaterfallEngine",
+    sizeof(WaterfallEngine),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    WaterfallEngineSlots
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "module.hpp"
+
+struct WaterfallEngine: Module {
+    PyObject* powerTap;
+    PyObject* occupancyIndex;
+};
+
+extern PyType_Spec WaterfallEngineSpec;
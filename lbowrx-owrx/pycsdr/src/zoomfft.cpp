@@ -0,0 +1,81 @@
+#include "zoomfft.hpp"
+#include "types.hpp"
+
+#include <csdr/zoomfft.hpp>
+#include <csdr/window.hpp>
+
+static int ZoomFft_init(ZoomFft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "center", (char*) "decimation", (char*) "size", (char*) "every_n_samples", NULL};
+
+    float center = 0.0f;
+    unsigned int decimation = 0;
+    uint32_t fftSize = 0;
+    uint32_t everyNSamples = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "fIII", kwlist, &center, &decimation, &fftSize, &everyNSamples)) {
+        return -1;
+    }
+
+    if (decimation == 0) {
+        PyErr_SetString(PyExc_ValueError, "decimation must be at least 1");
+        return -1;
+    }
+
+    auto window = new Csdr::HammingWindow();
+    self->setModule(new Csdr::ZoomFft(center, decimation, fftSize, everyNSamples, window));
+    delete window;
+
+    self->inputFormat = FORMAT_COMPLEX_FLOAT;
+    self->outputFormat = FORMAT_COMPLEX_FLOAT;
+
+    return 0;
+}
+
+static PyObject* ZoomFft_setCenter(ZoomFft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "center", NULL};
+
+    float center = 0.0f;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "f", kwlist, &center)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::ZoomFft*>(self->module)->setCenter(center);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* ZoomFft_setEveryNSamples(ZoomFft* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {(char*) "every_n_samples", NULL};
+
+    unsigned int everyNSamples = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I", kwlist, &everyNSamples)) {
+        return NULL;
+    }
+
+    dynamic_cast<Csdr::ZoomFft*>(self->module)->setEveryNSamples(everyNSamples);
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef ZoomFft_methods[] = {
+    {"setCenter", (PyCFunction) ZoomFft_setCenter, METH_VARARGS | METH_KEYWORDS,
+     "set center of the sub-band (relative to the sample rate)"
+    },
+    {"setEveryNSamples", (PyCFunction) ZoomFft_setEveryNSamples, METH_VARARGS | METH_KEYWORDS,
+     "set repetition interval in decimated samples"
+    },
+    {NULL}  /* Sentinel */
+};
+
+static PyType_Slot ZoomFftSlots[] = {
+    {Py_tp_init, (void*) ZoomFft_init},
+    {Py_tp_methods, ZoomFft_methods},
+    {0, 0}
+};
+
+PyType_Spec ZoomFftSpec = {
+    "pycsdr.modules.ZoomFft",
+    sizeof(ZoomFft),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_FINALIZE,
+    ZoomFftSlots
+};